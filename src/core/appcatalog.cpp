@@ -0,0 +1,446 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "appcatalog.h"
+
+#include "containerfs.h"
+#include "distroboxcli.h"
+#include "icontheme.h"
+
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QUrl>
+
+#include <algorithm>
+#include <memory>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Preferred icon size in the launcher list, the theme lookup picks the closest one
+constexpr int IconSize = 48;
+
+// Copies the resolved icon file out of the container, iconPath is empty when the icon was not found
+QString cacheIconFromContainer(const QString &container, const QString &basename, const QString &iconValue, const QString &iconPath)
+{
+    // Also used off the GUI thread by the D-Bus service
+    static QMutex iconCacheMutex;
+    static QHash<QString, QString> iconCache;
+
+    const QString cacheKey = container + QLatin1Char('|') + iconValue;
+    {
+        QMutexLocker locker(&iconCacheMutex);
+        if (iconCache.contains(cacheKey)) {
+            return iconCache.value(cacheKey);
+        }
+    }
+    const auto remember = [&cacheKey](const QString &url) {
+        QMutexLocker locker(&iconCacheMutex);
+        iconCache.insert(cacheKey, url);
+    };
+
+    if (iconPath.isEmpty()) {
+        remember(QString());
+        return {};
+    }
+
+    const QString cacheDirectory = AppCatalog::iconCacheDirectory(container);
+    if (cacheDirectory.isEmpty()) {
+        remember(QString());
+        return {};
+    }
+
+    const QFileInfo iconInfo(iconPath);
+    QString localName = basename;
+    if (localName.isEmpty()) {
+        localName = iconInfo.completeBaseName();
+    }
+
+    QString suffix = iconInfo.suffix();
+    if (suffix.isEmpty()) {
+        suffix = QStringLiteral("png");
+    }
+
+    const QString localPath = QDir(cacheDirectory).filePath(localName + QLatin1Char('.') + suffix);
+
+    if (!QFile::exists(localPath)) {
+        bool written = false;
+        const bool read = ContainerFs::mapFile(container, iconPath, [&localPath, &written](QByteArrayView contents) {
+            if (contents.isEmpty()) {
+                return;
+            }
+            QFile localFile(localPath);
+            written = localFile.open(QIODevice::WriteOnly) && localFile.write(contents.data(), contents.size()) == contents.size();
+        });
+        if (!read || !written) {
+            QFile::remove(localPath);
+            remember(QString());
+            return {};
+        }
+    }
+
+    const QString url = QUrl::fromLocalFile(localPath).toString();
+    remember(url);
+    return url;
+}
+
+// Bump when CatalogEntry or the parsing changes
+constexpr quint32 CatalogVersion = 1;
+
+struct CatalogEntry {
+    ContainerFs::FileStamp stamp;
+    bool hidden = false; ///< NoDisplay entries are remembered too, so they are not re-read
+    AppCatalog::AvailableApp app;
+};
+
+// Desktop entries of a container by path
+using Catalog = QHash<QString, CatalogEntry>;
+
+// Guards the two maps only, never held across I/O
+QMutex catalogMutex;
+QHash<QString, Catalog> catalogs;
+// Serializes the refreshes of one container, concurrent ones would only repeat the same reads
+QHash<QString, std::shared_ptr<QMutex>> refreshMutexes;
+
+std::shared_ptr<QMutex> refreshMutex(const QString &container)
+{
+    QMutexLocker locker(&catalogMutex);
+    std::shared_ptr<QMutex> &mutex = refreshMutexes[container];
+    if (!mutex) {
+        mutex = std::make_shared<QMutex>();
+    }
+    return mutex;
+}
+
+CatalogEntry parseDesktopEntry(const QString &basename, const QString &desktopContent)
+{
+    CatalogEntry entry;
+    entry.app.basename = basename;
+
+    QString name = basename;
+    // Prefer English name, fall back to generic name
+    QString englishName;
+
+    for (const QString &desktopLine : desktopContent.split(QChar::fromLatin1('\n'), Qt::SkipEmptyParts)) {
+        if (desktopLine.startsWith(QStringLiteral("Name[en]="))) {
+            englishName = desktopLine.mid(9); // Remove "Name[en]="
+        } else if (desktopLine.startsWith(QStringLiteral("Name=")) && name == basename) {
+            name = desktopLine.mid(5); // Remove "Name=" (only use as fallback)
+        } else if (desktopLine.startsWith(QStringLiteral("Icon="))) {
+            entry.app.icon = desktopLine.mid(5); // Remove "Icon="
+        } else if (desktopLine.startsWith(QStringLiteral("NoDisplay=true"))) {
+            entry.hidden = true;
+        }
+    }
+
+    entry.app.name = englishName.isEmpty() ? name : englishName;
+    return entry;
+}
+
+QString catalogFilePath(const QString &container)
+{
+    const QString cacheBase = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheBase.isEmpty()) {
+        return {};
+    }
+
+    const QString directory = QDir(cacheBase).filePath(u"kontainer/apps"_s);
+    QDir().mkpath(directory);
+    return QDir(directory).filePath(container + u".cache"_s);
+}
+
+// Callers hold the refresh mutex of the container
+Catalog catalog(const QString &container)
+{
+    {
+        QMutexLocker locker(&catalogMutex);
+        const auto it = catalogs.constFind(container);
+        if (it != catalogs.cend()) {
+            return *it;
+        }
+    }
+
+    Catalog loaded;
+    QFile file(catalogFilePath(container));
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream stream(&file);
+        quint32 version = 0;
+        qint64 count = 0;
+        stream >> version >> count;
+        for (qint64 i = 0; version == CatalogVersion && i < count && stream.status() == QDataStream::Ok; ++i) {
+            QString path;
+            CatalogEntry entry;
+            stream >> path >> entry.stamp.mtime >> entry.stamp.size >> entry.hidden >> entry.app.basename >> entry.app.name >> entry.app.icon
+                >> entry.app.iconSource;
+            loaded.insert(path, entry);
+        }
+        if (version != CatalogVersion || stream.status() != QDataStream::Ok) {
+            loaded.clear();
+        }
+    }
+
+    QMutexLocker locker(&catalogMutex);
+    catalogs.insert(container, loaded);
+    return loaded;
+}
+
+// Callers hold the refresh mutex of the container
+void storeCatalog(const QString &container, const Catalog &entries)
+{
+    {
+        QMutexLocker locker(&catalogMutex);
+        catalogs.insert(container, entries);
+    }
+
+    QSaveFile file(catalogFilePath(container));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << CatalogVersion << qint64(entries.size());
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        stream << it.key() << it->stamp.mtime << it->stamp.size << it->hidden << it->app.basename << it->app.name << it->app.icon << it->app.iconSource;
+    }
+    file.commit();
+}
+}
+
+namespace AppCatalog
+{
+QList<AvailableApp> availableApps(const QString &container)
+{
+    const QString applicationsDirectory = u"/usr/share/applications/"_s;
+
+    const std::shared_ptr<QMutex> mutex = refreshMutex(container);
+    QMutexLocker locker(mutex.get());
+    const Catalog previous = catalog(container);
+
+    // The previous catalog stands while the container cannot be read, e.g. while it is being set up
+    const auto previousApps = [&previous]() {
+        QStringList paths = previous.keys();
+        std::sort(paths.begin(), paths.end());
+        QList<AvailableApp> list;
+        for (const QString &path : std::as_const(paths)) {
+            if (!previous[path].hidden) {
+                list << previous[path].app;
+            }
+        }
+        return list;
+    };
+
+    // Stamps of every entry at once, then the changed ones are read in one batch
+    bool listed = false;
+    const QHash<QString, ContainerFs::FileStamp> stamps = ContainerFs::stamps(container, applicationsDirectory, listed);
+    if (!listed) {
+        qWarning() << "Could not list the applications of" << container << ", keeping the previous ones";
+        return previousApps();
+    }
+    QStringList paths;
+    QStringList changed;
+    for (auto it = stamps.cbegin(); it != stamps.cend(); ++it) {
+        if (!it.key().endsWith(QStringLiteral(".desktop")) || !it->exists()) {
+            continue;
+        }
+        paths.append(it.key());
+        if (previous.value(it.key()).stamp != *it) {
+            changed.append(it.key());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    bool read = false;
+    const QHash<QString, QByteArray> contents = ContainerFs::readFiles(container, changed, read);
+    if (!read) {
+        qWarning() << "Could not read the applications of" << container << ", keeping the previous ones";
+        return previousApps();
+    }
+
+    Catalog fresh;
+    QStringList needIcons; ///< Paths of the entries whose icon is copied again
+
+    for (const QString &path : std::as_const(paths)) {
+        CatalogEntry entry = previous.value(path);
+        if (entry.stamp != stamps.value(path)) {
+            const auto content = contents.constFind(path);
+            if (content == contents.cend()) {
+                continue;
+            }
+
+            // Extract basename from the full path
+            QString basename = path.mid(applicationsDirectory.size());
+            basename.chop(8);
+
+            entry = parseDesktopEntry(basename, QString::fromUtf8(*content));
+            entry.stamp = stamps.value(path);
+            if (!entry.hidden) {
+                needIcons.append(path);
+            }
+            qDebug() << "App:" << entry.app.name << "| Basename:" << basename << "| Source:" << path;
+        } else if (!entry.app.iconSource.isEmpty() && !QFile::exists(QUrl(entry.app.iconSource).toLocalFile())) {
+            // The icon cache was cleared behind our back
+            needIcons.append(path);
+        }
+
+        fresh.insert(path, entry);
+    }
+
+    // Every icon in one pass over the container's theme index
+    QStringList iconNames;
+    for (const QString &path : std::as_const(needIcons)) {
+        iconNames.append(fresh.value(path).app.icon);
+    }
+    const QHash<QString, QString> iconPaths = IconTheme::resolveAll(container, iconNames, IconSize);
+    for (const QString &path : std::as_const(needIcons)) {
+        AvailableApp &app = fresh[path].app;
+        app.iconSource = cacheIconFromContainer(container, app.basename, app.icon, iconPaths.value(app.icon));
+    }
+
+    if (!changed.isEmpty() || !needIcons.isEmpty() || fresh.size() != previous.size()) {
+        storeCatalog(container, fresh);
+    }
+
+    QList<AvailableApp> list;
+    for (const QString &path : std::as_const(paths)) {
+        const auto entry = fresh.constFind(path);
+        if (entry != fresh.cend() && !entry->hidden) {
+            list << entry->app;
+        }
+    }
+
+    qDebug() << "Apps of" << container << ":" << list.size();
+    return list;
+}
+
+void forget(const QString &container)
+{
+    {
+        QMutexLocker locker(&catalogMutex);
+        catalogs.remove(container);
+    }
+    QFile::remove(catalogFilePath(container));
+}
+
+QList<ExportedApp> exportedApps(const QString &container)
+{
+    QList<ExportedApp> list;
+    bool isFlatpakRuntime = DistroboxCli::isFlatpak();
+    QStringList searchPaths;
+
+    if (isFlatpakRuntime) {
+        // Flatpak build only has read access to the host exports directory
+        searchPaths = {QDir::homePath() + QStringLiteral("/.local/share/applications")};
+    } else {
+        searchPaths = {QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation)};
+    }
+
+    QStringList patterns;
+    patterns << QStringLiteral("%1-*.desktop").arg(container);
+
+    for (const QString &searchPath : searchPaths) {
+        QDir dir(searchPath);
+        if (!dir.exists()) {
+            continue;
+        }
+
+        for (const QFileInfo &file : dir.entryInfoList(patterns, QDir::Files)) {
+            QString fileName = file.fileName();
+            if (!fileName.endsWith(QStringLiteral(".desktop"))) {
+                continue;
+            }
+
+            // Skip clone files explicitly
+            if (fileName.endsWith(QStringLiteral("clone.desktop"), Qt::CaseInsensitive)
+                || fileName.contains(QStringLiteral("-clone.desktop"), Qt::CaseInsensitive)) {
+                continue;
+            }
+
+            // Extract basename from filename
+            QString prefix = container + QLatin1String("-");
+            QString basename = fileName;
+            if (basename.startsWith(prefix)) {
+                basename.remove(0, prefix.length());
+            }
+            if (basename.endsWith(QStringLiteral(".desktop"))) {
+                basename.chop(8);
+            }
+
+            // Skip if we already found this app
+            const bool alreadyExists = std::any_of(list.cbegin(), list.cend(), [&basename](const ExportedApp &existing) {
+                return existing.basename == basename;
+            });
+            if (alreadyExists) {
+                continue;
+            }
+
+            QSettings desktop(file.filePath(), QSettings::IniFormat);
+            ExportedApp app;
+            app.basename = basename;
+
+            QString fullName = desktop.value(QStringLiteral("Desktop Entry/Name"), basename).toString();
+            app.name = fullName.section(QStringLiteral(" (on "), 0, 0);
+            app.icon = desktop.value(QStringLiteral("Desktop Entry/Icon"), QString()).toString();
+
+            qDebug() << "Exported app:" << app.name << "| Basename:" << basename << "| File:" << fileName;
+            list << app;
+        }
+    }
+
+    return list;
+}
+
+QString iconCacheDirectory(const QString &container)
+{
+    const QString cacheBase = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheBase.isEmpty()) {
+        return {};
+    }
+
+    QDir cacheDir(cacheBase);
+    const QString iconsRoot = cacheDir.filePath(QStringLiteral("kontainer/icons/%1").arg(container));
+    QDir().mkpath(iconsRoot);
+    return iconsRoot;
+}
+
+QString availableAppsJson(const QList<AvailableApp> &apps)
+{
+    QJsonArray array;
+    for (const AvailableApp &entry : apps) {
+        QJsonObject app;
+        app[u"basename"_s] = entry.basename;
+        app[u"name"_s] = entry.name;
+        app[u"icon"_s] = entry.icon;
+        if (!entry.iconSource.isEmpty()) {
+            app[u"iconSource"_s] = entry.iconSource;
+        }
+        array.append(app);
+    }
+    return QString::fromUtf8(QJsonDocument(array).toJson(QJsonDocument::Compact));
+}
+
+QString exportedAppsJson(const QList<ExportedApp> &apps)
+{
+    QJsonArray array;
+    for (const ExportedApp &entry : apps) {
+        QJsonObject app;
+        app[u"basename"_s] = entry.basename;
+        app[u"name"_s] = entry.name;
+        app[u"icon"_s] = entry.icon;
+        array.append(app);
+    }
+    return QString::fromUtf8(QJsonDocument(array).toJson(QJsonDocument::Compact));
+}
+}
@@ -0,0 +1,59 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include <QList>
+#include <QString>
+
+/**
+ * Applications of a container: the ones installed inside it and the ones exported to the host.
+ *
+ * Plain functions without any QObject state, so they are usable from worker threads and from
+ * the headless command-line mode, which never constructs a DistroboxManager.
+ */
+namespace AppCatalog
+{
+/**
+ * @struct ExportedApp
+ * @brief Represents an application exported from a container to the host
+ *
+ * Contains information about the exported application, including
+ * its filesystem basename, display name, and icon name/path.
+ */
+struct ExportedApp {
+    QString basename; ///< The binary or executable basename
+    QString name; ///< Display name of the application
+    QString icon; ///< Icon name or path
+};
+
+/**
+ * @struct AvailableApp
+ * @brief Represents an application available inside a container
+ *
+ * Contains metadata about an application that exists inside a container,
+ * which can potentially be exported to the host system.
+ */
+struct AvailableApp {
+    QString basename; ///< The binary or executable basename
+    QString name; ///< Display name of the application
+    QString icon; ///< Icon name or path
+    QString iconSource; ///< URL of the icon copied out of the container, empty for theme icons
+};
+
+// Desktop entries shown in menus inside the container, their icons are copied to the cache.
+// Parsed entries are kept per container with the mtime and size of their file, on disk too,
+// so a refresh only re-reads the entries that were added or changed.
+QList<AvailableApp> availableApps(const QString &container);
+// Drops the kept entries of a removed container
+void forget(const QString &container);
+// Desktop entries distrobox-export wrote to the host for the container
+QList<ExportedApp> exportedApps(const QString &container);
+// Directory the icons of the container are copied to, created on demand
+QString iconCacheDirectory(const QString &container);
+
+QString availableAppsJson(const QList<AvailableApp> &apps);
+QString exportedAppsJson(const QList<ExportedApp> &apps);
+}
@@ -0,0 +1,111 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "appfiltermodel.h"
+
+#include "applistmodel.h"
+
+AppFilterModel::AppFilterModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    setDynamicSortFilter(true);
+    sort(0);
+
+    connect(this, &QAbstractItemModel::rowsInserted, this, &AppFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &AppFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::modelReset, this, &AppFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::layoutChanged, this, &AppFilterModel::countChanged);
+}
+
+AppListModel *AppFilterModel::appModel() const
+{
+    return m_appModel;
+}
+
+void AppFilterModel::setAppModel(AppListModel *model)
+{
+    if (m_appModel == model) {
+        return;
+    }
+
+    if (m_appModel) {
+        disconnect(m_appModel, nullptr, this, nullptr);
+    }
+
+    m_appModel = model;
+    m_scores.clear();
+    setSourceModel(model);
+
+    if (m_appModel) {
+        // Scores of the old entries must not be used while the proxy rebuilds itself
+        connect(m_appModel, &QAbstractItemModel::modelAboutToBeReset, this, [this]() {
+            m_scores.clear();
+        });
+        connect(m_appModel, &QAbstractItemModel::modelReset, this, &AppFilterModel::updateScores);
+    }
+
+    updateScores();
+    Q_EMIT appModelChanged();
+}
+
+QString AppFilterModel::filterText() const
+{
+    return m_filterText;
+}
+
+void AppFilterModel::setFilterText(const QString &text)
+{
+    if (m_filterText == text) {
+        return;
+    }
+
+    m_filterText = text;
+    m_needle = text.trimmed().toLower();
+    updateScores();
+    Q_EMIT filterTextChanged();
+}
+
+int AppFilterModel::count() const
+{
+    return rowCount();
+}
+
+void AppFilterModel::updateScores()
+{
+    const int rows = m_appModel ? m_appModel->rowCount() : 0;
+
+    m_scores.resize(rows);
+    for (int row = 0; row < rows; ++row) {
+        m_scores[row] = m_appModel->matchScore(row, m_needle);
+    }
+
+    invalidate();
+}
+
+bool AppFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent)
+
+    if (m_needle.isEmpty()) {
+        return true;
+    }
+    if (sourceRow < m_scores.size()) {
+        return m_scores[sourceRow] > 0;
+    }
+    return m_appModel && m_appModel->matchScore(sourceRow, m_needle) > 0;
+}
+
+bool AppFilterModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    if (!m_needle.isEmpty() && left.row() < m_scores.size() && right.row() < m_scores.size()) {
+        const int leftScore = m_scores[left.row()];
+        const int rightScore = m_scores[right.row()];
+        if (leftScore != rightScore) {
+            return leftScore > rightScore;
+        }
+    }
+
+    return QString::localeAwareCompare(left.data(AppListModel::NameRole).toString(), right.data(AppListModel::NameRole).toString()) < 0;
+}
@@ -0,0 +1,58 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include <QList>
+#include <QSortFilterProxyModel>
+#include <QString>
+#include <QtQml/qqmlregistration.h>
+
+class AppListModel;
+
+/**
+ * @class AppFilterModel
+ * @brief Fuzzy filter over an AppListModel, best matches first
+ *
+ * Every entry is scored once per filter change against the search keys precomputed by
+ * the source model. Without a filter the applications are sorted by name.
+ */
+class AppFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+    Q_MOC_INCLUDE("applistmodel.h")
+    Q_PROPERTY(AppListModel *appModel READ appModel WRITE setAppModel NOTIFY appModelChanged)
+    Q_PROPERTY(QString filterText READ filterText WRITE setFilterText NOTIFY filterTextChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    explicit AppFilterModel(QObject *parent = nullptr);
+
+    AppListModel *appModel() const;
+    void setAppModel(AppListModel *model);
+
+    QString filterText() const;
+    void setFilterText(const QString &text);
+
+    int count() const;
+
+Q_SIGNALS:
+    void appModelChanged();
+    void filterTextChanged();
+    void countChanged();
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    void updateScores();
+
+    AppListModel *m_appModel = nullptr;
+    QString m_filterText;
+    QString m_needle; ///< Trimmed, lowercased filterText
+    QList<int> m_scores; ///< Match score of each source row for m_needle
+};
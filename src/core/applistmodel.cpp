@@ -0,0 +1,165 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "applistmodel.h"
+
+#include "containericonprovider.h"
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+bool isWordStart(QStringView text, qsizetype position)
+{
+    return position == 0 || !text[position - 1].isLetterOrNumber();
+}
+
+// Every query character has to appear in order. Consecutive characters and characters
+// starting a word score higher, so "gte" ranks "GNOME Text Editor" above "Gimp Tools Editor".
+int subsequenceScore(QStringView text, QStringView needle)
+{
+    int score = 0;
+    qsizetype previous = -2;
+    qsizetype position = 0;
+
+    for (const QChar character : needle) {
+        while (position < text.size() && text[position] != character) {
+            ++position;
+        }
+        if (position >= text.size()) {
+            return 0;
+        }
+
+        score += 10;
+        if (position == previous + 1) {
+            score += 15;
+        }
+        if (isWordStart(text, position)) {
+            score += 10;
+        }
+        previous = position;
+        ++position;
+    }
+
+    return score;
+}
+
+int textScore(QStringView text, QStringView needle)
+{
+    const qsizetype index = text.indexOf(needle);
+    if (index == 0) {
+        // Shorter names are closer to the query
+        return 900 + 100 - qMin<qsizetype>(100, text.size() - needle.size());
+    }
+    if (index > 0) {
+        return (isWordStart(text, index) ? 700 : 500) - qMin<qsizetype>(100, index);
+    }
+    return qMin(400, subsequenceScore(text, needle));
+}
+}
+
+AppListModel::AppListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int AppListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(m_entries.size());
+}
+
+QVariant AppListModel::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid | CheckIndexOption::ParentIsInvalid)) {
+        return {};
+    }
+
+    const Entry &entry = m_entries[index.row()];
+    switch (role) {
+    case BasenameRole:
+        return entry.basename;
+    case Qt::DisplayRole:
+    case NameRole:
+        return entry.name;
+    case IconRole:
+        return entry.icon;
+    case IconSourceRole:
+        return entry.iconSource;
+    case ExportedRole:
+        return entry.exported;
+    }
+    return {};
+}
+
+QHash<int, QByteArray> AppListModel::roleNames() const
+{
+    return {
+        {BasenameRole, "basename"},
+        {NameRole, "name"},
+        {IconRole, "icon"},
+        {IconSourceRole, "iconSource"},
+        {ExportedRole, "exported"},
+    };
+}
+
+void AppListModel::setAvailableApps(const QList<DistroboxManager::AvailableApp> &apps, const QList<DistroboxManager::ExportedApp> &exported)
+{
+    QSet<QString> exportedBasenames;
+    for (const DistroboxManager::ExportedApp &app : exported) {
+        exportedBasenames.insert(app.basename);
+    }
+
+    QList<Entry> entries;
+    entries.reserve(apps.size());
+    for (const DistroboxManager::AvailableApp &app : apps) {
+        entries.append(Entry{app.basename, app.name, app.icon, ContainerIconProvider::url(app.iconSource), exportedBasenames.contains(app.basename), QString()});
+    }
+    setEntries(std::move(entries));
+}
+
+void AppListModel::setExportedApps(const QList<DistroboxManager::ExportedApp> &apps)
+{
+    QList<Entry> entries;
+    entries.reserve(apps.size());
+    for (const DistroboxManager::ExportedApp &app : apps) {
+        entries.append(Entry{app.basename, app.name, app.icon, QString(), true, QString()});
+    }
+    setEntries(std::move(entries));
+}
+
+void AppListModel::setEntries(QList<Entry> entries)
+{
+    for (Entry &entry : entries) {
+        if (entry.name.isEmpty()) {
+            entry.name = entry.basename;
+        }
+        entry.searchKey = entry.name.toLower() + QLatin1Char('\n') + entry.basename.toLower();
+    }
+
+    const bool countChanging = entries.size() != m_entries.size();
+
+    beginResetModel();
+    m_entries = std::move(entries);
+    endResetModel();
+
+    if (countChanging) {
+        Q_EMIT countChanged();
+    }
+}
+
+int AppListModel::matchScore(int row, QStringView needle) const
+{
+    if (row < 0 || row >= m_entries.size()) {
+        return 0;
+    }
+    if (needle.isEmpty()) {
+        return 1;
+    }
+
+    // Name and basename are scored separately so a subsequence never spans both
+    const QStringView key(m_entries[row].searchKey);
+    const qsizetype separator = key.indexOf(QLatin1Char('\n'));
+    return qMax(textScore(key.first(separator), needle), textScore(key.sliced(separator + 1), needle));
+}
@@ -0,0 +1,71 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include "distroboxmanager.h"
+
+#include <QAbstractListModel>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QtQml/qqmlregistration.h>
+
+/**
+ * @class AppListModel
+ * @brief List model of the applications of a container
+ *
+ * Holds either the exported or the available applications of a container, filled by
+ * DistroboxManager::loadApps(). Every entry keeps a lowercased search key built once on
+ * load, so filtering through AppFilterModel does not allocate per keystroke.
+ */
+class AppListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+    Q_PROPERTY(int count READ rowCount NOTIFY countChanged)
+
+public:
+    enum Roles {
+        BasenameRole = Qt::UserRole + 1,
+        NameRole,
+        IconRole,
+        IconSourceRole,
+        ExportedRole,
+    };
+    Q_ENUM(Roles)
+
+    explicit AppListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void setAvailableApps(const QList<DistroboxManager::AvailableApp> &apps, const QList<DistroboxManager::ExportedApp> &exported);
+    void setExportedApps(const QList<DistroboxManager::ExportedApp> &apps);
+
+    /**
+     * @brief Scores how well an entry matches a lowercased query
+     * @return 0 when it does not match, higher is better
+     */
+    int matchScore(int row, QStringView needle) const;
+
+Q_SIGNALS:
+    void countChanged();
+
+private:
+    struct Entry {
+        QString basename;
+        QString name;
+        QString icon;
+        QString iconSource; ///< Served by ContainerIconProvider when the icon was copied out of the container
+        bool exported = false;
+        QString searchKey; ///< Lowercased name and basename, separated by a newline
+    };
+
+    void setEntries(QList<Entry> entries);
+
+    QList<Entry> m_entries;
+};
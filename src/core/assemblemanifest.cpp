@@ -0,0 +1,119 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "assemblemanifest.h"
+
+#include <KLocalizedString>
+#include <QFile>
+#include <QHash>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+constexpr int MaxIncludeDepth = 16;
+
+// Keys can repeat (e.g. additional_packages), the last value wins for the ones read here
+struct RawSection {
+    QString name;
+    QHash<QString, QString> values;
+    QStringList includes;
+};
+
+QString unquoted(QString value)
+{
+    value = value.trimmed();
+    if (value.size() >= 2 && ((value.startsWith(QLatin1Char('"')) && value.endsWith(QLatin1Char('"'))) || (value.startsWith(QLatin1Char('\'')) && value.endsWith(QLatin1Char('\''))))) {
+        value = value.mid(1, value.size() - 2);
+    }
+    return value;
+}
+
+// Looks a key up in the section, then in the sections it includes, like distrobox does
+QString lookup(const QHash<QString, RawSection> &raw, const QString &section, const QString &key, int depth = 0)
+{
+    const auto it = raw.constFind(section);
+    if (it == raw.cend() || depth > MaxIncludeDepth) {
+        return {};
+    }
+    if (it->values.contains(key)) {
+        return it->values.value(key);
+    }
+
+    for (const QString &include : it->includes) {
+        const QString value = lookup(raw, include, key, depth + 1);
+        if (!value.isEmpty()) {
+            return value;
+        }
+    }
+    return {};
+}
+}
+
+namespace AssembleManifest
+{
+bool parse(const QString &path, QList<Section> &sections, QString &error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        error = i18n("Cannot read %1.", path);
+        return false;
+    }
+
+    QList<QString> order;
+    QHash<QString, RawSection> raw;
+    QString current;
+
+    for (const QByteArray &rawLine : file.readAll().split('\n')) {
+        const QString line = QString::fromUtf8(rawLine).trimmed();
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#')) || line.startsWith(QLatin1Char(';'))) {
+            continue;
+        }
+
+        if (line.startsWith(QLatin1Char('[')) && line.endsWith(QLatin1Char(']'))) {
+            current = line.mid(1, line.size() - 2).trimmed();
+            if (!raw.contains(current)) {
+                order.append(current);
+                raw.insert(current, RawSection{current, {}, {}});
+            }
+            continue;
+        }
+
+        const qsizetype equals = line.indexOf(QLatin1Char('='));
+        if (current.isEmpty() || equals <= 0) {
+            continue;
+        }
+
+        const QString key = line.left(equals).trimmed();
+        const QString value = unquoted(line.mid(equals + 1));
+        if (key == u"include"_s) {
+            raw[current].includes += value.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+        } else {
+            raw[current].values.insert(key, value);
+        }
+    }
+
+    if (order.isEmpty()) {
+        error = i18n("%1 does not define any container.", path);
+        return false;
+    }
+
+    sections.clear();
+    for (const QString &name : std::as_const(order)) {
+        Section section;
+        section.name = name;
+        section.image = lookup(raw, name, u"image"_s);
+        section.root = lookup(raw, name, u"root"_s) == u"true"_s;
+
+        if (section.image.isEmpty()) {
+            error = i18n("The container %1 has no image.", name);
+            return false;
+        }
+        sections.append(section);
+    }
+
+    return true;
+}
+}
@@ -0,0 +1,36 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/**
+ * Reader for distrobox assemble manifests.
+ *
+ * Only what is needed to schedule the sections is extracted: the container name, its
+ * image and whether it is rootful, with include= chains resolved. Creating a section is
+ * left to `distrobox assemble create --name`, so every other key keeps distrobox's
+ * semantics.
+ */
+namespace AssembleManifest
+{
+struct Section {
+    QString name;
+    QString image;
+    bool root = false;
+};
+
+/**
+ * @brief Parses a manifest
+ * @param path Path of the .ini file
+ * @param sections Receives the sections, in file order
+ * @param error Receives a description of the problem when parsing fails
+ * @return false if the file cannot be read, is empty or a section has no image
+ */
+bool parse(const QString &path, QList<Section> &sections, QString &error);
+}
@@ -0,0 +1,206 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "assemblerunner.h"
+
+#include "distroboxcli.h"
+#include "terminallauncher.h"
+
+#include <KLocalizedString>
+#include <QDebug>
+#include <QDir>
+#include <QPointer>
+#include <QSet>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+constexpr int OutputTailLines = 20;
+
+QString outputTail(const QString &output)
+{
+    const QStringList lines = output.split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    return lines.mid(qMax<qsizetype>(0, lines.size() - OutputTailLines)).join(QLatin1Char('\n'));
+}
+}
+
+AssembleRunner::AssembleRunner(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool AssembleRunner::start(const QString &manifestPath, const QList<AssembleManifest::Section> &sections, int maxParallel)
+{
+    if (isRunning() || sections.isEmpty()) {
+        return false;
+    }
+
+    m_manifestPath = manifestPath;
+    m_jobs.clear();
+    m_pulledImages.clear();
+    m_maxParallel = qMax(1, maxParallel);
+    m_running = 0;
+    m_terminalRunning = false;
+    m_pendingSections = int(sections.size());
+    m_success = true;
+
+    // Rootful containers use the root image store, distrobox pulls those itself
+    const QString manager = DistroboxCli::containerManager();
+    QSet<QString> images;
+    for (const AssembleManifest::Section &section : sections) {
+        if (section.root || images.contains(section.image)) {
+            continue;
+        }
+        images.insert(section.image);
+
+        // Values travel as positional parameters, the shell only provides the fallback and the redirections
+        const QString script = u"\"$1\" image inspect \"$2\" >/dev/null 2>&1 || \"$1\" pull \"$2\" 2>&1"_s;
+        m_jobs.append(Job{DistroboxCli::Command(u"sh"_s, {u"-c"_s, script, u"sh"_s, manager, section.image}), section.image, QString()});
+    }
+
+    const QString message = i18n("Press any key to close this terminal…");
+    const QString create = u"distrobox assemble create --file \"$1\" --name \"$2\""_s;
+    for (const AssembleManifest::Section &section : sections) {
+        if (section.root) {
+            // Kept open on failure, so the output can be read
+            const QString script = create + u" || { status=$?; echo ''; echo \"$3\"; read -s -n 1; exit $status; }"_s;
+            m_jobs.append(Job{DistroboxCli::Command(u"sh"_s, {u"-c"_s, script, u"sh"_s, manifestPath, section.name, message}), QString(), section.name, true});
+        } else {
+            m_jobs.append(Job{DistroboxCli::Command(u"sh"_s, {u"-c"_s, create + u" 2>&1"_s, u"sh"_s, manifestPath, section.name}), section.image, section.name});
+        }
+        Q_EMIT sectionProgress(section.name, State::Queued, QString());
+    }
+
+    schedule();
+    return true;
+}
+
+bool AssembleRunner::isRunning() const
+{
+    return m_pendingSections > 0;
+}
+
+QString AssembleRunner::stateName(State state)
+{
+    switch (state) {
+    case State::Queued:
+        return u"queued"_s;
+    case State::Pulling:
+        return u"pulling"_s;
+    case State::Creating:
+        return u"creating"_s;
+    case State::Created:
+        return u"created"_s;
+    case State::Failed:
+        return u"failed"_s;
+    }
+    return QString();
+}
+
+// Pulls come first in m_jobs, so shared images start downloading before any creation takes a slot
+void AssembleRunner::schedule()
+{
+    for (qsizetype index = 0; index < m_jobs.size(); ++index) {
+        Job &job = m_jobs[index];
+        if (job.running || job.done) {
+            continue;
+        }
+
+        if (job.inTerminal) {
+            if (m_terminalRunning) {
+                continue;
+            }
+            job.running = true;
+            m_terminalRunning = true;
+            Q_EMIT sectionProgress(job.section, State::Creating, QString());
+
+            // A terminal that cannot be started reports the failure through the callback
+            QPointer<AssembleRunner> self(this);
+            if (!TerminalLauncher::launch(job.command.toString(), QDir::homePath(), this, [self, index](bool success) {
+                    if (self) {
+                        self->jobFinished(index, success, i18n("Creating the container failed, see the terminal for details."));
+                    }
+                })) {
+                qWarning() << "Could not open a terminal to create" << job.section;
+            }
+            continue;
+        }
+
+        if (m_running >= m_maxParallel) {
+            continue;
+        }
+
+        const bool isPull = job.section.isEmpty();
+        if (!isPull && !job.image.isEmpty()) {
+            const auto pulled = m_pulledImages.constFind(job.image);
+            if (pulled == m_pulledImages.cend()) {
+                continue;
+            }
+            if (!pulled.value()) {
+                job.done = true;
+                finishSection(job.section, State::Failed, i18n("The image %1 could not be pulled.", job.image));
+                continue;
+            }
+        }
+
+        job.running = true;
+        ++m_running;
+
+        if (isPull) {
+            // Announce the pull on every section waiting for this image
+            for (const Job &waiting : std::as_const(m_jobs)) {
+                if (!waiting.section.isEmpty() && waiting.image == job.image) {
+                    Q_EMIT sectionProgress(waiting.section, State::Pulling, job.image);
+                }
+            }
+        } else {
+            Q_EMIT sectionProgress(job.section, State::Creating, QString());
+        }
+
+        QPointer<AssembleRunner> self(this);
+        DistroboxCli::runCommandAsync(job.command, this, [self, index](bool success, const QString &output) {
+            if (self) {
+                self->jobFinished(index, success, output);
+            }
+        });
+    }
+}
+
+void AssembleRunner::jobFinished(qsizetype index, bool success, const QString &output)
+{
+    Job &job = m_jobs[index];
+    job.running = false;
+    job.done = true;
+    if (job.inTerminal) {
+        m_terminalRunning = false;
+    } else {
+        --m_running;
+    }
+
+    if (job.section.isEmpty()) {
+        m_pulledImages.insert(job.image, success);
+        if (!success) {
+            // Failed sections are reported when schedule() reaches them
+            m_success = false;
+        }
+    } else {
+        finishSection(job.section, success ? State::Created : State::Failed, success ? QString() : outputTail(output));
+    }
+
+    schedule();
+}
+
+void AssembleRunner::finishSection(const QString &section, State state, const QString &detail)
+{
+    if (state == State::Failed) {
+        m_success = false;
+    }
+    Q_EMIT sectionProgress(section, state, detail);
+
+    if (--m_pendingSections == 0) {
+        Q_EMIT finished(m_success);
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include "assemblemanifest.h"
+#include "distroboxcli.h"
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+/**
+ * @class AssembleRunner
+ * @brief Creates the containers of an assemble manifest concurrently
+ *
+ * Every image used by the manifest is pulled once, then each section is created with
+ * `distrobox assemble create --name` as soon as its image is available, with at most a
+ * given number of jobs running at a time. A manifest therefore takes about as long as
+ * its slowest container instead of the sum of all of them.
+ *
+ * Rootful sections need sudo to ask for a password, they are created one at a time in a
+ * terminal next to the rootless ones.
+ */
+class AssembleRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class State {
+        Queued,
+        Pulling,
+        Creating,
+        Created,
+        Failed,
+    };
+
+    explicit AssembleRunner(QObject *parent = nullptr);
+
+    /**
+     * @brief Starts creating every section of the manifest
+     * @param manifestPath Path of the .ini file, passed on to distrobox
+     * @param sections Sections parsed from the manifest
+     * @param maxParallel Maximum number of pulls and creations running at once
+     * @return false if a manifest is already being assembled or there is nothing to do
+     */
+    bool start(const QString &manifestPath, const QList<AssembleManifest::Section> &sections, int maxParallel);
+
+    bool isRunning() const;
+
+    static QString stateName(State state);
+
+Q_SIGNALS:
+    void sectionProgress(const QString &section, AssembleRunner::State state, const QString &detail);
+    void finished(bool success);
+
+private:
+    struct Job {
+        DistroboxCli::Command command{QString()};
+        QString image; ///< Pull jobs: the image. Creation jobs: the image they wait for, empty if none
+        QString section; ///< Creation jobs only
+        bool inTerminal = false; ///< Rootful creation, run interactively instead of in the background
+        bool running = false;
+        bool done = false;
+    };
+
+    void schedule();
+    void jobFinished(qsizetype index, bool success, const QString &output);
+    void finishSection(const QString &section, State state, const QString &detail);
+
+    QString m_manifestPath;
+    QList<Job> m_jobs;
+    QHash<QString, bool> m_pulledImages; ///< Outcome of each finished pull
+    int m_maxParallel = 1;
+    int m_running = 0; ///< Background jobs running
+    bool m_terminalRunning = false;
+    int m_pendingSections = 0;
+    bool m_success = true;
+};
@@ -0,0 +1,443 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "containerarchive.h"
+
+#include "distroboxcli.h"
+
+#include <KFormat>
+#include <KLocalizedString>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QtConcurrent>
+
+#include <optional>
+#include <utility>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+constexpr qint64 ChunkSize = 1024 * 1024;
+// Bytes queued towards a child before the copy waits for it, bounds the memory used
+constexpr qint64 MaxBufferedBytes = 8 * ChunkSize;
+constexpr int PollIntervalMs = 250;
+constexpr int TerminateTimeoutMs = 3000;
+
+void stopProcess(QProcess &process)
+{
+    if (process.state() == QProcess::NotRunning) {
+        return;
+    }
+    process.terminate();
+    if (!process.waitForFinished(TerminateTimeoutMs)) {
+        process.kill();
+        process.waitForFinished(TerminateTimeoutMs);
+    }
+}
+
+// Waits for the process to exit while watching for cancellation
+bool waitForExit(QProcess &process, const std::atomic_bool &cancelled)
+{
+    while (process.state() != QProcess::NotRunning) {
+        if (cancelled) {
+            stopProcess(process);
+            return false;
+        }
+        process.waitForFinished(PollIntervalMs);
+    }
+    return process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+}
+
+// Queues the data and waits while the child lags behind
+bool writeBounded(QProcess &process, const QByteArray &data, const std::atomic_bool &cancelled)
+{
+    process.write(data);
+    while (process.bytesToWrite() > MaxBufferedBytes) {
+        if (cancelled || process.state() == QProcess::NotRunning) {
+            return false;
+        }
+        process.waitForBytesWritten(PollIntervalMs);
+    }
+    return process.state() != QProcess::NotRunning;
+}
+
+// Free bytes and mount point of the host filesystem holding the path, nothing when df fails
+std::optional<std::pair<qint64, QString>> freeSpace(const QString &path)
+{
+    bool success = false;
+    const QString output = DistroboxCli::runCommand(DistroboxCli::Command(u"df"_s, {u"-P"_s, u"-B1"_s, path}), success);
+    const QStringList fields = output.trimmed().section(QLatin1Char('\n'), -1).simplified().split(QLatin1Char(' '));
+    bool parsed = false;
+    const qint64 available = fields.value(3).toLongLong(&parsed);
+    if (!success || !parsed || fields.size() < 6) {
+        return std::nullopt;
+    }
+    return std::make_pair(available, fields.mid(5).join(QLatin1Char(' ')));
+}
+
+// Checks that each filesystem has room for everything written to it, unknown space passes
+bool hasFreeSpace(const QList<std::pair<QString, qint64>> &needs)
+{
+    QHash<QString, qint64> neededByMount;
+    QHash<QString, qint64> availableByMount;
+    for (const auto &[path, bytes] : needs) {
+        if (path.isEmpty() || bytes <= 0) {
+            continue;
+        }
+        const auto space = freeSpace(path);
+        if (!space) {
+            continue;
+        }
+        neededByMount[space->second] += bytes;
+        availableByMount.insert(space->second, space->first);
+    }
+
+    for (auto it = neededByMount.cbegin(); it != neededByMount.cend(); ++it) {
+        if (it.value() > availableByMount.value(it.key())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Where the container manager keeps its images
+QString imageStore(const QString &manager)
+{
+    const QString format = manager == u"docker"_s ? u"{{.DockerRootDir}}"_s : u"{{.Store.GraphRoot}}"_s;
+    bool success = false;
+    const QString directory = DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"info"_s, u"--format"_s, format}), success).trimmed();
+    return success ? directory : QString();
+}
+
+QString lastErrorLine(QProcess &process)
+{
+    const QStringList lines = QString::fromUtf8(process.readAllStandardError()).split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    return lines.isEmpty() ? QString() : lines.constLast().trimmed();
+}
+
+class ProgressReporter
+{
+public:
+    explicit ProgressReporter(const std::function<void(qint64, qint64)> &report)
+        : m_report(report)
+    {
+        m_elapsed.start();
+    }
+
+    void add(qint64 bytes)
+    {
+        m_processed += bytes;
+        if (m_elapsed.elapsed() - m_lastReport >= PollIntervalMs) {
+            flush();
+        }
+    }
+
+    void flush()
+    {
+        m_lastReport = m_elapsed.elapsed();
+        m_report(m_processed, m_lastReport > 0 ? m_processed * 1000 / m_lastReport : 0);
+    }
+
+private:
+    std::function<void(qint64, qint64)> m_report;
+    QElapsedTimer m_elapsed;
+    qint64 m_processed = 0;
+    qint64 m_lastReport = 0;
+};
+}
+
+ContainerArchive::ContainerArchive(QObject *parent)
+    : QObject(parent)
+{
+    connect(&m_watcher, &QFutureWatcher<QString>::finished, this, [this]() {
+        const QString error = m_watcher.result();
+        Q_EMIT finished(error.isEmpty(), error);
+    });
+}
+
+ContainerArchive::~ContainerArchive()
+{
+    cancel();
+    m_watcher.waitForFinished();
+}
+
+bool ContainerArchive::backup(const QString &container, const QString &filePath)
+{
+    if (isRunning() || container.isEmpty() || filePath.isEmpty()) {
+        return false;
+    }
+
+    start([this, container, filePath]() {
+        return runBackup(container, filePath);
+    });
+    return true;
+}
+
+bool ContainerArchive::restore(const QString &filePath, const QString &container)
+{
+    if (isRunning() || container.isEmpty() || filePath.isEmpty()) {
+        return false;
+    }
+
+    start([this, filePath, container]() {
+        return runRestore(filePath, container);
+    });
+    return true;
+}
+
+void ContainerArchive::cancel()
+{
+    m_cancelled = true;
+}
+
+bool ContainerArchive::isRunning() const
+{
+    return m_watcher.isRunning();
+}
+
+void ContainerArchive::start(const std::function<QString()> &job)
+{
+    m_cancelled = false;
+    m_watcher.setFuture(QtConcurrent::run(job));
+}
+
+QString ContainerArchive::runBackup(const QString &container, const QString &filePath)
+{
+    const QString manager = DistroboxCli::containerManager();
+    const QString snapshot = u"localhost/kontainer-backup/%1:%2"_s.arg(container.toLower(), QDateTime::currentDateTime().toString(u"yyyyMMdd-hhmmss"_s));
+
+    // The commit copies the writable layer of the container into the image store
+    bool sized = false;
+    const qint64 writableBytes =
+        DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"container"_s, u"inspect"_s, u"--size"_s, u"--format"_s, u"{{.SizeRw}}"_s, container}), sized)
+            .trimmed()
+            .toLongLong();
+    if (sized && !hasFreeSpace({{imageStore(manager), writableBytes}})) {
+        return i18n("Not enough free space to take a snapshot of %1.", container);
+    }
+
+    Q_EMIT stageChanged(i18n("Taking a snapshot of %1…", container));
+    DistroboxCli::Command commit(manager, {u"container"_s, u"commit"_s, u"--pause=true"_s, container, snapshot});
+    commit.quiet = true;
+    bool committed = false;
+    DistroboxCli::runCommand(commit, committed, DistroboxCli::LongTimeoutMs);
+    if (!committed) {
+        return i18n("Could not take a snapshot of %1.", container);
+    }
+
+    // The snapshot only adds the writable layer on top of the image, dropping its tag is cheap
+    const auto dropSnapshot = [&manager, &snapshot]() {
+        bool removed = false;
+        DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"rmi"_s, snapshot}), removed);
+    };
+
+    bool inspected = false;
+    const qint64 total =
+        DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"image"_s, u"inspect"_s, u"--format"_s, u"{{.Size}}"_s, snapshot}), inspected)
+            .trimmed()
+            .toLongLong();
+
+    Q_EMIT stageChanged(i18n("Compressing %1…", container));
+
+    // Written next to the target and renamed at the end, an interrupted backup never looks complete
+    const QString partialPath = filePath + u".part"_s;
+
+    QProcess compressor;
+    compressor.setStandardOutputFile(partialPath, QIODevice::Truncate);
+    DistroboxCli::startCommand(compressor, DistroboxCli::Command(u"zstd"_s, {u"-T0"_s, u"-3"_s, u"-q"_s, u"-c"_s}));
+
+    QProcess saver;
+    DistroboxCli::startCommand(saver, DistroboxCli::Command(manager, {u"save"_s, snapshot}));
+
+    const auto fail = [&](const QString &message) {
+        stopProcess(saver);
+        stopProcess(compressor);
+        QFile::remove(partialPath);
+        dropSnapshot();
+        return m_cancelled ? i18n("Backup cancelled.") : message;
+    };
+
+    if (!compressor.waitForStarted() || !saver.waitForStarted()) {
+        return fail(i18n("Could not start the backup."));
+    }
+
+    ProgressReporter reporter([this, total](qint64 processed, qint64 bytesPerSecond) {
+        Q_EMIT progress(processed, total, bytesPerSecond);
+    });
+
+    while (true) {
+        if (m_cancelled) {
+            return fail(QString());
+        }
+        if (saver.bytesAvailable() == 0) {
+            if (saver.state() == QProcess::NotRunning) {
+                break;
+            }
+            saver.waitForReadyRead(PollIntervalMs);
+            continue;
+        }
+
+        const QByteArray chunk = saver.read(ChunkSize);
+        if (!writeBounded(compressor, chunk, m_cancelled)) {
+            return fail(i18n("Compression failed: %1", lastErrorLine(compressor)));
+        }
+        reporter.add(chunk.size());
+    }
+    reporter.flush();
+
+    if (saver.exitStatus() != QProcess::NormalExit || saver.exitCode() != 0) {
+        return fail(i18n("Saving the snapshot failed: %1", lastErrorLine(saver)));
+    }
+
+    compressor.closeWriteChannel();
+    if (!waitForExit(compressor, m_cancelled)) {
+        return fail(i18n("Compression failed: %1", lastErrorLine(compressor)));
+    }
+
+    dropSnapshot();
+
+    QFile::remove(filePath);
+    if (!QFile::rename(partialPath, filePath)) {
+        QFile::remove(partialPath);
+        return i18n("Could not write %1.", filePath);
+    }
+    return {};
+}
+
+qint64 ContainerArchive::uncompressedSize(const QString &filePath)
+{
+    QFile archive(filePath);
+    if (!archive.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+
+    // Streamed archives do not record their size, counting it also tests the archive
+    QProcess counter;
+    DistroboxCli::startCommand(counter, DistroboxCli::Command(u"sh"_s, {u"-c"_s, u"zstd -d -q -c | wc -c"_s}));
+    if (!counter.waitForStarted()) {
+        return -1;
+    }
+
+    const qint64 total = archive.size();
+    ProgressReporter reporter([this, total](qint64 processed, qint64 bytesPerSecond) {
+        Q_EMIT progress(processed, total, bytesPerSecond);
+    });
+
+    while (!archive.atEnd()) {
+        const QByteArray chunk = archive.read(ChunkSize);
+        if (chunk.isEmpty() || !writeBounded(counter, chunk, m_cancelled)) {
+            stopProcess(counter);
+            return -1;
+        }
+        reporter.add(chunk.size());
+    }
+    reporter.flush();
+
+    counter.closeWriteChannel();
+    if (!waitForExit(counter, m_cancelled)) {
+        return -1;
+    }
+    bool parsed = false;
+    const qint64 size = counter.readAllStandardOutput().trimmed().toLongLong(&parsed);
+    return parsed && size > 0 ? size : -1;
+}
+
+QString ContainerArchive::runRestore(const QString &filePath, const QString &container)
+{
+    QFile archive(filePath);
+    if (!archive.open(QIODevice::ReadOnly)) {
+        return i18n("Could not open %1.", filePath);
+    }
+
+    Q_EMIT stageChanged(i18n("Checking the archive…"));
+    const qint64 imageBytes = uncompressedSize(filePath);
+    if (m_cancelled) {
+        return i18n("Restore cancelled.");
+    }
+    if (imageBytes < 0) {
+        return i18n("%1 is not a readable backup archive.", filePath);
+    }
+
+    // podman spools the whole uncompressed stream to /var/tmp before importing it, docker
+    // into its data root, and the imported layers take the same room again in the store
+    const QString manager = DistroboxCli::containerManager();
+    const QString store = imageStore(manager);
+    if (!hasFreeSpace({{manager == u"docker"_s ? store : u"/var/tmp"_s, imageBytes}, {store, imageBytes}})) {
+        return i18n("Not enough free space to load the image, %1 is needed.", KFormat().formatByteSize(2 * imageBytes));
+    }
+
+    Q_EMIT stageChanged(i18n("Loading the image…"));
+
+    QProcess loader;
+    QProcess decompressor;
+    decompressor.setStandardOutputProcess(&loader);
+    DistroboxCli::startCommand(loader, DistroboxCli::Command(manager, {u"load"_s}));
+    DistroboxCli::startCommand(decompressor, DistroboxCli::Command(u"zstd"_s, {u"-d"_s, u"-q"_s, u"-c"_s}));
+
+    const auto fail = [&](const QString &message) {
+        stopProcess(decompressor);
+        stopProcess(loader);
+        return m_cancelled ? i18n("Restore cancelled.") : message;
+    };
+
+    if (!loader.waitForStarted() || !decompressor.waitForStarted()) {
+        return fail(i18n("Could not start the restore."));
+    }
+
+    const qint64 total = archive.size();
+    ProgressReporter reporter([this, total](qint64 processed, qint64 bytesPerSecond) {
+        Q_EMIT progress(processed, total, bytesPerSecond);
+    });
+
+    while (!archive.atEnd()) {
+        if (m_cancelled) {
+            return fail(QString());
+        }
+
+        const QByteArray chunk = archive.read(ChunkSize);
+        if (chunk.isEmpty()) {
+            return fail(i18n("Could not read %1.", filePath));
+        }
+        if (!writeBounded(decompressor, chunk, m_cancelled)) {
+            return fail(i18n("Decompression failed: %1", lastErrorLine(decompressor)));
+        }
+        reporter.add(chunk.size());
+    }
+    reporter.flush();
+
+    decompressor.closeWriteChannel();
+    if (!waitForExit(decompressor, m_cancelled)) {
+        return fail(i18n("Decompression failed: %1", lastErrorLine(decompressor)));
+    }
+    if (!waitForExit(loader, m_cancelled)) {
+        return fail(i18n("Loading the image failed: %1", lastErrorLine(loader)));
+    }
+
+    // podman and docker both report the tag, docker only the ID for untagged images
+    static const QRegularExpression loadedPattern(u"Loaded image(?: ID)?: (\\S+)"_s);
+    QString image;
+    auto matches = loadedPattern.globalMatch(QString::fromUtf8(loader.readAllStandardOutput()));
+    while (matches.hasNext()) {
+        image = matches.next().captured(1);
+    }
+    if (image.isEmpty()) {
+        return i18n("The archive contains no image.");
+    }
+
+    Q_EMIT stageChanged(i18n("Creating %1…", container));
+    bool created = false;
+    DistroboxCli::runCommand(DistroboxCli::Command(u"distrobox"_s, {u"create"_s, u"--name"_s, container, u"--image"_s, image, u"--yes"_s}),
+                             created,
+                             DistroboxCli::LongTimeoutMs);
+    if (!created) {
+        return i18n("Could not create %1 from the archive.", container);
+    }
+    return {};
+}
@@ -0,0 +1,71 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <functional>
+
+/**
+ * @class ContainerArchive
+ * @brief Backs up containers to zstd-compressed image archives and restores them
+ *
+ * A backup commits the container to a temporary image and streams the saved image
+ * through a multi-threaded zstd straight into the archive file. A restore streams the
+ * file back through zstd into the container manager's image loader and creates the
+ * container from the loaded image. Data is copied in bounded chunks from a worker
+ * thread, so a slow disk throttles the producer instead of filling memory.
+ *
+ * Kontainer itself never writes an uncompressed tarball, the container manager still
+ * needs room: the commit copies the writable layer of the container into the image
+ * store, and the loader spools the whole uncompressed image to a temporary file before
+ * importing it. Free space is checked for both before starting.
+ */
+class ContainerArchive : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ContainerArchive(QObject *parent = nullptr);
+    ~ContainerArchive() override;
+
+    /**
+     * @brief Starts backing up the container to the file
+     * @return false if another backup or restore is running
+     */
+    bool backup(const QString &container, const QString &filePath);
+
+    /**
+     * @brief Starts restoring the archive as a new container
+     * @return false if another backup or restore is running
+     */
+    bool restore(const QString &filePath, const QString &container);
+
+    void cancel();
+    bool isRunning() const;
+
+Q_SIGNALS:
+    void stageChanged(const QString &stage);
+    /**
+     * @param processed Uncompressed bytes for a backup, archive bytes for a restore
+     * @param total Expected value of processed at the end, 0 when unknown
+     * @param bytesPerSecond Average throughput so far
+     */
+    void progress(qint64 processed, qint64 total, qint64 bytesPerSecond);
+    void finished(bool success, const QString &message);
+
+private:
+    QString runBackup(const QString &container, const QString &filePath);
+    QString runRestore(const QString &filePath, const QString &container);
+    qint64 uncompressedSize(const QString &filePath); ///< -1 when the archive is unreadable
+    void start(const std::function<QString()> &job);
+
+    QFutureWatcher<QString> m_watcher; ///< Result is an error message, empty on success
+    std::atomic_bool m_cancelled{false};
+};
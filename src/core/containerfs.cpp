@@ -0,0 +1,467 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "containerfs.h"
+
+#include "distroboxcli.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+
+#include <algorithm>
+#include <climits>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/xattr.h>
+#include <unistd.h>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+constexpr int MaxSymlinkDepth = 16;
+// Containers without readable roots are asked again after this long, they may have been started
+constexpr qint64 RetryUnavailableMs = 60 * 1000;
+
+struct Roots {
+    QStringList directories; ///< Overlay layers top-most first, or the single merged root
+    QElapsedTimer inspected;
+};
+
+QMutex rootsMutex;
+QHash<QString, Roots> rootsCache;
+
+QString runInContainer(const QString &container, const QStringList &arguments, bool &success)
+{
+    if (DistroboxCli::containerManager() == u"podman"_s) {
+        // Mounts the container in podman's user namespace and runs its own tools there, without starting it
+        const QString script = u"root=$(podman mount \"$1\") || exit 1; name=$1; shift; chroot \"$root\" \"$@\"; status=$?; "
+                               u"podman umount \"$name\" >/dev/null; exit $status"_s;
+        return DistroboxCli::runCommand(DistroboxCli::Command(u"podman"_s, QStringList{u"unshare"_s, u"sh"_s, u"-c"_s, script, u"sh"_s, container} + arguments),
+                                        success);
+    }
+    // The first enter of a container runs its whole setup
+    return DistroboxCli::runCommand(DistroboxCli::Command(u"distrobox"_s, QStringList{u"enter"_s, container, u"--"_s} + arguments),
+                                    success,
+                                    DistroboxCli::LongTimeoutMs);
+}
+
+bool isReadableDirectory(const QString &path)
+{
+    return ::access(QFile::encodeName(path).constData(), R_OK | X_OK) == 0 && QFileInfo(path).isDir();
+}
+
+QStringList inspectRoots(const QString &container)
+{
+    bool success = false;
+    const QString output = DistroboxCli::runCommand(
+        DistroboxCli::Command(DistroboxCli::containerManager(),
+                              {u"inspect"_s,
+                               u"--type"_s,
+                               u"container"_s,
+                               u"--format"_s,
+                               u"{{.GraphDriver.Data.UpperDir}}|{{.GraphDriver.Data.LowerDir}}|{{.GraphDriver.Data.MergedDir}}|{{.State.Pid}}"_s,
+                               container}),
+        success);
+    if (!success) {
+        return {};
+    }
+
+    const QStringList fields = output.trimmed().split(QLatin1Char('|'));
+    if (fields.size() < 4) {
+        return {};
+    }
+    const auto value = [](const QString &field) {
+        return field == u"<no value>"_s ? QString() : field;
+    };
+
+    const QString upper = value(fields[0]);
+    if (!upper.isEmpty()) {
+        QStringList layers{upper};
+        layers += value(fields[1]).split(QLatin1Char(':'), Qt::SkipEmptyParts);
+        if (std::all_of(layers.cbegin(), layers.cend(), isReadableDirectory)) {
+            return layers;
+        }
+    }
+
+    // The merged view of a running container, mounted where we can see it or through its init process
+    const QString merged = value(fields[2]);
+    if (!merged.isEmpty() && isReadableDirectory(merged)) {
+        return {merged};
+    }
+    const qint64 pid = fields[3].trimmed().toLongLong();
+    if (pid > 0) {
+        const QString processRoot = u"/proc/%1/root"_s.arg(pid);
+        if (isReadableDirectory(processRoot)) {
+            return {processRoot};
+        }
+    }
+    return {};
+}
+
+// Directories backing the container root, see Roots. Empty when nothing is visible from the
+// host. A container re-created under the same name gets new layers and a stopped one loses
+// its init process, both show up as a vanished first directory.
+QStringList containerRoots(const QString &container)
+{
+    {
+        QMutexLocker locker(&rootsMutex);
+        const auto cached = rootsCache.constFind(container);
+        if (cached != rootsCache.cend()) {
+            if (cached->directories.isEmpty() ? !cached->inspected.hasExpired(RetryUnavailableMs) : QFileInfo(cached->directories.first()).isDir()) {
+                return cached->directories;
+            }
+        }
+    }
+
+    Roots roots;
+    roots.directories = inspectRoots(container);
+    roots.inspected.start();
+
+    QMutexLocker locker(&rootsMutex);
+    rootsCache.insert(container, roots);
+    return roots.directories;
+}
+
+bool isWhiteout(const struct stat &st)
+{
+    return S_ISCHR(st.st_mode) && st.st_rdev == 0;
+}
+
+bool isOpaque(const QByteArray &directory)
+{
+    char value = 0;
+    for (const char *attribute : {"trusted.overlay.opaque", "user.overlay.opaque"}) {
+        if (::lgetxattr(directory.constData(), attribute, &value, 1) == 1 && value == 'y') {
+            return true;
+        }
+    }
+
+    // containers/storage and fuse-overlayfs mark opaque directories with a marker file
+    struct stat st;
+    return ::lstat((directory + "/.wh..wh..opq").constData(), &st) == 0;
+}
+
+// Resolves a container path to the host paths backing it in the merged view. A directory
+// yields every layer directory contributing entries, top-most first; anything else yields
+// the single top-most file. Symlinks are followed relative to the container root.
+QStringList resolve(const QStringList &roots, const QString &path, int depth = 0)
+{
+    if (depth > MaxSymlinkDepth) {
+        return {};
+    }
+
+    const QStringList components = QDir::cleanPath(QLatin1Char('/') + path).split(QLatin1Char('/'), Qt::SkipEmptyParts);
+    QStringList current = roots;
+
+    for (qsizetype i = 0; i < components.size(); ++i) {
+        QStringList next;
+
+        for (const QString &directory : std::as_const(current)) {
+            const QString candidate = directory + QLatin1Char('/') + components[i];
+            const QByteArray encoded = QFile::encodeName(candidate);
+
+            struct stat st;
+            if (::lstat(encoded.constData(), &st) != 0) {
+                continue;
+            }
+            if (isWhiteout(st)) {
+                break;
+            }
+
+            if (S_ISLNK(st.st_mode)) {
+                if (!next.isEmpty()) {
+                    break;
+                }
+
+                QByteArray target(PATH_MAX, '\0');
+                const ssize_t length = ::readlink(encoded.constData(), target.data(), target.size());
+                if (length <= 0) {
+                    return {};
+                }
+                target.truncate(length);
+
+                const QString linkTarget = QFile::decodeName(target);
+                QString redirected = linkTarget.startsWith(QLatin1Char('/'))
+                    ? linkTarget
+                    : QLatin1Char('/') + components.mid(0, i).join(QLatin1Char('/')) + QLatin1Char('/') + linkTarget;
+                if (i + 1 < components.size()) {
+                    redirected += QLatin1Char('/') + components.mid(i + 1).join(QLatin1Char('/'));
+                }
+                return resolve(roots, redirected, depth + 1);
+            }
+
+            if (!S_ISDIR(st.st_mode)) {
+                // The top-most non-directory wins and hides everything below it
+                if (next.isEmpty()) {
+                    next.append(candidate);
+                }
+                break;
+            }
+
+            next.append(candidate);
+            if (isOpaque(encoded)) {
+                break;
+            }
+        }
+
+        if (next.isEmpty()) {
+            return {};
+        }
+        current = next;
+    }
+
+    return current;
+}
+
+struct Entry {
+    QString name;
+    bool isDirectory = false;
+};
+
+// Merged listing of the directory, upper layers first so their whiteouts hide the entries below
+QList<Entry> listEntries(const QStringList &roots, const QString &directory)
+{
+    QList<Entry> entries;
+    QSet<QString> seen;
+
+    for (const QString &layerDirectory : resolve(roots, directory)) {
+        DIR *dir = ::opendir(QFile::encodeName(layerDirectory).constData());
+        if (!dir) {
+            continue;
+        }
+
+        const int fd = ::dirfd(dir);
+        while (const dirent *item = ::readdir(dir)) {
+            const QString name = QFile::decodeName(item->d_name);
+            if (name == u"."_s || name == u".."_s || name == u".wh..wh..opq"_s) {
+                continue;
+            }
+            if (name.startsWith(u".wh."_s)) {
+                seen.insert(name.mid(4));
+                continue;
+            }
+            if (seen.contains(name)) {
+                continue;
+            }
+            seen.insert(name);
+
+            struct stat st;
+            if (::fstatat(fd, item->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0 || isWhiteout(st)) {
+                continue;
+            }
+            entries.append(Entry{name, S_ISDIR(st.st_mode)});
+        }
+        ::closedir(dir);
+    }
+
+    return entries;
+}
+
+void collectFiles(const QStringList &roots, const QString &directory, int depth, QStringList &result)
+{
+    for (const Entry &entry : listEntries(roots, directory)) {
+        const QString path = directory + QLatin1Char('/') + entry.name;
+        if (!entry.isDirectory) {
+            result.append(path);
+        } else if (depth > 1) {
+            collectFiles(roots, path, depth - 1, result);
+        }
+    }
+}
+}
+
+namespace ContainerFs
+{
+bool hasLocalLayers(const QString &container)
+{
+    return !containerRoots(container).isEmpty();
+}
+
+bool readFile(const QString &container, const QString &path, QByteArray &data)
+{
+    return mapFile(container, path, [&data](QByteArrayView contents) {
+        data = contents.toByteArray();
+    });
+}
+
+bool mapFile(const QString &container, const QString &path, const std::function<void(QByteArrayView contents)> &consume)
+{
+    const QStringList roots = containerRoots(container);
+    if (roots.isEmpty()) {
+        bool success = false;
+        const QString encoded = runInContainer(container, {u"base64"_s, path}, success);
+        if (!success) {
+            return false;
+        }
+        consume(QByteArray::fromBase64(encoded.toLatin1()));
+        return true;
+    }
+
+    const QStringList backing = resolve(roots, path);
+    if (backing.isEmpty()) {
+        return false;
+    }
+
+    QFile file(backing.first());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 size = file.size();
+    uchar *mapped = size > 0 ? file.map(0, size) : nullptr;
+    if (!mapped) {
+        // Empty files and special files that cannot be mapped
+        consume(file.readAll());
+        return true;
+    }
+
+    consume(QByteArrayView(mapped, size));
+    file.unmap(mapped);
+    return true;
+}
+
+FileStamp stamp(const QString &container, const QString &path)
+{
+    FileStamp result;
+
+    const QStringList roots = containerRoots(container);
+    if (roots.isEmpty()) {
+        bool success = false;
+        const QString output = runInContainer(container, {u"stat"_s, u"-L"_s, u"-c"_s, u"%Y %s"_s, path}, success);
+        if (success) {
+            result.mtime = output.section(QLatin1Char(' '), 0, 0).toLongLong();
+            result.size = output.section(QLatin1Char(' '), 1, 1).trimmed().toLongLong();
+        }
+        return result;
+    }
+
+    const QStringList backing = resolve(roots, path);
+    struct stat st;
+    if (backing.isEmpty() || ::stat(QFile::encodeName(backing.first()).constData(), &st) != 0) {
+        return result;
+    }
+
+    result.mtime = st.st_mtim.tv_sec;
+    result.size = st.st_size;
+    return result;
+}
+
+QStringList entryList(const QString &container, const QString &directory)
+{
+    const QStringList roots = containerRoots(container);
+    if (roots.isEmpty()) {
+        bool success = false;
+        const QString output = runInContainer(container, {u"ls"_s, u"-1A"_s, directory}, success);
+        return success ? output.split(QLatin1Char('\n'), Qt::SkipEmptyParts) : QStringList();
+    }
+
+    QStringList names;
+    for (const Entry &entry : listEntries(roots, directory)) {
+        names.append(entry.name);
+    }
+    return names;
+}
+
+QStringList files(const QString &container, const QString &directory, int maxDepth)
+{
+    const QString cleanDirectory = QDir::cleanPath(QLatin1Char('/') + directory);
+
+    const QStringList roots = containerRoots(container);
+    if (roots.isEmpty()) {
+        bool success = false;
+        const QString output =
+            runInContainer(container, {u"find"_s, cleanDirectory, u"-maxdepth"_s, QString::number(maxDepth), u"!"_s, u"-type"_s, u"d"_s}, success);
+        return success ? output.split(QLatin1Char('\n'), Qt::SkipEmptyParts) : QStringList();
+    }
+
+    QStringList result;
+    collectFiles(roots, cleanDirectory == u"/"_s ? QString() : cleanDirectory, maxDepth, result);
+    return result;
+}
+
+QHash<QString, FileStamp> stamps(const QString &container, const QString &directory, bool &success, int maxDepth)
+{
+    QHash<QString, FileStamp> result;
+    success = true;
+
+    if (!hasLocalLayers(container)) {
+        // find -printf is GNU only, busybox and the BSD-like userlands of small images have stat -c.
+        // Symlinks are stamped by the link itself here, a changed stamp only costs a re-read.
+        const QString output = runInContainer(container,
+                                              {u"find"_s,
+                                               QDir::cleanPath(QLatin1Char('/') + directory),
+                                               u"-maxdepth"_s,
+                                               QString::number(maxDepth),
+                                               u"!"_s,
+                                               u"-type"_s,
+                                               u"d"_s,
+                                               u"-exec"_s,
+                                               u"stat"_s,
+                                               u"-c"_s,
+                                               u"%Y %s %n"_s,
+                                               u"{}"_s,
+                                               u"+"_s},
+                                              success);
+        if (!success) {
+            return result;
+        }
+        for (const QString &line : output.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+            FileStamp stamp;
+            stamp.mtime = line.section(QLatin1Char(' '), 0, 0).toLongLong();
+            stamp.size = line.section(QLatin1Char(' '), 1, 1).toLongLong();
+            result.insert(line.section(QLatin1Char(' '), 2), stamp);
+        }
+        return result;
+    }
+
+    for (const QString &path : files(container, directory, maxDepth)) {
+        const FileStamp fileStamp = stamp(container, path);
+        if (fileStamp.exists()) {
+            result.insert(path, fileStamp);
+        }
+    }
+    return result;
+}
+
+QHash<QString, QByteArray> readFiles(const QString &container, const QStringList &paths, bool &success)
+{
+    QHash<QString, QByteArray> result;
+    success = true;
+    if (paths.isEmpty()) {
+        return result;
+    }
+
+    if (!hasLocalLayers(container)) {
+        // One line per readable file: its path, a tab and its contents in base64
+        const QString script = u"for f; do data=$(base64 -w0 -- \"$f\") && printf '%s\\t%s\\n' \"$f\" \"$data\"; done; true"_s;
+        const QString output = runInContainer(container, QStringList{u"sh"_s, u"-c"_s, script, u"sh"_s} + paths, success);
+        if (!success) {
+            return result;
+        }
+        for (const QString &line : output.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+            const qsizetype separator = line.lastIndexOf(QLatin1Char('\t'));
+            if (separator > 0) {
+                result.insert(line.left(separator), QByteArray::fromBase64(line.mid(separator + 1).toLatin1()));
+            }
+        }
+        return result;
+    }
+
+    for (const QString &path : paths) {
+        QByteArray data;
+        if (readFile(container, path, data)) {
+            result.insert(path, data);
+        }
+    }
+    return result;
+}
+}
@@ -0,0 +1,62 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+/**
+ * Read-only access to a container's files from the host.
+ *
+ * Paths are resolved through the overlay layers of the container (writable layer first,
+ * then the image layers), honoring whiteouts, opaque directories and symlinks, so stopped
+ * containers can be read too and no process is spawned inside the container. When the
+ * layers are not readable, a running container is read through its merged root instead,
+ * either the overlay mount itself or /proc/<pid>/root of its init process. Only when
+ * neither is visible from here (e.g. inside the Flatpak sandbox) the functions fall back
+ * to running the equivalent command: podman mounts the container in its user namespace
+ * without starting it, docker containers are entered.
+ */
+namespace ContainerFs
+{
+struct FileStamp {
+    qint64 mtime = -1; ///< Modification time in seconds since the epoch, -1 if missing
+    qint64 size = -1;
+
+    bool exists() const
+    {
+        return mtime >= 0;
+    }
+    bool operator==(const FileStamp &other) const
+    {
+        return mtime == other.mtime && size == other.size;
+    }
+    bool operator!=(const FileStamp &other) const
+    {
+        return !(*this == other);
+    }
+};
+
+// Whether the layers or the merged root of the container are readable from here, i.e. nothing runs a command
+bool hasLocalLayers(const QString &container);
+bool readFile(const QString &container, const QString &path, QByteArray &data);
+// Hands the contents to consume without copying them, memory-mapped when read locally
+bool mapFile(const QString &container, const QString &path, const std::function<void(QByteArrayView contents)> &consume);
+FileStamp stamp(const QString &container, const QString &path);
+QStringList entryList(const QString &container, const QString &directory);
+// Absolute container paths of everything but directories below the directory, without following directory symlinks
+QStringList files(const QString &container, const QString &directory, int maxDepth = 8);
+// files() with the stamp of each, listed and stamped by a single command when the layers are not
+// readable. success is false when that command failed, an empty result then says nothing.
+QHash<QString, FileStamp> stamps(const QString &container, const QString &directory, bool &success, int maxDepth = 8);
+// Contents of the readable files among the paths, read by a single command when the layers are not readable
+QHash<QString, QByteArray> readFiles(const QString &container, const QStringList &paths, bool &success);
+}
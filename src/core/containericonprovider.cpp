@@ -0,0 +1,150 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "containericonprovider.h"
+
+#include "appcatalog.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageReader>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QUrl>
+
+#include <algorithm>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Used when the item does not ask for a size
+constexpr int DefaultSize = 48;
+// Decoding is IO and CPU bound, a couple of threads keep up with scrolling
+constexpr int MaxThreads = 2;
+
+QString iconsRoot()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + u"/kontainer/icons/"_s;
+}
+
+QImage readScaled(const QString &sourcePath, int size)
+{
+    QImageReader reader(sourcePath);
+    const QSize original = reader.size();
+
+    // Vector images are rendered straight at the target size, bitmaps are only ever scaled down
+    const bool vector = reader.format() == "svg" || reader.format() == "svgz";
+    if (original.isValid() && (vector || std::max(original.width(), original.height()) > size)) {
+        reader.setScaledSize(original.scaled(size, size, Qt::KeepAspectRatio));
+    } else if (!original.isValid() && vector) {
+        reader.setScaledSize(QSize(size, size));
+    }
+    return reader.read();
+}
+
+// Returns the thumbnail of the icon, creating it when missing or older than the icon
+QImage thumbnail(const QString &container, const QString &fileName, int size)
+{
+    const QDir cacheDirectory(AppCatalog::iconCacheDirectory(container));
+    const QFileInfo source(cacheDirectory.filePath(fileName));
+    if (!source.isFile()) {
+        return {};
+    }
+
+    const QString thumbnailPath = cacheDirectory.filePath(u"thumbnails/%1/%2.png"_s.arg(size).arg(source.completeBaseName()));
+    const QFileInfo cached(thumbnailPath);
+    if (cached.exists() && cached.lastModified() >= source.lastModified()) {
+        QImage image(thumbnailPath);
+        if (!image.isNull()) {
+            return image;
+        }
+    }
+
+    QImage image = readScaled(source.filePath(), size);
+    if (image.isNull()) {
+        return {};
+    }
+
+    // Only a cache, a failed write just means decoding again next time
+    cacheDirectory.mkpath(QFileInfo(thumbnailPath).path());
+    QSaveFile file(thumbnailPath);
+    if (file.open(QIODevice::WriteOnly) && image.save(&file, "PNG")) {
+        file.commit();
+    }
+    return image;
+}
+
+class ContainerIconResponse : public QQuickImageResponse, public QRunnable
+{
+public:
+    ContainerIconResponse(const QString &id, const QSize &requestedSize)
+        : m_id(id)
+        , m_size(requestedSize)
+    {
+        setAutoDelete(false);
+    }
+
+    QQuickTextureFactory *textureFactory() const override
+    {
+        return QQuickTextureFactory::textureFactoryForImage(m_image);
+    }
+
+    QString errorString() const override
+    {
+        return m_image.isNull() ? u"No icon for %1"_s.arg(m_id) : QString();
+    }
+
+    void run() override
+    {
+        const qsizetype separator = m_id.indexOf(QLatin1Char('/'));
+        const QString container = m_id.left(separator);
+        const QString fileName = m_id.mid(separator + 1);
+
+        // Both end up in paths, never let them leave the icon cache
+        if (separator > 0 && !container.contains(u".."_s) && !fileName.isEmpty() && !fileName.contains(QLatin1Char('/')) && !fileName.startsWith(QLatin1Char('.'))) {
+            const int size = m_size.isValid() && !m_size.isEmpty() ? std::max(m_size.width(), m_size.height()) : DefaultSize;
+            m_image = thumbnail(container, fileName, size);
+        }
+        Q_EMIT finished();
+    }
+
+private:
+    QString m_id;
+    QSize m_size;
+    QImage m_image;
+};
+}
+
+ContainerIconProvider::ContainerIconProvider()
+{
+    m_pool.setMaxThreadCount(MaxThreads);
+}
+
+QQuickImageResponse *ContainerIconProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    auto *response = new ContainerIconResponse(QUrl::fromPercentEncoding(id.toUtf8()), requestedSize);
+    m_pool.start(response);
+    return response;
+}
+
+QString ContainerIconProvider::url(const QString &iconSource)
+{
+    const QString root = iconsRoot();
+    const QString path = QUrl(iconSource).toLocalFile();
+    if (iconSource.isEmpty() || !path.startsWith(root)) {
+        return iconSource;
+    }
+
+    const QString relative = path.mid(root.size());
+    const qsizetype separator = relative.indexOf(QLatin1Char('/'));
+    if (separator <= 0) {
+        return iconSource;
+    }
+    return u"image://containericon/%1/%2"_s.arg(QString::fromUtf8(QUrl::toPercentEncoding(relative.left(separator))),
+                                                   QString::fromUtf8(QUrl::toPercentEncoding(relative.mid(separator + 1))));
+}
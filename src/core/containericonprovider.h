@@ -0,0 +1,36 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include <QQuickAsyncImageProvider>
+#include <QThreadPool>
+
+/**
+ * @class ContainerIconProvider
+ * @brief Serves the icons copied out of containers to QML as pre-scaled thumbnails
+ *
+ * Registered as image://containericon/<container>/<file>, where <file> names an icon in
+ * the container's icon cache. Icons are decoded on a small thread pool at the size the
+ * item asks for, SVGs are rasterized once, and the result is kept as a PNG thumbnail next
+ * to the original. Later requests only decode the small thumbnail, so scrolling a long
+ * application list neither stalls the GUI thread nor holds full-size icons in memory.
+ */
+class ContainerIconProvider : public QQuickAsyncImageProvider
+{
+public:
+    ContainerIconProvider();
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+    /**
+     * @brief Maps a file URL of the icon cache to the URL served by this provider
+     * @return The provider URL, or the URL unchanged when it is not in the icon cache
+     */
+    static QString url(const QString &iconSource);
+
+private:
+    QThreadPool m_pool;
+};
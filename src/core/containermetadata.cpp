@@ -0,0 +1,375 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "containermetadata.h"
+
+#include "containerfs.h"
+#include "distroboxcli.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QThreadPool>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace ContainerMetadata
+{
+// Found by argument-dependent lookup from the QHash stream operators
+static QDataStream &operator<<(QDataStream &stream, const Metadata &metadata)
+{
+    return stream << metadata.containerId << metadata.osId << metadata.osIdLike << metadata.osName << metadata.osVersion
+                  << qint32(metadata.packageManager) << metadata.architecture << metadata.shell << metadata.distroboxVersion;
+}
+
+static QDataStream &operator>>(QDataStream &stream, Metadata &metadata)
+{
+    qint32 packageManager = 0;
+    stream >> metadata.containerId >> metadata.osId >> metadata.osIdLike >> metadata.osName >> metadata.osVersion >> packageManager
+        >> metadata.architecture >> metadata.shell >> metadata.distroboxVersion;
+    metadata.packageManager = PackageInstallCommand::PackageManager(packageManager);
+    return stream;
+}
+}
+
+namespace
+{
+using PackageInstallCommand::PackageManager;
+
+constexpr quint32 CacheVersion = 1;
+const auto SectionSeparator = "--kontainer-probe--"_L1;
+
+struct PackageManagerBinary {
+    PackageManager packageManager;
+    QLatin1StringView binary;
+};
+
+// Order matters: zypper and pacman based images may ship rpm or apt helpers too
+constexpr PackageManagerBinary PackageManagerBinaries[] = {
+    {PackageManager::Dnf, "dnf"_L1},
+    {PackageManager::Dnf, "yum"_L1},
+    {PackageManager::Zypper, "zypper"_L1},
+    {PackageManager::Pacman, "pacman"_L1},
+    {PackageManager::Apk, "apk"_L1},
+    {PackageManager::Xbps, "xbps-install"_L1},
+    {PackageManager::Emerge, "emerge"_L1},
+    {PackageManager::Apt, "apt-get"_L1},
+    {PackageManager::Installpkg, "installpkg"_L1},
+};
+
+QMutex storeMutex;
+bool storeLoaded = false;
+QHash<QString, ContainerMetadata::Metadata> store;
+QSet<QString> verifiedContainers; ///< Containers whose ID was checked this session
+
+QString cacheFilePath()
+{
+    const QString cacheBase = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheBase.isEmpty()) {
+        return {};
+    }
+
+    const QString directory = QDir(cacheBase).filePath(u"kontainer"_s);
+    QDir().mkpath(directory);
+    return QDir(directory).filePath(u"metadata.cache"_s);
+}
+
+// Callers hold storeMutex
+void loadStore()
+{
+    if (storeLoaded) {
+        return;
+    }
+    storeLoaded = true;
+
+    QFile file(cacheFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    quint32 version = 0;
+    QHash<QString, ContainerMetadata::Metadata> loaded;
+    stream >> version;
+    if (version != CacheVersion) {
+        return;
+    }
+    stream >> loaded;
+    if (stream.status() == QDataStream::Ok) {
+        store = loaded;
+    }
+}
+
+// Callers hold storeMutex
+void saveStore()
+{
+    QSaveFile file(cacheFilePath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << CacheVersion << store;
+    file.commit();
+}
+
+QString containerId(const QString &container, QString &imageId, QString &entrypoint)
+{
+    const QString format = u"{{.Id}}|{{.Image}}|{{range .Mounts}}{{if eq .Destination \"/usr/bin/entrypoint\"}}{{.Source}}{{end}}{{end}}"_s;
+
+    bool success = false;
+    const QString output =
+        DistroboxCli::runCommand(DistroboxCli::Command(DistroboxCli::containerManager(), {u"inspect"_s, u"--type"_s, u"container"_s, u"--format"_s, format, container}),
+                                 success);
+    if (!success) {
+        return {};
+    }
+
+    const QString line = output.trimmed();
+    imageId = line.section(QLatin1Char('|'), 1, 1);
+    entrypoint = line.section(QLatin1Char('|'), 2);
+    return line.section(QLatin1Char('|'), 0, 0);
+}
+
+void parseOsRelease(const QString &content, ContainerMetadata::Metadata &metadata)
+{
+    for (const QString &line : content.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+        const QString key = line.section(QLatin1Char('='), 0, 0).trimmed();
+        QString value = line.section(QLatin1Char('='), 1).trimmed();
+        if (value.size() >= 2 && (value.startsWith(QLatin1Char('"')) || value.startsWith(QLatin1Char('\'')))) {
+            value = value.mid(1, value.size() - 2);
+        }
+
+        if (key == u"ID"_s) {
+            metadata.osId = value;
+        } else if (key == u"ID_LIKE"_s) {
+            metadata.osIdLike = value.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+        } else if (key == u"PRETTY_NAME"_s) {
+            metadata.osName = value;
+        } else if (key == u"VERSION_ID"_s) {
+            metadata.osVersion = value;
+        }
+    }
+}
+
+QString shellFromPasswd(const QString &passwd, const QString &user)
+{
+    for (const QString &line : passwd.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+        if (line.section(QLatin1Char(':'), 0, 0) == user) {
+            return line.section(QLatin1Char(':'), 6, 6).trimmed();
+        }
+    }
+    return {};
+}
+
+PackageManager packageManagerFromBinary(const QString &binary)
+{
+    for (const PackageManagerBinary &entry : PackageManagerBinaries) {
+        if (binary == entry.binary) {
+            return entry.packageManager;
+        }
+    }
+    return PackageManager::Unknown;
+}
+
+// Image architectures use the Go names, the rest of the tree uses uname -m
+QString unameArchitecture(const QString &architecture)
+{
+    if (architecture == u"amd64"_s) {
+        return u"x86_64"_s;
+    }
+    if (architecture == u"arm64"_s) {
+        return u"aarch64"_s;
+    }
+    if (architecture == u"386"_s) {
+        return u"i686"_s;
+    }
+    return architecture;
+}
+
+// Reads everything from the host through the overlay layers, the container is not started
+void probeFromHost(const QString &container, const QString &imageId, ContainerMetadata::Metadata &metadata)
+{
+    QByteArray data;
+    if (ContainerFs::readFile(container, u"/etc/os-release"_s, data) || ContainerFs::readFile(container, u"/usr/lib/os-release"_s, data)) {
+        parseOsRelease(QString::fromUtf8(data), metadata);
+    }
+
+    if (ContainerFs::readFile(container, u"/etc/passwd"_s, data)) {
+        metadata.shell = shellFromPasswd(QString::fromUtf8(data), qEnvironmentVariable("USER"));
+    }
+
+    for (const PackageManagerBinary &entry : PackageManagerBinaries) {
+        if (ContainerFs::stamp(container, u"/usr/bin/"_s + entry.binary).exists() || ContainerFs::stamp(container, u"/sbin/"_s + entry.binary).exists()) {
+            metadata.packageManager = entry.packageManager;
+            break;
+        }
+    }
+
+    bool success = false;
+    const QString architecture =
+        DistroboxCli::runCommand(DistroboxCli::Command(DistroboxCli::containerManager(), {u"image"_s, u"inspect"_s, u"--format"_s, u"{{.Architecture}}"_s, imageId}),
+                                 success);
+    if (success) {
+        metadata.architecture = unameArchitecture(architecture.trimmed());
+    }
+}
+
+// Collects everything with a single entry into the container
+void probeInContainer(const QString &container, ContainerMetadata::Metadata &metadata)
+{
+    QStringList binaries;
+    for (const PackageManagerBinary &entry : PackageManagerBinaries) {
+        binaries.append(QString(entry.binary));
+    }
+
+    const QString script = QStringLiteral(
+                               "cat /etc/os-release 2>/dev/null || cat /usr/lib/os-release 2>/dev/null; echo %1; "
+                               "uname -m; echo %1; "
+                               "getent passwd \"$(id -un)\" | cut -d: -f7; echo %1; "
+                               "for pm in %2; do if command -v \"$pm\" >/dev/null 2>&1; then echo \"$pm\"; break; fi; done")
+                               .arg(QString(SectionSeparator), binaries.join(QLatin1Char(' ')));
+
+    bool success = false;
+    const QString output =
+        DistroboxCli::runCommand(DistroboxCli::Command(u"distrobox"_s, {u"enter"_s, container, u"--"_s, u"sh"_s, u"-c"_s, script}), success, DistroboxCli::LongTimeoutMs);
+    if (!success) {
+        return;
+    }
+
+    const QStringList sections = output.split(QString(SectionSeparator));
+    if (sections.size() < 4) {
+        return;
+    }
+
+    parseOsRelease(sections[0], metadata);
+    metadata.architecture = sections[1].trimmed();
+    metadata.shell = sections[2].trimmed();
+    metadata.packageManager = packageManagerFromBinary(sections[3].trimmed());
+}
+
+ContainerMetadata::Metadata probe(const QString &container, const QString &id, const QString &imageId, const QString &entrypoint)
+{
+    ContainerMetadata::Metadata metadata;
+
+    if (ContainerFs::hasLocalLayers(container)) {
+        probeFromHost(container, imageId, metadata);
+    } else {
+        probeInContainer(container, metadata);
+    }
+
+    // The entrypoint is the host's distrobox-init, bind mounted when the container was created
+    if (!entrypoint.isEmpty()) {
+        bool success = false;
+        const QString version = DistroboxCli::runCommand(DistroboxCli::Command(u"sed"_s, {u"-n"_s, u"s/^version=//p"_s, entrypoint}), success);
+        if (success) {
+            metadata.distroboxVersion = version.trimmed().remove(QLatin1Char('"'));
+        }
+    }
+
+    metadata.containerId = id;
+    return metadata;
+}
+}
+
+namespace ContainerMetadata
+{
+Metadata get(const QString &container)
+{
+    {
+        QMutexLocker locker(&storeMutex);
+        loadStore();
+        if (verifiedContainers.contains(container)) {
+            return store.value(container);
+        }
+    }
+
+    QString imageId;
+    QString entrypoint;
+    const QString id = containerId(container, imageId, entrypoint);
+    if (id.isEmpty()) {
+        return {};
+    }
+
+    {
+        QMutexLocker locker(&storeMutex);
+        const auto existing = store.constFind(container);
+        if (existing != store.cend() && existing->containerId == id) {
+            verifiedContainers.insert(container);
+            return *existing;
+        }
+    }
+
+    const Metadata metadata = probe(container, id, imageId, entrypoint);
+
+    QMutexLocker locker(&storeMutex);
+    store.insert(container, metadata);
+    verifiedContainers.insert(container);
+    saveStore();
+    return metadata;
+}
+
+std::optional<Metadata> cached(const QString &container)
+{
+    QMutexLocker locker(&storeMutex);
+    loadStore();
+
+    const auto existing = store.constFind(container);
+    if (existing == store.cend()) {
+        return std::nullopt;
+    }
+    return *existing;
+}
+
+void prefetch(const QStringList &containers)
+{
+    QStringList pending;
+    {
+        QMutexLocker locker(&storeMutex);
+        for (const QString &container : containers) {
+            if (!verifiedContainers.contains(container)) {
+                pending.append(container);
+            }
+        }
+    }
+    if (pending.isEmpty()) {
+        return;
+    }
+
+    // Entering a container to probe it would start it, leave those to the first real use
+    QThreadPool::globalInstance()->start([pending]() {
+        for (const QString &container : pending) {
+            if (ContainerFs::hasLocalLayers(container)) {
+                get(container);
+            }
+        }
+    });
+}
+
+void forget(const QString &container)
+{
+    QMutexLocker locker(&storeMutex);
+    loadStore();
+
+    verifiedContainers.remove(container);
+    if (store.remove(container) > 0) {
+        saveStore();
+    }
+}
+
+PackageInstallCommand::PackageManager packageManager(const QString &container, const QString &image)
+{
+    const std::optional<Metadata> metadata = cached(container);
+    if (metadata && metadata->packageManager != PackageManager::Unknown) {
+        return metadata->packageManager;
+    }
+    return PackageInstallCommand::packageManagerForImage(image);
+}
+}
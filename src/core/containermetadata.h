@@ -0,0 +1,72 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include "packageinstallcommand.h"
+
+#include <QString>
+#include <QStringList>
+#include <optional>
+
+/**
+ * Facts about a container that never change during its lifetime: its distribution,
+ * package manager, architecture, login shell and the distrobox version that set it up.
+ *
+ * They are probed once per container ID and persisted, so a container re-created under
+ * the same name is probed again but nothing else is. Probing reads the files through
+ * ContainerFs from the host when its layers are visible, without starting the container,
+ * and otherwise runs a single script in the container.
+ */
+namespace ContainerMetadata
+{
+struct Metadata {
+    QString containerId;
+    QString osId; ///< ID from os-release, e.g. "fedora"
+    QStringList osIdLike; ///< ID_LIKE from os-release
+    QString osName; ///< PRETTY_NAME from os-release
+    QString osVersion; ///< VERSION_ID from os-release
+    PackageInstallCommand::PackageManager packageManager = PackageInstallCommand::PackageManager::Unknown;
+    QString architecture; ///< Machine name as printed by uname -m
+    QString shell; ///< Login shell of the user inside the container
+    QString distroboxVersion; ///< Version of the distrobox init the container runs
+
+    bool isValid() const
+    {
+        return !containerId.isEmpty();
+    }
+};
+
+/**
+ * @brief Gets the metadata of a container, probing it if it is unknown or was re-created
+ *
+ * The container ID is checked once per session. Blocks while probing, safe to call from
+ * any thread.
+ */
+Metadata get(const QString &container);
+
+/**
+ * @brief Gets the stored metadata without any I/O, for callers that must not block
+ */
+std::optional<Metadata> cached(const QString &container);
+
+/**
+ * @brief Probes in the background the containers that can be read without starting them
+ */
+void prefetch(const QStringList &containers);
+
+/**
+ * @brief Drops the stored metadata, e.g. after the container was removed
+ */
+void forget(const QString &container);
+
+/**
+ * @brief Package manager of the container, guessed from the image name when it was not probed yet
+ *
+ * Only looks at the stored metadata and never blocks, probing may enter and so start the
+ * container. prefetch() fills the store for the containers readable from the host.
+ */
+PackageInstallCommand::PackageManager packageManager(const QString &container, const QString &image);
+}
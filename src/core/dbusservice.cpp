@@ -0,0 +1,157 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "dbusservice.h"
+
+#include "appcatalog.h"
+#include "distroboxcli.h"
+#include "distroboxmanager.h"
+
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QtConcurrent>
+
+using namespace Qt::Literals::StringLiterals;
+
+DBusService::DBusService(DistroboxManager *manager)
+    : QObject(manager)
+    , m_manager(manager)
+{
+    connect(m_manager, &DistroboxManager::containerStateChanged, this, &DBusService::ContainerStateChanged);
+}
+
+bool DBusService::registerOnSessionBus()
+{
+    return QDBusConnection::sessionBus().registerObject(u"/Manager"_s, this, QDBusConnection::ExportScriptableSlots | QDBusConnection::ExportScriptableSignals);
+}
+
+// Answers from the cache when possible and refreshes it in the background. Without a cached
+// value a D-Bus caller gets a delayed reply once the function, run off the GUI thread, returns.
+template<typename Function>
+QString DBusService::replyWhenDone(const QString &cacheKey, Function function)
+{
+    const auto cached = m_cache.constFind(cacheKey);
+    const bool warm = cached != m_cache.cend();
+
+    QDBusMessage pendingReply;
+    if (!warm && calledFromDBus()) {
+        setDelayedReply(true);
+        pendingReply = message();
+    }
+
+    if (!m_refreshing.value(cacheKey) || pendingReply.type() != QDBusMessage::InvalidMessage) {
+        m_refreshing.insert(cacheKey, true);
+
+        auto *watcher = new QFutureWatcher<QString>(this);
+        connect(watcher, &QFutureWatcher<QString>::finished, this, [this, watcher, cacheKey, pendingReply]() {
+            const QString result = watcher->result();
+            watcher->deleteLater();
+
+            m_cache.insert(cacheKey, result);
+            m_refreshing.remove(cacheKey);
+            if (pendingReply.type() != QDBusMessage::InvalidMessage) {
+                QDBusConnection::sessionBus().send(pendingReply.createReply(result));
+            }
+        });
+        watcher->setFuture(QtConcurrent::run(function));
+    }
+
+    return warm ? cached.value() : QString();
+}
+
+QString DBusService::ListContainers()
+{
+    return replyWhenDone(u"containers"_s, []() {
+        return DistroboxCli::containersJson(DistroboxCli::containers());
+    });
+}
+
+QString DBusService::ListApps(const QString &container)
+{
+    return replyWhenDone(u"apps|"_s + container, [container]() {
+        return AppCatalog::availableAppsJson(AppCatalog::availableApps(container));
+    });
+}
+
+// Exported apps are plain files on the host, reading them is cheap enough to do inline
+QString DBusService::ListExportedApps(const QString &container)
+{
+    return AppCatalog::exportedAppsJson(AppCatalog::exportedApps(container));
+}
+
+// Exporting enters the container, which can take long, so the reply is delayed until the
+// work, run off the GUI thread, finished
+bool DBusService::ExportApp(const QString &basename, const QString &container)
+{
+    DistroboxManager *manager = m_manager;
+    return replyWithResult([manager, basename, container]() {
+        return manager->exportApp(basename, container);
+    });
+}
+
+bool DBusService::UnexportApp(const QString &basename, const QString &container)
+{
+    DistroboxManager *manager = m_manager;
+    return replyWithResult([manager, basename, container]() {
+        return manager->unexportApp(basename, container);
+    });
+}
+
+template<typename Function>
+bool DBusService::replyWithResult(Function function)
+{
+    QDBusMessage pendingReply;
+    if (calledFromDBus()) {
+        setDelayedReply(true);
+        pendingReply = message();
+    }
+
+    auto *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [watcher, pendingReply]() {
+        const bool success = watcher->result();
+        watcher->deleteLater();
+        if (pendingReply.type() != QDBusMessage::InvalidMessage) {
+            QDBusConnection::sessionBus().send(pendingReply.createReply(success));
+        }
+    });
+    watcher->setFuture(QtConcurrent::run(function));
+    return false;
+}
+
+bool DBusService::StartContainer(const QString &container)
+{
+    return replyWithCommand(DistroboxCli::Command(u"distrobox"_s, {u"enter"_s, container, u"--"_s, u"true"_s}), container, true);
+}
+
+bool DBusService::StopContainer(const QString &container)
+{
+    return replyWithCommand(DistroboxCli::Command(u"distrobox"_s, {u"stop"_s, u"--yes"_s, container}), container, false);
+}
+
+bool DBusService::replyWithCommand(const DistroboxCli::Command &command, const QString &container, bool running)
+{
+    QDBusMessage pendingReply;
+    if (calledFromDBus()) {
+        setDelayedReply(true);
+        pendingReply = message();
+    }
+
+    QPointer<DBusService> self(this);
+    DistroboxCli::runCommandAsync(command, this, [self, pendingReply, container, running](bool success, const QString &) {
+        if (!self) {
+            return;
+        }
+        if (success) {
+            self->m_cache.remove(u"containers"_s);
+            Q_EMIT self->m_manager->containerStateChanged(container, running);
+        }
+        if (pendingReply.type() != QDBusMessage::InvalidMessage) {
+            QDBusConnection::sessionBus().send(pendingReply.createReply(success));
+        }
+    });
+    return false;
+}
@@ -0,0 +1,62 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include "distroboxcli.h"
+
+#include <QDBusContext>
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+class DistroboxManager;
+
+/**
+ * @class DBusService
+ * @brief Exposes a running Kontainer on the session bus
+ *
+ * Registered at /Manager next to the single-instance service of the application. Listing
+ * methods answer from the in-process caches when they are warm and refresh them in the
+ * background; otherwise the reply is delayed until the work done off the GUI thread
+ * finishes. Listings are returned as JSON strings, in the same shape as the QML API.
+ */
+class DBusService : public QObject, protected QDBusContext
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "io.github.DenysMb.Kontainer.Manager")
+
+public:
+    explicit DBusService(DistroboxManager *manager);
+
+    /**
+     * @brief Registers the service object on the session bus
+     * @return false if the object path is already taken
+     */
+    bool registerOnSessionBus();
+
+public Q_SLOTS:
+    Q_SCRIPTABLE QString ListContainers();
+    Q_SCRIPTABLE QString ListApps(const QString &container);
+    Q_SCRIPTABLE QString ListExportedApps(const QString &container);
+    Q_SCRIPTABLE bool ExportApp(const QString &basename, const QString &container);
+    Q_SCRIPTABLE bool UnexportApp(const QString &basename, const QString &container);
+    Q_SCRIPTABLE bool StartContainer(const QString &container);
+    Q_SCRIPTABLE bool StopContainer(const QString &container);
+
+Q_SIGNALS:
+    Q_SCRIPTABLE void ContainerStateChanged(const QString &container, bool running);
+
+private:
+    template<typename Function>
+    QString replyWhenDone(const QString &cacheKey, Function function);
+    template<typename Function>
+    bool replyWithResult(Function function);
+    bool replyWithCommand(const DistroboxCli::Command &command, const QString &container, bool running);
+
+    DistroboxManager *m_manager;
+    QHash<QString, QString> m_cache; ///< Last reply of each listing, by method and argument
+    QHash<QString, bool> m_refreshing; ///< Listings currently recomputed in the background
+};
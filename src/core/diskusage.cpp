@@ -0,0 +1,434 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "diskusage.h"
+
+#include "distroboxcli.h"
+
+#include <KFormat>
+#include <KLocalizedString>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+constexpr int TopDirectoryCount = 10;
+constexpr int TopDirectoryMaxDepth = 4;
+constexpr int TrackedFileCount = 8;
+constexpr quint32 CacheVersion = 2;
+
+struct DirectoryEntry {
+    qint64 mtime = -1; ///< Directory mtime in nanoseconds, used to skip re-reading unchanged listings
+    qint64 fileBytes = 0; ///< Allocated size of the non-directory entries directly inside
+    QHash<QString, qint64> largestFiles; ///< mtimes of the largest files directly inside, re-checked on every scan
+    qint64 totalBytes = 0; ///< Allocated size of the whole subtree
+    QStringList subdirectories;
+};
+
+// Keyed by the path relative to the writable layer root, "" being the root itself
+using DirectoryCache = QHash<QString, DirectoryEntry>;
+
+struct CachedScan {
+    QString upperDir;
+    DirectoryCache directories;
+};
+
+QMutex cacheMutex;
+QHash<QString, CachedScan> scanCache;
+
+qint64 allocatedBytes(const struct stat &st)
+{
+    return qint64(st.st_blocks) * 512;
+}
+
+qint64 modificationTime(const struct stat &st)
+{
+    return qint64(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+}
+
+QString childPath(const QString &relative, const QString &name)
+{
+    return relative.isEmpty() ? name : relative + QLatin1Char('/') + name;
+}
+
+// Whether one of the largest files of a directory was written to since the previous scan.
+// Growing files, e.g. appended logs, do not bump their directory's mtime.
+bool largestFilesChanged(int fd, const QHash<QString, qint64> &largestFiles)
+{
+    for (auto it = largestFiles.cbegin(); it != largestFiles.cend(); ++it) {
+        struct stat st;
+        if (::fstatat(fd, QFile::encodeName(it.key()).constData(), &st, AT_SYMLINK_NOFOLLOW) != 0 || modificationTime(st) != it.value()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reads a single directory level. The listing is reused from the previous scan when the
+// directory mtime did not change and its largest files were not written to, so only a few
+// stat() calls are paid. Small files rewritten in place are picked up once the directory
+// changes again; that trade-off is what keeps rescans cheap.
+bool readDirectory(const QString &root, const QString &relative, const DirectoryCache &previous, DirectoryEntry &entry, qint64 &selfBytes)
+{
+    const QByteArray absolute = QFile::encodeName(relative.isEmpty() ? root : root + QLatin1Char('/') + relative);
+
+    struct stat st;
+    if (::lstat(absolute.constData(), &st) != 0 || !S_ISDIR(st.st_mode)) {
+        return false;
+    }
+
+    selfBytes = allocatedBytes(st);
+    entry.mtime = modificationTime(st);
+
+    DIR *dir = ::opendir(absolute.constData());
+    if (!dir) {
+        return true;
+    }
+    const int fd = ::dirfd(dir);
+
+    const auto cached = previous.constFind(relative);
+    if (cached != previous.cend() && cached->mtime == entry.mtime && !largestFilesChanged(fd, cached->largestFiles)) {
+        entry.fileBytes = cached->fileBytes;
+        entry.largestFiles = cached->largestFiles;
+        entry.subdirectories = cached->subdirectories;
+        ::closedir(dir);
+        return true;
+    }
+
+    struct File {
+        qint64 bytes;
+        qint64 mtime;
+        QString name;
+    };
+    QList<File> files;
+    while (const dirent *item = ::readdir(dir)) {
+        if (qstrcmp(item->d_name, ".") == 0 || qstrcmp(item->d_name, "..") == 0) {
+            continue;
+        }
+
+        struct stat child;
+        if (::fstatat(fd, item->d_name, &child, AT_SYMLINK_NOFOLLOW) != 0) {
+            continue;
+        }
+
+        if (S_ISDIR(child.st_mode)) {
+            entry.subdirectories.append(QFile::decodeName(item->d_name));
+        } else {
+            entry.fileBytes += allocatedBytes(child);
+            files.append({allocatedBytes(child), modificationTime(child), QFile::decodeName(item->d_name)});
+        }
+    }
+    ::closedir(dir);
+
+    const auto largest = files.begin() + std::min<qsizetype>(TrackedFileCount, files.size());
+    std::partial_sort(files.begin(), largest, files.end(), [](const File &a, const File &b) {
+        return a.bytes > b.bytes;
+    });
+    for (auto it = files.begin(); it != largest; ++it) {
+        entry.largestFiles.insert(it->name, it->mtime);
+    }
+
+    return true;
+}
+
+qint64 walkDirectory(const QString &root, const QString &relative, const DirectoryCache &previous, DirectoryCache &fresh)
+{
+    DirectoryEntry entry;
+    qint64 selfBytes = 0;
+    if (!readDirectory(root, relative, previous, entry, selfBytes)) {
+        return 0;
+    }
+
+    qint64 total = selfBytes + entry.fileBytes;
+    for (const QString &name : std::as_const(entry.subdirectories)) {
+        total += walkDirectory(root, childPath(relative, name), previous, fresh);
+    }
+
+    entry.totalBytes = total;
+    fresh.insert(relative, entry);
+    return total;
+}
+
+// Walks the tree with one task per top-level directory on the global thread pool
+DirectoryCache walkTree(const QString &root, const DirectoryCache &previous)
+{
+    DirectoryCache result;
+
+    DirectoryEntry rootEntry;
+    qint64 rootBytes = 0;
+    if (!readDirectory(root, QString(), previous, rootEntry, rootBytes)) {
+        return result;
+    }
+
+    const QList<DirectoryCache> fragments = QtConcurrent::blockingMapped<QList<DirectoryCache>>(rootEntry.subdirectories, [&root, &previous](const QString &name) {
+        DirectoryCache fragment;
+        walkDirectory(root, name, previous, fragment);
+        return fragment;
+    });
+
+    qint64 total = rootBytes + rootEntry.fileBytes;
+    for (const DirectoryCache &fragment : fragments) {
+        for (auto it = fragment.cbegin(); it != fragment.cend(); ++it) {
+            if (!it.key().contains(QLatin1Char('/'))) {
+                total += it->totalBytes;
+            }
+            result.insert(it.key(), it.value());
+        }
+    }
+
+    rootEntry.totalBytes = total;
+    result.insert(QString(), rootEntry);
+    return result;
+}
+
+QString cacheFilePath(const QString &container)
+{
+    const QString cacheBase = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheBase.isEmpty()) {
+        return {};
+    }
+
+    const QString directory = QDir(cacheBase).filePath(u"kontainer/diskusage"_s);
+    QDir().mkpath(directory);
+    return QDir(directory).filePath(container + u".cache"_s);
+}
+
+CachedScan loadCache(const QString &container)
+{
+    CachedScan cached;
+
+    QFile file(cacheFilePath(container));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return cached;
+    }
+
+    QDataStream stream(&file);
+    quint32 version = 0;
+    qint64 count = 0;
+    stream >> version;
+    if (version != CacheVersion) {
+        return cached;
+    }
+
+    stream >> cached.upperDir >> count;
+    for (qint64 i = 0; i < count && stream.status() == QDataStream::Ok; ++i) {
+        QString path;
+        DirectoryEntry entry;
+        stream >> path >> entry.mtime >> entry.fileBytes >> entry.largestFiles >> entry.totalBytes >> entry.subdirectories;
+        cached.directories.insert(path, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return {};
+    }
+
+    return cached;
+}
+
+void storeCache(const QString &container, const CachedScan &cached)
+{
+    QSaveFile file(cacheFilePath(container));
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << CacheVersion << cached.upperDir << qint64(cached.directories.size());
+    for (auto it = cached.directories.cbegin(); it != cached.directories.cend(); ++it) {
+        stream << it.key() << it->mtime << it->fileBytes << it->largestFiles << it->totalBytes << it->subdirectories;
+    }
+    file.commit();
+}
+
+// Picks the largest directories up to a fixed depth. A directory whose biggest child
+// holds most of its bytes is skipped, since the child is the more useful entry to show.
+QList<DiskUsage::DirectoryUsage> largestDirectories(const QHash<QString, qint64> &totals)
+{
+    QHash<QString, qint64> largestChild;
+    for (auto it = totals.cbegin(); it != totals.cend(); ++it) {
+        if (it.key().isEmpty()) {
+            continue;
+        }
+        const QString parent = it.key().contains(QLatin1Char('/')) ? it.key().section(QLatin1Char('/'), 0, -2) : QString();
+        largestChild[parent] = std::max(largestChild.value(parent), it.value());
+    }
+
+    QList<DiskUsage::DirectoryUsage> candidates;
+    for (auto it = totals.cbegin(); it != totals.cend(); ++it) {
+        if (it.key().isEmpty() || it.key().count(QLatin1Char('/')) >= TopDirectoryMaxDepth) {
+            continue;
+        }
+        if (largestChild.value(it.key()) * 10 >= it.value() * 8) {
+            continue;
+        }
+        candidates.append({QLatin1Char('/') + it.key(), it.value()});
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const DiskUsage::DirectoryUsage &a, const DiskUsage::DirectoryUsage &b) {
+        return a.bytes > b.bytes;
+    });
+
+    if (candidates.size() > TopDirectoryCount) {
+        candidates.resize(TopDirectoryCount);
+    }
+    return candidates;
+}
+
+// Used when the storage directory is not visible from here (e.g. inside the Flatpak sandbox)
+bool scanWithHostDu(DiskUsage::Report &report)
+{
+    // du exits with 1 when it meets directories owned by subordinate ids it cannot read, e.g. apt's
+    // partial/. Those are skipped like the host walk skips them, only a killed or broken du fails.
+    const QString script = u"du -x -B1 -d \"$1\" \"$2\" 2>/dev/null; [ $? -le 1 ]"_s;
+    DistroboxCli::Command command(u"sh"_s, {u"-c"_s, script, u"sh"_s, QString::number(TopDirectoryMaxDepth), report.upperDir});
+    command.quiet = true;
+
+    bool success = false;
+    const QString output = DistroboxCli::runCommand(command, success, DistroboxCli::LongTimeoutMs);
+    if (!success || output.isEmpty()) {
+        return false;
+    }
+
+    const QString prefix = report.upperDir + QLatin1Char('/');
+    QHash<QString, qint64> totals;
+    for (const QString &line : output.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+        const qsizetype tab = line.indexOf(QLatin1Char('\t'));
+        if (tab < 0) {
+            continue;
+        }
+
+        const qint64 bytes = line.left(tab).toLongLong();
+        const QString path = line.mid(tab + 1);
+        if (path == report.upperDir) {
+            totals.insert(QString(), bytes);
+        } else if (path.startsWith(prefix)) {
+            totals.insert(path.mid(prefix.size()), bytes);
+        }
+    }
+
+    report.writableBytes = totals.value(QString());
+    report.topDirectories = largestDirectories(totals);
+    return totals.contains(QString());
+}
+}
+
+namespace DiskUsage
+{
+Report scan(const QString &container)
+{
+    Report report;
+    report.container = container;
+
+    const QString manager = DistroboxCli::containerManager();
+    bool success = false;
+    const QString inspect = DistroboxCli::runCommand(
+        DistroboxCli::Command(manager, {u"inspect"_s, u"--type"_s, u"container"_s, u"--format"_s, u"{{.GraphDriver.Data.UpperDir}}|{{.Image}}"_s, container}),
+        success);
+    if (!success) {
+        report.error = i18n("Could not inspect the container %1.", container);
+        return report;
+    }
+
+    const QStringList fields = inspect.trimmed().split(QLatin1Char('|'));
+    report.upperDir = fields.value(0);
+    const QString imageId = fields.value(1);
+
+    if (!imageId.isEmpty()) {
+        const QString size = DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"image"_s, u"inspect"_s, u"--format"_s, u"{{.Size}}"_s, imageId}), success);
+        if (success) {
+            report.imageBytes = size.trimmed().toLongLong();
+        }
+    }
+
+    if (report.upperDir.isEmpty() || report.upperDir == u"<no value>"_s) {
+        report.error = i18n("The storage driver of %1 does not expose a writable layer.", container);
+        return report;
+    }
+
+    if (!QFileInfo(report.upperDir).isDir()) {
+        report.valid = scanWithHostDu(report);
+        if (!report.valid) {
+            report.error = i18n("Could not read the writable layer of %1.", container);
+        }
+        return report;
+    }
+
+    CachedScan previous;
+    {
+        QMutexLocker locker(&cacheMutex);
+        if (!scanCache.contains(container)) {
+            scanCache.insert(container, loadCache(container));
+        }
+        previous = scanCache.value(container);
+    }
+
+    // A re-created container gets a fresh layer, nothing from the old one applies
+    if (previous.upperDir != report.upperDir) {
+        previous = CachedScan{report.upperDir, {}};
+    }
+
+    CachedScan fresh{report.upperDir, walkTree(report.upperDir, previous.directories)};
+
+    QHash<QString, qint64> totals;
+    for (auto it = fresh.directories.cbegin(); it != fresh.directories.cend(); ++it) {
+        if (it.key().count(QLatin1Char('/')) < TopDirectoryMaxDepth) {
+            totals.insert(it.key(), it->totalBytes);
+        }
+    }
+
+    report.writableBytes = totals.value(QString());
+    report.topDirectories = largestDirectories(totals);
+    report.valid = true;
+
+    storeCache(container, fresh);
+    QMutexLocker locker(&cacheMutex);
+    scanCache.insert(container, fresh);
+
+    return report;
+}
+
+QString reportJson(const Report &report)
+{
+    const KFormat format;
+
+    QJsonObject object;
+    object[u"container"_s] = report.container;
+    object[u"valid"_s] = report.valid;
+    object[u"error"_s] = report.error;
+    object[u"writableBytes"_s] = report.writableBytes;
+    object[u"writableSize"_s] = format.formatByteSize(report.writableBytes);
+    object[u"imageBytes"_s] = report.imageBytes;
+    object[u"imageSize"_s] = format.formatByteSize(report.imageBytes);
+
+    QJsonArray directories;
+    for (const DirectoryUsage &directory : report.topDirectories) {
+        QJsonObject entry;
+        entry[u"path"_s] = directory.path;
+        entry[u"bytes"_s] = directory.bytes;
+        entry[u"size"_s] = format.formatByteSize(directory.bytes);
+        directories.append(entry);
+    }
+    object[u"topDirectories"_s] = directories;
+
+    return QString::fromUtf8(QJsonDocument(object).toJson());
+}
+}
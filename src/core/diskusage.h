@@ -0,0 +1,38 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include <QList>
+#include <QString>
+
+namespace DiskUsage
+{
+struct DirectoryUsage {
+    QString path; ///< Path inside the container, e.g. "/var/cache/dnf"
+    qint64 bytes = 0; ///< Cumulative size of the directory in bytes
+};
+
+struct Report {
+    QString container;
+    QString upperDir; ///< Host path of the container's writable overlay layer
+    qint64 writableBytes = 0; ///< Size of the writable layer
+    qint64 imageBytes = 0; ///< Size of the (shared) base image
+    QList<DirectoryUsage> topDirectories; ///< Largest directories of the writable layer
+    QString error;
+    bool valid = false;
+};
+
+/**
+ * Computes the disk usage of a container's writable layer and base image.
+ *
+ * The writable layer is walked directly from the host, one thread per top-level
+ * directory. Directory listings are cached on disk and only re-read for directories
+ * whose mtime, or the mtime of one of their largest files, changed since the previous
+ * scan. Blocking; run it off the GUI thread.
+ */
+Report scan(const QString &container);
+QString reportJson(const Report &report);
+}
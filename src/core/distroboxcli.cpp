@@ -5,12 +5,24 @@
 
 #include "distroboxcli.h"
 
+#include <KFormat>
+#include <KShell>
+#include <QDebug>
+#include <QElapsedTimer>
 #include <QEventLoop>
 #include <QFile>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QMutex>
 #include <QProcess>
+#include <QTimer>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <signal.h>
+#include <unistd.h>
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -20,38 +32,235 @@ bool isFlatpakRuntime()
 {
     return QFile::exists(u"/.flatpak-info"_s);
 }
+
+// env execs the program in place, so a Flatpak still costs only the flatpak-spawn hop.
+// --watch-bus has the host side killed once flatpak-spawn is gone, a SIGKILL cannot be forwarded.
+DistroboxCli::Command hostProcess(const DistroboxCli::Command &command)
+{
+    if (isFlatpakRuntime()) {
+        DistroboxCli::Command spawn(u"flatpak-spawn"_s, QStringList{u"--host"_s, u"--watch-bus"_s, u"/usr/bin/env"_s, command.program} + command.arguments);
+        spawn.quiet = command.quiet;
+        return spawn;
+    }
+    return command;
 }
 
-namespace DistroboxCli
+constexpr int SuperviseIntervalMs = 250;
+constexpr int KillGraceMs = 3000;
+
+struct OperationState {
+    QString command;
+    QElapsedTimer started;
+    QElapsedTimer lastOutput; ///< Guarded by operationsMutex
+    bool quiet = false;
+    std::atomic_bool cancelled{false};
+};
+
+QMutex operationsMutex;
+QHash<quint64, std::shared_ptr<OperationState>> operations;
+quint64 nextOperationId = 1;
+
+// Signals the whole process group. In a Flatpak flatpak-spawn forwards SIGTERM to the host side,
+// after a SIGKILL the host side is killed because flatpak-spawn runs it with --watch-bus.
+void terminateProcessTree(QProcess *process)
 {
-QString runCommand(const QString &command, bool &success)
+    const qint64 pid = process->processId();
+    if (pid <= 0) {
+        return;
+    }
+
+    ::kill(static_cast<pid_t>(-pid), SIGTERM);
+    QTimer::singleShot(KillGraceMs, process, [process, pid]() {
+        if (process->state() != QProcess::NotRunning) {
+            ::kill(static_cast<pid_t>(-pid), SIGKILL);
+        }
+    });
+}
+
+// Starts the process and registers it under the description until it finishes or is destroyed
+void startSupervised(QProcess *process, const DistroboxCli::Command &spawn, const QString &description, int timeoutMs)
 {
-    QString actualCommand = u"/usr/bin/env "_s + command;
+    auto state = std::make_shared<OperationState>();
+    state->command = description;
+    state->quiet = spawn.quiet;
+    state->started.start();
+    state->lastOutput.start();
 
-    if (isFlatpakRuntime()) {
-        actualCommand = u"flatpak-spawn --host /usr/bin/env "_s + command;
+    quint64 id = 0;
+    {
+        QMutexLocker locker(&operationsMutex);
+        id = nextOperationId++;
+        operations.insert(id, state);
     }
 
+    const auto forget = [id]() {
+        QMutexLocker locker(&operationsMutex);
+        operations.remove(id);
+    };
+    const auto touch = [state]() {
+        QMutexLocker locker(&operationsMutex);
+        state->lastOutput.restart();
+    };
+    QObject::connect(process, &QProcess::finished, process, forget);
+    QObject::connect(process, &QObject::destroyed, forget);
+    QObject::connect(process, &QProcess::errorOccurred, process, [forget](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            forget();
+        }
+    });
+    QObject::connect(process, &QProcess::readyReadStandardOutput, process, touch);
+    QObject::connect(process, &QProcess::readyReadStandardError, process, touch);
+
+    // Polls from the thread owning the process, cancelOperation() may be called from any other
+    auto *supervisor = new QTimer(process);
+    supervisor->setInterval(SuperviseIntervalMs);
+    QObject::connect(supervisor, &QTimer::timeout, process, [process, supervisor, state, timeoutMs]() {
+        const bool expired = timeoutMs > 0 && state->started.elapsed() > timeoutMs;
+        if (!expired && !state->cancelled) {
+            return;
+        }
+        qWarning() << (expired ? "Command timed out:" : "Command cancelled:") << state->command;
+        supervisor->stop();
+        terminateProcessTree(process);
+    });
+    QObject::connect(process, &QProcess::started, supervisor, qOverload<>(&QTimer::start));
+
+    process->setChildProcessModifier([]() {
+        ::setpgid(0, 0);
+    });
+    process->start(spawn.program, spawn.arguments);
+}
+
+QString runSupervised(const DistroboxCli::Command &spawn, const QString &description, bool &success, int timeoutMs)
+{
+    success = false;
+
     QString output;
     QProcess process;
-    QObject::connect(&process, &QProcess::finished, [&process, &output, &success](int exitCode, QProcess::ExitStatus) {
+    QEventLoop loop;
+    QObject::connect(&process, &QProcess::finished, &loop, [&process, &output, &success, &loop](int exitCode, QProcess::ExitStatus exitStatus) {
         output = QString::fromUtf8(process.readAllStandardOutput());
-        success = (exitCode == 0);
+        success = exitStatus == QProcess::NormalExit && exitCode == 0;
+        loop.quit();
+    });
+    QObject::connect(&process, &QProcess::errorOccurred, &loop, [&loop](QProcess::ProcessError error) {
+        // finished() is not emitted when the process never started
+        if (error == QProcess::FailedToStart) {
+            loop.quit();
+        }
     });
 
-    QEventLoop loop;
-    QObject::connect(&process, &QProcess::finished, &loop, &QEventLoop::quit);
-
-    process.start(u"sh"_s, QStringList() << QLatin1String("-c") << actualCommand);
-    loop.exec();
+    startSupervised(&process, spawn, description, timeoutMs);
+    if (process.state() != QProcess::NotRunning) {
+        loop.exec();
+    }
 
     return output;
 }
 
+void runSupervisedAsync(const DistroboxCli::Command &spawn,
+                        const QString &description,
+                        QObject *context,
+                        const std::function<void(bool success, const QString &output)> &onFinished,
+                        int timeoutMs)
+{
+    auto *process = new QProcess(context);
+
+    QObject::connect(process, &QProcess::finished, context, [process, onFinished](int exitCode, QProcess::ExitStatus exitStatus) {
+        const QString output = QString::fromUtf8(process->readAllStandardOutput());
+        process->deleteLater();
+        if (onFinished) {
+            onFinished(exitStatus == QProcess::NormalExit && exitCode == 0, output);
+        }
+    });
+    QObject::connect(process, &QProcess::errorOccurred, context, [process, onFinished](QProcess::ProcessError error) {
+        // finished() is not emitted when the process never started
+        if (error != QProcess::FailedToStart) {
+            return;
+        }
+        process->deleteLater();
+        if (onFinished) {
+            onFinished(false, QString());
+        }
+    });
+
+    startSupervised(process, spawn, description, timeoutMs);
+}
+}
+
+namespace DistroboxCli
+{
+Command::Command(const QString &program, const QStringList &arguments)
+    : program(program)
+    , arguments(arguments)
+{
+}
+
+Command &Command::operator<<(const QString &argument)
+{
+    arguments.append(argument);
+    return *this;
+}
+
+Command &Command::operator<<(const QStringList &arguments)
+{
+    this->arguments.append(arguments);
+    return *this;
+}
+
+QString Command::toString() const
+{
+    return KShell::joinArgs(QStringList{program} + arguments);
+}
+
+QString runCommand(const Command &command, bool &success, int timeoutMs)
+{
+    return runSupervised(hostProcess(command), command.toString(), success, timeoutMs);
+}
+
+void runCommandAsync(const Command &command,
+                     QObject *context,
+                     const std::function<void(bool success, const QString &output)> &onFinished,
+                     int timeoutMs)
+{
+    runSupervisedAsync(hostProcess(command), command.toString(), context, onFinished, timeoutMs);
+}
+
+QList<Operation> runningOperations()
+{
+    QMutexLocker locker(&operationsMutex);
+
+    QList<Operation> result;
+    for (auto it = operations.cbegin(); it != operations.cend(); ++it) {
+        result.append(Operation{it.key(), it.value()->command, it.value()->started.elapsed(), it.value()->lastOutput.elapsed(), it.value()->quiet});
+    }
+    std::sort(result.begin(), result.end(), [](const Operation &a, const Operation &b) {
+        return a.id < b.id;
+    });
+    return result;
+}
+
+bool cancelOperation(quint64 id)
+{
+    QMutexLocker locker(&operationsMutex);
+    const auto state = operations.value(id);
+    if (!state) {
+        return false;
+    }
+    state->cancelled = true;
+    return true;
+}
+
+void startCommand(QProcess &process, const Command &command)
+{
+    const Command spawn = hostProcess(command);
+    process.start(spawn.program, spawn.arguments);
+}
+
 AvailableImages availableImages()
 {
     bool success = false;
-    const QString output = runCommand(u"distrobox create -C"_s, success);
+    const QString output = runCommand(Command(u"distrobox"_s, {u"create"_s, u"-C"_s}), success);
     if (!success) {
         return {};
     }
@@ -67,27 +276,95 @@ AvailableImages availableImages()
     return images;
 }
 
-QString containersJson()
+QList<LocalImage> localImages()
 {
     bool success = false;
-    const QString namesOutput = runCommand(u"distrobox list | tail -n +2 | cut -d'|' -f2 | awk '{$1=$1;print}'"_s, success);
+    return localImages(success);
+}
+
+QList<LocalImage> localImages(bool &success)
+{
+    const QString manager = containerManager();
+    QStringList ids = runCommand(Command(manager, {u"images"_s, u"--quiet"_s, u"--no-trunc"_s}), success).split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    ids.removeDuplicates();
+    if (!success || ids.isEmpty()) {
+        return {};
+    }
+
+    const QString format = u"{{.Id}}|{{.Size}}|{{.Created}}|{{join .RepoTags \",\"}}|{{join .RepoDigests \",\"}}"_s;
+    const QString output = runCommand(Command(manager, {u"image"_s, u"inspect"_s, u"--format"_s, format}) << ids, success);
     if (!success) {
-        return u"[]"_s;
+        return {};
     }
 
-    const QString imagesOutput = runCommand(u"distrobox list | tail -n +2 | cut -d'|' -f4 | awk '{$1=$1;print}'"_s, success);
+    QList<LocalImage> images;
+    for (const QString &line : output.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+        const QStringList fields = line.split(QLatin1Char('|'));
+        if (fields.size() < 5) {
+            continue;
+        }
+
+        LocalImage image;
+        image.id = fields[0].trimmed();
+        if (image.id.startsWith(u"sha256:"_s)) {
+            image.id.remove(0, 7);
+        }
+        image.sizeBytes = fields[1].toLongLong();
+
+        // docker prints RFC 3339, podman Go's default "2006-01-02 15:04:05.999999999 -0700 MST"
+        const QString created = fields[2].trimmed();
+        image.created = QDateTime::fromString(created, Qt::ISODateWithMs);
+        if (!image.created.isValid()) {
+            image.created = QDateTime::fromString(created.left(19), u"yyyy-MM-dd HH:mm:ss"_s);
+            const QString offset = created.section(QLatin1Char(' '), 2, 2);
+            if (image.created.isValid() && offset.size() == 5) {
+                const int seconds = (offset.mid(1, 2).toInt() * 60 + offset.mid(3, 2).toInt()) * 60;
+                image.created.setOffsetFromUtc(offset.startsWith(QLatin1Char('-')) ? -seconds : seconds);
+            }
+        }
+
+        image.tags = fields[3].split(QLatin1Char(','), Qt::SkipEmptyParts);
+        const QString digest = fields[4].section(QLatin1Char(','), 0, 0);
+        image.digest = digest.section(QLatin1Char('@'), 1);
+        images.append(image);
+    }
+    return images;
+}
+
+QList<Container> containers()
+{
+    bool success = false;
+    return containers(success);
+}
+
+QList<Container> containers(bool &success)
+{
+    // One listing for both columns, distrobox list queries the container manager every time
+    const QString output = runCommand(Command(u"distrobox"_s, {u"list"_s, u"--no-color"_s}), success);
     if (!success) {
-        return u"[]"_s;
+        return {};
     }
 
-    const QStringList names = namesOutput.split(QChar::fromLatin1('\n'), Qt::SkipEmptyParts);
-    const QStringList images = imagesOutput.split(QChar::fromLatin1('\n'), Qt::SkipEmptyParts);
+    QList<Container> result;
+    const QStringList lines = output.split(QChar::fromLatin1('\n'), Qt::SkipEmptyParts);
+    for (qsizetype i = 1; i < lines.size(); ++i) {
+        const QStringList fields = lines[i].split(QLatin1Char('|'));
+        if (fields.size() < 4) {
+            continue;
+        }
+        result.append(Container{fields[1].trimmed(), fields[3].trimmed()});
+    }
+    return result;
+}
 
+QString containersJson(const QList<Container> &containers, const QHash<QString, int> &pendingUpdates)
+{
     QJsonArray containerArray;
-    for (int i = 0; i < qMin(names.size(), images.size()); ++i) {
+    for (const Container &entry : containers) {
         QJsonObject container;
-        container[u"name"_s] = names[i];
-        container[u"image"_s] = images[i];
+        container[u"name"_s] = entry.name;
+        container[u"image"_s] = entry.image;
+        container[u"pendingUpdates"_s] = pendingUpdates.value(entry.name, -1);
         containerArray.append(container);
     }
 
@@ -100,11 +377,21 @@ QString availableImagesJson(const AvailableImages &images)
         return u"[]"_s;
     }
 
+    const KFormat format;
     QJsonArray imageArray;
     for (int i = 0; i < images.displayNames.size() && i < images.fullNames.size(); ++i) {
         QJsonObject image;
         image[u"display"_s] = images.displayNames[i];
         image[u"full"_s] = images.fullNames[i];
+
+        const LocalImage local = images.localImages.value(i);
+        image[u"local"_s] = local.isValid();
+        if (local.isValid()) {
+            image[u"sizeBytes"_s] = local.sizeBytes;
+            image[u"size"_s] = format.formatByteSize(local.sizeBytes);
+            image[u"created"_s] = local.created.toString(Qt::ISODate);
+            image[u"digest"_s] = local.digest;
+        }
         imageArray.append(image);
     }
 
@@ -115,4 +402,21 @@ bool isFlatpak()
 {
     return isFlatpakRuntime();
 }
+
+QString containerManager()
+{
+    // Same lookup order as distrobox itself: explicit override first, then podman, then docker
+    static const QString manager = [] {
+        const QString configured = qEnvironmentVariable("DBX_CONTAINER_MANAGER");
+        if (configured == u"podman"_s || configured == u"docker"_s) {
+            return configured;
+        }
+
+        // Fails to spawn, or flatpak-spawn fails on the host, when podman is not installed
+        bool success = false;
+        runCommand(Command(u"podman"_s, {u"--version"_s}), success);
+        return success ? u"podman"_s : u"docker"_s;
+    }();
+    return manager;
+}
 }
@@ -5,19 +5,98 @@
 
 #pragma once
 
+#include <QDateTime>
+#include <QHash>
+#include <QList>
 #include <QString>
 #include <QStringList>
+#include <functional>
+
+class QObject;
+class QProcess;
 
 namespace DistroboxCli
 {
+// Image in the local storage of the container manager
+struct LocalImage {
+    QString id; ///< Full image ID without the "sha256:" prefix
+    QStringList tags;
+    QString digest; ///< Repository digest, e.g. "sha256:…", empty for images that were never pushed or pulled
+    qint64 sizeBytes = 0;
+    QDateTime created;
+
+    bool isValid() const
+    {
+        return !id.isEmpty();
+    }
+};
+
 struct AvailableImages {
     QStringList displayNames;
     QStringList fullNames;
+    QList<LocalImage> localImages; ///< Parallel to fullNames when filled, invalid entries are not pulled
+};
+
+struct Container {
+    QString name;
+    QString image;
+};
+
+// Deadline of runCommand(), for queries that answer in seconds
+constexpr int DefaultTimeoutMs = 5 * 60 * 1000;
+// Deadline for the first enter of a container, which runs its whole setup, image pulls and
+// removals, commits, package installs and scans of large trees. The default of runCommandAsync().
+// Real hangs are left to the watchdog's Cancel.
+constexpr int LongTimeoutMs = 2 * 60 * 60 * 1000;
+
+// Program and arguments, spawned on the host without an intermediate shell
+struct Command {
+    explicit Command(const QString &program, const QStringList &arguments = {});
+
+    Command &operator<<(const QString &argument);
+    Command &operator<<(const QStringList &arguments);
+
+    // Shell-quoted form, for logs and for handing to a terminal
+    QString toString() const;
+
+    QString program;
+    QStringList arguments;
+    bool quiet = false; ///< Prints nothing while it works, e.g. commits and scans
+};
+
+struct Operation {
+    quint64 id;
+    QString command;
+    qint64 runningMs;
+    qint64 silentMs; ///< Time since the command last wrote any output
+    bool quiet; ///< Silence says nothing about its progress
 };
 
-QString runCommand(const QString &command, bool &success);
+// Commands run in their own process group, which is terminated once the deadline passes or
+// the operation is cancelled, the command then fails. A timeout of 0 means no deadline.
+QString runCommand(const Command &command, bool &success, int timeoutMs = DefaultTimeoutMs);
+void runCommandAsync(const Command &command,
+                     QObject *context,
+                     const std::function<void(bool success, const QString &output)> &onFinished,
+                     int timeoutMs = LongTimeoutMs);
+// Commands of runCommand() and runCommandAsync() still running, from any thread
+QList<Operation> runningOperations();
+// Terminates the command and everything it started, false if it already finished
+bool cancelOperation(quint64 id);
+// Starts the command on the host like runCommand() does, for callers streaming its stdin or stdout
+void startCommand(QProcess &process, const Command &command);
 AvailableImages availableImages();
-QString containersJson();
+// Every image in local storage, with one listing and one batched inspect
+QList<LocalImage> localImages();
+// Same, success tells an empty image store from a failed listing
+QList<LocalImage> localImages(bool &success);
+QList<Container> containers();
+// Tells an empty list apart from a failed listing
+QList<Container> containers(bool &success);
+// pendingUpdates adds the number of fetched updates of the containers it knows
+QString containersJson(const QList<Container> &containers, const QHash<QString, int> &pendingUpdates = {});
+// Adds presence, size, creation date and digest for the images whose local image is known
 QString availableImagesJson(const AvailableImages &images);
 bool isFlatpak();
+QString containerManager();
 }
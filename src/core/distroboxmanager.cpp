@@ -6,25 +6,53 @@
  */
 
 #include "distroboxmanager.h"
+#include "applistmodel.h"
+#include "assemblemanifest.h"
+#include "assemblerunner.h"
+#include "containerarchive.h"
+#include "containermetadata.h"
+#include "diskusage.h"
 #include "distroboxcli.h"
 #include "distrocolors.h"
+#include "icontheme.h"
+#include "imagereclaim.h"
+#include "launcherentries.h"
+#include "lifecyclepolicy.h"
+#include "operationwatchdog.h"
+#include "packagebatchinstall.h"
+#include "packagecache.h"
 #include "packageinstallcommand.h"
+#include "packageinventory.h"
+#include "registrymirror.h"
+#include "resourcelimits.h"
+#include "templateimages.h"
 #include "terminallauncher.h"
+#include "updateprefetcher.h"
+#include <KConfigGroup>
+#include <KFormat>
 #include <KLocalizedContext>
 #include <KLocalizedString>
+#include <KSharedConfig>
 #include <KShell>
 #include <QByteArray>
+#include <QDate>
 #include <QDebug>
 #include <QDir>
+#include <QEventLoop>
 #include <QFile>
 #include <QFileInfo>
+#include <QFutureWatcher>
 #include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QPointer>
 #include <QRegularExpression>
-#include <QSettings>
+#include <QSet>
 #include <QStandardPaths>
 #include <QTextStream>
-#include <QUrl>
+#include <QtConcurrent>
+#include <algorithm>
 #include <sys/xattr.h>
 #include <QByteArray>
 #include <distroicons.h>
@@ -33,23 +61,14 @@ using namespace Qt::Literals::StringLiterals;
 
 namespace
 {
-QString ensureIconCacheDirectory(const QString &container)
-{
-    const QString cacheBase = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    if (cacheBase.isEmpty()) {
-        return {};
-    }
-
-    QDir cacheDir(cacheBase);
-    const QString iconsRoot = cacheDir.filePath(QStringLiteral("kontainer/icons/%1").arg(container));
-    QDir().mkpath(iconsRoot);
-    return iconsRoot;
-}
+constexpr int DefaultAssembleParallelism = 3;
 
-QString runContainerCommand(const QString &container, const QString &script, bool &success)
+// Entries of every container in one distrobox call on the host, for the Flatpak build
+bool generateAllEntriesOnHost()
 {
-    const QString command = u"distrobox enter %1 -- sh -c %2"_s.arg(container, KShell::quoteArg(script));
-    return DistroboxCli::runCommand(command, success);
+    bool success = false;
+    DistroboxCli::runCommand(DistroboxCli::Command(u"distrobox"_s, {u"generate-entry"_s, u"-a"_s}), success, DistroboxCli::LongTimeoutMs);
+    return success;
 }
 
 static QString resolveDocumentPortalPath(const QString &path)
@@ -73,156 +92,125 @@ static QString resolveDocumentPortalPath(const QString &path)
     return path;
 }
 
-QString resolveIconPathInContainer(const QString &container, const QString &iconValue)
+// Strips a file:// prefix and resolves paths handed out by the document portal
+static QString localArchivePath(const QString &fileUrl)
 {
-    if (iconValue.trimmed().isEmpty()) {
-        return {};
-    }
-
-    const QString pythonScript = QStringLiteral(
-                                     "python3 - %1 <<'PY'\n"
-                                     "import os, sys\n"
-                                     "icon = sys.argv[1]\n"
-                                     "if not icon:\n"
-                                     "    raise SystemExit(1)\n"
-                                     "if os.path.isabs(icon) and os.path.exists(icon):\n"
-                                     "    print(icon, end=\"\")\n"
-                                     "    raise SystemExit(0)\n"
-                                     "search_dirs = [\"/usr/share/icons\", \"/usr/local/share/icons\", \"/usr/share/pixmaps\", \"/usr/share/applications\", "
-                                     "\"/usr/share/icons/hicolor\"]\n"
-                                     "extensions = [\".png\", \".svg\", \".xpm\", \".jpg\", \".jpeg\", \".ico\"]\n"
-                                     "icon_path, icon_base = os.path.split(icon)\n"
-                                     "if not icon_base:\n"
-                                     "    icon_base = icon\n"
-                                     "    icon_path = ''\n"
-                                     "base, suffix = os.path.splitext(icon_base)\n"
-                                     "if suffix:\n"
-                                     "    candidates = [icon_base]\n"
-                                     "else:\n"
-                                     "    candidates = [icon_base + ext for ext in extensions]\n"
-                                     "candidate_dirs = []\n"
-                                     "if icon_path and icon_path != '.':\n"
-                                     "    for root in search_dirs:\n"
-                                     "        candidate_dir = os.path.join(root, icon_path)\n"
-                                     "        if os.path.isdir(candidate_dir):\n"
-                                     "            candidate_dirs.append(candidate_dir)\n"
-                                     "else:\n"
-                                     "    candidate_dirs.extend([d for d in search_dirs if os.path.isdir(d)])\n"
-                                     "for directory in candidate_dirs:\n"
-                                     "    for candidate in candidates:\n"
-                                     "        candidate_path = os.path.join(directory, candidate)\n"
-                                     "        if os.path.exists(candidate_path):\n"
-                                     "            print(candidate_path, end=\"\")\n"
-                                     "            raise SystemExit(0)\n"
-                                     "for directory in search_dirs:\n"
-                                     "    if not os.path.isdir(directory):\n"
-                                     "        continue\n"
-                                     "    for root, _, files in os.walk(directory):\n"
-                                     "        for candidate in candidates:\n"
-                                     "            if candidate in files:\n"
-                                     "                print(os.path.join(root, candidate), end=\"\")\n"
-                                     "                raise SystemExit(0)\n"
-                                     "print('', end=\"\")\n"
-                                     "raise SystemExit(1)\n"
-                                     "PY")
-                                     .arg(KShell::quoteArg(iconValue));
-
-    bool success = false;
-    const QString output = runContainerCommand(container, pythonScript, success);
-    if (!success) {
-        return {};
+    QString path = fileUrl.trimmed();
+    if (path.startsWith(u"file://"_s)) {
+        path = path.mid(7);
     }
-
-    return output.trimmed();
+    return resolveDocumentPortalPath(path);
 }
 
-QString cacheIconFromContainer(const QString &container, const QString &basename, const QString &iconValue)
+// The extra create arguments are typed in shell syntax, split them the same way without running a shell.
+// Returns why they were rejected, or an empty string.
+static QString splitCreateArguments(const QString &args, QStringList &extraArgs)
 {
-    static QHash<QString, QString> iconCache;
-
-    const QString cacheKey = container + QLatin1Char('|') + iconValue;
-    if (iconCache.contains(cacheKey)) {
-        return iconCache.value(cacheKey);
-    }
-
-    const QString iconPath = resolveIconPathInContainer(container, iconValue);
-    if (iconPath.isEmpty()) {
-        iconCache.insert(cacheKey, QString());
-        return {};
-    }
-
-    const QString cacheDirectory = ensureIconCacheDirectory(container);
-    if (cacheDirectory.isEmpty()) {
-        iconCache.insert(cacheKey, QString());
+    KShell::Errors splitError = KShell::NoError;
+    extraArgs = KShell::splitArgs(args, KShell::TildeExpand | KShell::AbortOnMeta, &splitError);
+    switch (splitError) {
+    case KShell::NoError:
         return {};
+    case KShell::BadQuoting:
+        return i18n("The additional arguments have unbalanced quotes.");
+    case KShell::FoundMeta:
+        return i18n("The additional arguments contain shell operators such as |, ;, &, $( ) or redirections. They are passed to distrobox without a shell, "
+                    "quote them if they are meant literally.");
     }
-
-    const QFileInfo iconInfo(iconPath);
-    QString localName = basename;
-    if (localName.isEmpty()) {
-        localName = iconInfo.completeBaseName();
-    }
-
-    QString suffix = iconInfo.suffix();
-    if (suffix.isEmpty()) {
-        suffix = QStringLiteral("png");
-    }
-
-    const QString localPath = QDir(cacheDirectory).filePath(localName + QLatin1Char('.') + suffix);
-
-    if (!QFile::exists(localPath)) {
-        const QString pythonScript = QStringLiteral(
-                                         "python3 - %1 <<'PY'\n"
-                                         "import base64, sys\n"
-                                         "path = sys.argv[1]\n"
-                                         "with open(path, 'rb') as handler:\n"
-                                         "    data = handler.read()\n"
-                                         "    print(base64.b64encode(data).decode('ascii'), end=\"\")\n"
-                                         "PY")
-                                         .arg(KShell::quoteArg(iconPath));
-
-        bool success = false;
-        const QString base64Data = runContainerCommand(container, pythonScript, success);
-        if (!success || base64Data.isEmpty()) {
-            iconCache.insert(cacheKey, QString());
-            return {};
-        }
-
-        const QByteArray binaryData = QByteArray::fromBase64(base64Data.trimmed().toUtf8());
-        if (binaryData.isEmpty()) {
-            iconCache.insert(cacheKey, QString());
-            return {};
-        }
-
-        QFile localFile(localPath);
-        if (!localFile.open(QIODevice::WriteOnly)) {
-            iconCache.insert(cacheKey, QString());
-            return {};
-        }
-
-        localFile.write(binaryData);
-        localFile.close();
-    }
-
-    const QString url = QUrl::fromLocalFile(localPath).toString();
-    iconCache.insert(cacheKey, url);
-    return url;
+    return {};
 }
 }
 
 // Constructor: Initializes the manager and populates available images lists
 DistroboxManager::DistroboxManager(QObject *parent)
     : QObject(parent)
+    , m_lifecyclePolicy(new LifecyclePolicy(this))
+    , m_packageInventory(new PackageInventory(this))
+    , m_packageBatchInstall(new PackageBatchInstall(this))
+    , m_assembleRunner(new AssembleRunner(this))
+    , m_updatePrefetcher(new UpdatePrefetcher(this))
+    , m_containerArchive(new ContainerArchive(this))
+    , m_operationWatchdog(new OperationWatchdog(this))
 {
     const auto images = DistroboxCli::availableImages();
     m_availableImages = images.displayNames;
     m_fullImageNames = images.fullNames;
+
+    // Upgrades since the last session may have grown the shared package caches past their budget
+    PackageCache::pruneInBackground();
+
+    connect(m_lifecyclePolicy, &LifecyclePolicy::containerStarted, this, [this](const QString &name) {
+        Q_EMIT containerStateChanged(name, true);
+    });
+    connect(m_lifecyclePolicy, &LifecyclePolicy::containerStopped, this, [this](const QString &name) {
+        Q_EMIT containerStateChanged(name, false);
+    });
+
+    connect(m_packageInventory, &PackageInventory::refreshed, this, &DistroboxManager::packageInventoryRefreshed);
+    connect(m_updatePrefetcher, &UpdatePrefetcher::pendingUpdatesChanged, this, &DistroboxManager::pendingUpdatesChanged);
+
+    connect(m_containerArchive, &ContainerArchive::stageChanged, this, &DistroboxManager::archiveStageChanged);
+    connect(m_containerArchive, &ContainerArchive::progress, this, [this](qint64 processed, qint64 total, qint64 bytesPerSecond) {
+        const KFormat format;
+        const QString rate = format.formatByteSize(bytesPerSecond);
+        if (total <= 0) {
+            Q_EMIT archiveProgress(-1, i18n("%1 at %2/s", format.formatByteSize(processed), rate));
+            return;
+        }
+        // Saved image streams run slightly over the size the image reports
+        const int percent = static_cast<int>(std::min<qint64>(processed * 100 / total, 99));
+        Q_EMIT archiveProgress(percent, i18n("%1 of %2 at %3/s", format.formatByteSize(processed), format.formatByteSize(total), rate));
+    });
+    connect(m_containerArchive, &ContainerArchive::finished, this, &DistroboxManager::archiveFinished);
+
+    connect(m_operationWatchdog, &OperationWatchdog::stalledOperationsChanged, this, [this]() {
+        Q_EMIT stalledOperationsChanged(stalledOperations());
+    });
+
+    connect(m_assembleRunner, &AssembleRunner::sectionProgress, this, [this](const QString &section, AssembleRunner::State state, const QString &detail) {
+        Q_EMIT containerAssembleProgress(section, AssembleRunner::stateName(state), detail);
+    });
+    connect(m_assembleRunner, &AssembleRunner::finished, this, [this](bool success) {
+        Q_EMIT containerAssembleFinished(success, QString());
+    });
+
+    connect(m_packageBatchInstall,
+            &PackageBatchInstall::progress,
+            this,
+            [this](const QString &container, PackageBatchInstall::State state, int completed, int total) {
+                Q_EMIT packageInstallProgress(container, PackageBatchInstall::stateName(state), completed, total);
+            });
+    connect(m_packageBatchInstall, &PackageBatchInstall::finished, this, [this](bool success) {
+        QJsonArray results;
+        for (const PackageBatchInstall::Result &result : m_packageBatchInstall->results()) {
+            QJsonObject entry;
+            entry[u"container"_s] = result.container;
+            entry[u"state"_s] = PackageBatchInstall::stateName(result.state);
+            entry[u"output"_s] = result.output;
+            results.append(entry);
+        }
+        Q_EMIT packageInstallFinished(success, QString::fromUtf8(QJsonDocument(results).toJson()));
+
+        // The inventory picks up the new packages through the changed database stamps
+        if (success) {
+            m_packageInventory->refresh(DistroboxCli::containers());
+        }
+    });
+
 }
 
 // Lists all existing containers and their base images in JSON format
 QString DistroboxManager::listContainers()
 {
-    return DistroboxCli::containersJson();
+    const QList<DistroboxCli::Container> containers = DistroboxCli::containers();
+
+    QStringList names;
+    for (const DistroboxCli::Container &container : containers) {
+        names.append(container.name);
+    }
+    ContainerMetadata::prefetch(names);
+
+    return DistroboxCli::containersJson(containers, m_updatePrefetcher->pendingUpdates());
 }
 
 // Lists all available container images in JSON format
@@ -234,37 +222,134 @@ QString DistroboxManager::listAvailableImages()
         m_fullImageNames = images.fullNames;
     }
 
-    return DistroboxCli::availableImagesJson(DistroboxCli::AvailableImages{m_availableImages, m_fullImageNames});
+    // Templates first, they are what a new container is most likely based on
+    DistroboxCli::AvailableImages images;
+    for (const TemplateImages::Template &entry : TemplateImages::tracked()) {
+        images.displayNames.append(entry.sourceContainer.isEmpty() ? i18n("%1 (template)", entry.name)
+                                                                   : i18n("%1 (template of %2)", entry.name, entry.sourceContainer));
+        images.fullNames.append(entry.image);
+    }
+    images.displayNames += m_availableImages;
+    images.fullNames += m_fullImageNames;
+
+    // Joined on every call, pulls and removals happen outside of Kontainer too
+    QHash<QString, DistroboxCli::LocalImage> localByReference;
+    for (const DistroboxCli::LocalImage &local : DistroboxCli::localImages()) {
+        for (const QString &tag : local.tags) {
+            localByReference.insert(RegistryMirror::normalizedReference(tag), local);
+        }
+    }
+
+    // Pulled images first since they create in seconds, otherwise in catalogue order
+    QList<int> order;
+    for (int i = 0; i < images.fullNames.size(); ++i) {
+        order.append(i);
+        images.localImages.append(localByReference.value(RegistryMirror::normalizedReference(images.fullNames[i])));
+    }
+    std::stable_sort(order.begin(), order.end(), [&images](int a, int b) {
+        return images.localImages[a].isValid() && !images.localImages[b].isValid();
+    });
+
+    DistroboxCli::AvailableImages sorted;
+    for (int i : std::as_const(order)) {
+        sorted.displayNames.append(images.displayNames.value(i));
+        sorted.fullNames.append(images.fullNames[i]);
+        sorted.localImages.append(images.localImages[i]);
+    }
+    return DistroboxCli::availableImagesJson(sorted);
 }
 
 // Creates a new container with specified name and base image
-bool DistroboxManager::createContainer(const QString &name, const QString &image, const QString &args)
+bool DistroboxManager::createContainer(const QString &name, const QString &image, const QString &args, bool sharePackageCache, const QString &limitsPreset)
 {
     // Construct distrobox create command
-    QString command = u"distrobox create --name %1 --image %2 --yes"_s.arg(name, image);
+    DistroboxCli::Command command(u"distrobox"_s, {u"create"_s, u"--name"_s, name, u"--image"_s, image, u"--yes"_s});
+    if (sharePackageCache) {
+        command << PackageCache::createArguments(PackageInstallCommand::packageManagerForImage(image));
+    }
     if (!args.isEmpty()) {
-        command += QLatin1Char(' ') + args;
+        QStringList extraArgs;
+        const QString error = splitCreateArguments(args, extraArgs);
+        if (!error.isEmpty()) {
+            qWarning() << "Rejected extra create arguments:" << args << error;
+            return false;
+        }
+        command << extraArgs;
+    }
+    command.arguments = PackageCache::mergeInitHooks(command.arguments);
+
+    const bool rootful = command.arguments.contains(u"--root"_s) || command.arguments.contains(u"-r"_s);
+    const QStringList limitFlags = ResourceLimits::createFlags(ResourceLimits::preset(limitsPreset), ResourceLimits::delegatedControllers(rootful));
+    if (!limitFlags.isEmpty()) {
+        // distrobox appends repeated --additional-flags, the user's own ones are kept
+        command << u"--additional-flags"_s << limitFlags.join(QLatin1Char(' '));
     }
 
+    // Rootful containers use the root image store, distrobox pulls those itself
+    // The pull may have to start the local mirror first, it runs on the pool while the event loop
+    // keeps turning, the same way the commands below wait
+    if (!rootful) {
+        QFutureWatcher<RegistryMirror::PullSource> watcher;
+        QEventLoop loop;
+        connect(&watcher, &QFutureWatcher<RegistryMirror::PullSource>::finished, &loop, &QEventLoop::quit);
+        watcher.setFuture(QtConcurrent::run([settings = RegistryMirror::settings(), image]() {
+            return RegistryMirror::prepareImage(settings, image);
+        }));
+        if (!watcher.isFinished()) {
+            loop.exec();
+        }
+    }
+    ImageReclaim::rememberImages({image});
+
     bool success;
-    DistroboxCli::runCommand(command, success);
+    DistroboxCli::runCommand(command, success, DistroboxCli::LongTimeoutMs);
+    if (success && sharePackageCache) {
+        PackageCache::pruneInBackground();
+    }
     return success;
 }
 
+QString DistroboxManager::createArgumentsError(const QString &args)
+{
+    QStringList extraArgs;
+    return splitCreateArguments(args, extraArgs);
+}
+
+QString DistroboxManager::packageCacheFamily(const QString &image)
+{
+    return PackageCache::familyName(PackageInstallCommand::packageManagerForImage(image));
+}
+
 // Opens an interactive shell in the specified container
 bool DistroboxManager::enterContainer(const QString &name)
 {
-    const QString command = u"distrobox enter %1"_s.arg(name);
-    return launchCommandInTerminal(command);
+    return launchCommandInTerminal(DistroboxCli::Command(u"distrobox"_s, {u"enter"_s, name}).toString());
 }
 
 // Removes a container
 bool DistroboxManager::removeContainer(const QString &name)
 {
+    // The image is remembered by ID, so it is offered for reclaiming even once it lost its tag
+    bool inspected = false;
+    const QString imageId = DistroboxCli::runCommand(
+                                DistroboxCli::Command(DistroboxCli::containerManager(), {u"inspect"_s, u"--type"_s, u"container"_s, u"--format"_s, u"{{.Image}}"_s, name}),
+                                inspected)
+                                .trimmed();
+
     // Use -f flag to force removal without confirmation
-    QString command = u"distrobox rm -f %1"_s.arg(name);
     bool success;
-    DistroboxCli::runCommand(command, success);
+    DistroboxCli::runCommand(DistroboxCli::Command(u"distrobox"_s, {u"rm"_s, u"-f"_s, name}), success);
+    if (success) {
+        if (inspected && !imageId.isEmpty()) {
+            ImageReclaim::rememberImages({imageId});
+        }
+        // Drop the policy so a future container with the same name starts clean
+        m_lifecyclePolicy->setPolicy(name, {});
+        ContainerMetadata::forget(name);
+        AppCatalog::forget(name);
+        IconTheme::forget(name);
+        m_updatePrefetcher->forget(name);
+    }
     return success;
 }
 
@@ -278,10 +363,9 @@ bool DistroboxManager::cloneContainer(const QString &sourceName, const QString &
         return false;
     }
 
-    QString message = i18n("Press any key to close this terminal…");
-    QString cloneCmd =
-        u"distrobox-stop %1 -Y && distrobox create --clone %1 --name %2 && echo '' && echo '%3' && read -s -n 1"_s.arg(trimmedSource, trimmedClone, message);
-    QString command = u"sh -c \"%1\""_s.arg(cloneCmd);
+    // The names travel as positional parameters, the exit status of the clone is kept past the prompt
+    const QString script = u"distrobox-stop \"$1\" -Y && distrobox create --clone \"$1\" --name \"$2\"; status=$?; echo ''; echo \"$3\"; read -s -n 1; exit $status"_s;
+    const DistroboxCli::Command command(u"sh"_s, {u"-c"_s, script, u"sh"_s, trimmedSource, trimmedClone, i18n("Press any key to close this terminal…")});
     QPointer<DistroboxManager> self(this);
     auto callback = [self, trimmedClone](bool success) {
         if (!self) {
@@ -290,11 +374,62 @@ bool DistroboxManager::cloneContainer(const QString &sourceName, const QString &
         Q_EMIT self->containerCloneFinished(trimmedClone, success);
     };
 
-    return launchCommandInTerminal(command, QDir::homePath(), callback);
+    return launchCommandInTerminal(command.toString(), QDir::homePath(), callback);
+}
+
+// Clone a running container: commit its writable layer to an image, then create the clone from it.
+// Unlike distrobox create --clone the source is never stopped, and it is only paused on request.
+bool DistroboxManager::snapshotCloneContainer(const QString &sourceName, const QString &cloneName, bool pauseSource)
+{
+    const QString trimmedSource = sourceName.trimmed();
+    const QString trimmedClone = cloneName.trimmed();
+
+    if (trimmedSource.isEmpty() || trimmedClone.isEmpty()) {
+        return false;
+    }
+
+    // Same tagging scheme as distrobox uses for its clone images, image names must be lowercase
+    const QString snapshotImage = u"%1:%2"_s.arg(trimmedClone.toLower(), QDate::currentDate().toString(u"yyyy-MM-dd"_s));
+    DistroboxCli::Command commitCmd(DistroboxCli::containerManager(),
+                                   {u"container"_s, u"commit"_s, pauseSource ? u"--pause=true"_s : u"--pause=false"_s, trimmedSource, snapshotImage});
+    commitCmd.quiet = true;
+
+    Q_EMIT containerCloneProgress(trimmedClone, 0, i18n("Taking a snapshot of %1…", trimmedSource));
+
+    QPointer<DistroboxManager> self(this);
+    DistroboxCli::runCommandAsync(commitCmd, this, [self, trimmedClone, snapshotImage](bool committed, const QString &) {
+        if (!self) {
+            return;
+        }
+        if (!committed) {
+            Q_EMIT self->containerCloneFinished(trimmedClone, false);
+            return;
+        }
+        ImageReclaim::rememberImages({snapshotImage});
+
+        Q_EMIT self->containerCloneProgress(trimmedClone, 50, i18n("Creating %1 from the snapshot…", trimmedClone));
+
+        const DistroboxCli::Command createCmd(u"distrobox"_s, {u"create"_s, u"--name"_s, trimmedClone, u"--image"_s, snapshotImage, u"--yes"_s});
+        DistroboxCli::runCommandAsync(createCmd, self.data(), [self, trimmedClone, snapshotImage](bool created, const QString &) {
+            if (!self) {
+                return;
+            }
+            if (!created) {
+                // Only the clone uses the snapshot, do not leave it behind. Without --force, so
+                // it stays if a partly created clone still references it.
+                DistroboxCli::runCommandAsync(DistroboxCli::Command(DistroboxCli::containerManager(), {u"rmi"_s, snapshotImage}), self.data(), nullptr);
+            } else {
+                Q_EMIT self->containerCloneProgress(trimmedClone, 100, i18n("Clone finished"));
+            }
+            Q_EMIT self->containerCloneFinished(trimmedClone, created);
+        });
+    });
+
+    return true;
 }
 
 // Assemble a container from an .ini File
-bool DistroboxManager::assembleContainer(const QString &iniFile)
+bool DistroboxManager::assembleContainer(const QString &iniFile, int maxParallel)
 {
     QString trimmedFile = iniFile.trimmed();
     if (trimmedFile.isEmpty()) {
@@ -308,40 +443,79 @@ bool DistroboxManager::assembleContainer(const QString &iniFile)
     // Resolve potential portal FUSE path to actual host path
     trimmedFile = resolveDocumentPortalPath(trimmedFile);
 
-    QString message = i18n("Press any key to close this terminal…");
+    QList<AssembleManifest::Section> sections;
+    QString error;
+    if (!AssembleManifest::parse(trimmedFile, sections, error)) {
+        qWarning() << "Cannot assemble" << trimmedFile << ":" << error;
+        Q_EMIT containerAssembleFinished(false, error);
+        return false;
+    }
 
-    QString assembleCmd = u"distrobox assemble create --file %1 && echo '' && echo '%2' && read -s -n 1"_s
-    .arg(trimmedFile, message);
+    KConfigGroup group(KSharedConfig::openConfig(), u"Assemble"_s);
+    if (maxParallel > 0) {
+        group.writeEntry("MaxParallel", maxParallel);
+        group.sync();
+    } else {
+        maxParallel = group.readEntry("MaxParallel", DefaultAssembleParallelism);
+    }
 
-    QString command = u"sh -c \"%1\""_s.arg(assembleCmd);
+    QStringList names;
+    for (const AssembleManifest::Section &section : std::as_const(sections)) {
+        names.append(section.name);
+    }
+    Q_EMIT containerAssembleStarted(names);
 
-    QPointer<DistroboxManager> self(this);
-    auto callback = [self](bool success) {
-        if (!self)
-            return;
-        Q_EMIT self->containerAssembleFinished(success);
-    };
+    return m_assembleRunner->start(trimmedFile, sections, maxParallel);
+}
 
-    return launchCommandInTerminal(command, QDir::homePath(), callback);
+int DistroboxManager::assembleParallelism() const
+{
+    return KConfigGroup(KSharedConfig::openConfig(), u"Assemble"_s).readEntry("MaxParallel", DefaultAssembleParallelism);
 }
 
 // Upgrades all packages in a container
 bool DistroboxManager::upgradeContainer(const QString &name)
 {
     QString message = i18n("Press any key to close this terminal…");
-    QString upgradeCmd = u"distrobox upgrade %1 && echo '' && echo '%2' && read -s -n 1"_s.arg(name, message);
-    QString command = u"sh -c \"%1\""_s.arg(upgradeCmd);
 
-    return launchCommandInTerminal(command);
+    // Updates fetched in the background only need installing, a full upgrade is the fallback
+    const auto applyCmd = m_updatePrefetcher->applyCommand(name);
+    if (applyCmd) {
+        // The exit status of the upgrade is kept past the prompt, so it is what the terminal reports
+        const QString script = u"distrobox enter \"$1\" -- sh -c \"$2\" || distrobox upgrade \"$1\"; status=$?; echo ''; echo \"$3\"; read -s -n 1; exit $status"_s;
+        const DistroboxCli::Command command(u"sh"_s, {u"-c"_s, script, u"sh"_s, name, *applyCmd, message});
+
+        QPointer<DistroboxManager> self(this);
+        return launchCommandInTerminal(command.toString(), QDir::homePath(), [self, name](bool success) {
+            // A failed or aborted upgrade leaves the fetched updates pending
+            if (self && success) {
+                self->m_updatePrefetcher->markApplied(name);
+            }
+        });
+    }
+
+    const QString script = u"distrobox upgrade \"$1\" && echo '' && echo \"$2\" && read -s -n 1"_s;
+    return launchCommandInTerminal(DistroboxCli::Command(u"sh"_s, {u"-c"_s, script, u"sh"_s, name, message}).toString());
 }
 
 bool DistroboxManager::upgradeAllContainer()
 {
     QString message = i18n("Press any key to close this terminal…");
-    QString upgradeCmd = u"distrobox upgrade --all && echo '' && echo '%1' && read -s -n 1"_s.arg(message);
-    QString command = u"sh -c \"%1\""_s.arg(upgradeCmd);
+    const QString script = u"distrobox upgrade --all; status=$?; echo ''; echo \"$1\"; read -s -n 1; exit $status"_s;
+    const DistroboxCli::Command command(u"sh"_s, {u"-c"_s, script, u"sh"_s, message});
 
-    return launchCommandInTerminal(command);
+    QPointer<DistroboxManager> self(this);
+    return launchCommandInTerminal(command.toString(), QDir::homePath(), [self](bool success) {
+        if (!self || !success) {
+            return;
+        }
+        const QHash<QString, int> pending = self->m_updatePrefetcher->pendingUpdates();
+        for (auto it = pending.cbegin(); it != pending.cend(); ++it) {
+            if (it.value() > 0) {
+                self->m_updatePrefetcher->markApplied(it.key());
+            }
+        }
+    });
 }
 
 bool DistroboxManager::launchCommandInTerminal(const QString &command, const QString &workingDirectory, const std::function<void(bool)> &onFinished)
@@ -350,8 +524,14 @@ bool DistroboxManager::launchCommandInTerminal(const QString &command, const QSt
 }
 
 // Returns a color associated with the distribution for UI purposes
-QString DistroboxManager::getDistroColor(const QString &image)
+QString DistroboxManager::getDistroColor(const QString &image, const QString &container)
 {
+    // Only what is already known, this is called while painting
+    if (!container.isEmpty()) {
+        if (const auto metadata = ContainerMetadata::cached(container)) {
+            return DistroColors::colorForDistribution(QStringList{metadata->osId} + metadata->osIdLike, image);
+        }
+    }
     return DistroColors::colorForImage(image);
 }
 
@@ -361,21 +541,50 @@ QString DistroboxManager::getDistroIcon(const QString &container)
     return DistroIcons::resolveDistroboxIcon(container);
 }
 
-// Generates .desktop files for applications in containers
+// Generates the launcher entries of containers
 bool DistroboxManager::generateEntry(const QString &name)
 {
-    QString command;
-    if (name.isEmpty()) {
-        // Generate entries for all containers
-        command = u"distrobox generate-entry -a"_s;
-    } else {
-        // Generate entries for specific container
-        command = u"distrobox generate-entry %1"_s.arg(name);
+    if (!name.isEmpty()) {
+        return generateEntries({name});
+    }
+    if (DistroboxCli::isFlatpak()) {
+        return generateAllEntriesOnHost();
     }
 
-    bool success;
-    DistroboxCli::runCommand(command, success);
-    return success;
+    QStringList names;
+    for (const DistroboxCli::Container &container : DistroboxCli::containers()) {
+        names.append(container.name);
+    }
+    return generateEntries(names);
+}
+
+bool DistroboxManager::generateEntries(const QStringList &names)
+{
+    if (DistroboxCli::isFlatpak()) {
+        // The sandbox cannot write to the host applications directory, distrobox does it on the host.
+        // One call covering every container costs a single flatpak-spawn hop instead of one each.
+        if (names.size() > 1) {
+            const QSet<QString> selected(names.cbegin(), names.cend());
+            const QList<DistroboxCli::Container> containers = DistroboxCli::containers();
+            const bool everyContainer = !containers.isEmpty() && std::all_of(containers.cbegin(), containers.cend(), [&selected](const DistroboxCli::Container &container) {
+                return selected.contains(container.name);
+            });
+            if (everyContainer) {
+                return generateAllEntriesOnHost();
+            }
+        }
+
+        DistroboxCli::Command command(u"distrobox"_s, {u"generate-entry"_s});
+        bool success = true;
+        for (const QString &name : names) {
+            bool generated = false;
+            DistroboxCli::runCommand(DistroboxCli::Command(command) << name, generated);
+            success = success && generated;
+        }
+        return success;
+    }
+
+    return LauncherEntries::generate(names);
 }
 
 // Installs a Package File with the Containers Package Manager
@@ -393,211 +602,433 @@ bool DistroboxManager::installPackageInContainer(const QString &name, const QStr
     // Resolve document portal FUSE path to host path if needed
     actualPackagePath = resolveDocumentPortalPath(actualPackagePath);
 
-    const auto installCmd = PackageInstallCommand::forImage(image, actualPackagePath);
+    const auto installCmd = PackageInstallCommand::forPackageManager(ContainerMetadata::packageManager(name, image), actualPackagePath);
     if (!installCmd) {
         const QString message = i18n(
             "Cannot automatically install packages for this distribution.\n"
             "Please enter the distrobox manually and install it using the appropriate package manager.");
 
-        // Escape single quotes for embedding inside double quotes
-        QString safeMessage = message;
-        safeMessage.replace(u"'"_s, u"'\\''"_s);
+        // The message travels as a positional parameter, so it needs no escaping
+        const QString script = u"echo \"$1\"; read -n 1 -s -r -p 'Press any key to continue...'"_s;
+        return launchCommandInTerminal(DistroboxCli::Command(u"bash"_s, {u"-c"_s, script, u"bash"_s, message}).toString(), homeDir);
+    }
+
+    // The install command quotes the package path itself
+    const QString script = *installCmd + u" && echo && echo \"$1\" && read -s -n 1"_s;
+    const DistroboxCli::Command command(u"distrobox"_s,
+                                       {u"enter"_s, name, u"--"_s, u"/usr/bin/env"_s, u"bash"_s, u"-c"_s, script, u"bash"_s, i18n("Press any key to close this terminal…")});
+    return launchCommandInTerminal(command.toString(), homeDir);
+}
+
+// Scans the container's writable layer off the GUI thread
+bool DistroboxManager::scanDiskUsage(const QString &name)
+{
+    const QString trimmedName = name.trimmed();
+    if (trimmedName.isEmpty()) {
+        return false;
+    }
+
+    auto *watcher = new QFutureWatcher<DiskUsage::Report>(this);
+    connect(watcher, &QFutureWatcher<DiskUsage::Report>::finished, this, [this, watcher, trimmedName]() {
+        watcher->deleteLater();
+        Q_EMIT diskUsageReady(trimmedName, DiskUsage::reportJson(watcher->result()));
+    });
+    watcher->setFuture(QtConcurrent::run([trimmedName]() {
+        return DiskUsage::scan(trimmedName);
+    }));
 
-        // Use consistent quoting style as the install path
-        const QString script = QStringLiteral("echo '%1'; read -n 1 -s -r -p \'Press any key to continue...\'").arg(safeMessage);
+    return true;
+}
 
-        // Bash -c in double quotes to avoid nested single-quote issues
-        const QString command = QStringLiteral("bash -c \"%1\"").arg(script);
+// Dry run of the image reclaim off the GUI thread: what would be removed and how much it frees
+bool DistroboxManager::previewImageReclaim()
+{
+    auto *watcher = new QFutureWatcher<ImageReclaim::Plan>(this);
+    connect(watcher, &QFutureWatcher<ImageReclaim::Plan>::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        const ImageReclaim::Plan plan = watcher->result();
+        // Images of the current distrobox containers stay known after the containers are gone
+        ImageReclaim::rememberImages(plan.distroboxImages);
+        Q_EMIT imageReclaimPreviewReady(ImageReclaim::planJson(plan));
+    });
+    // The configuration is read here, on the GUI thread
+    watcher->setFuture(QtConcurrent::run([keptImages = ImageReclaim::keptImages(), knownImages = ImageReclaim::knownImages()]() {
+        return ImageReclaim::plan(keptImages, knownImages);
+    }));
+
+    return true;
+}
 
-        return launchCommandInTerminal(command, homeDir);
+// Removes the selected unused images off the GUI thread
+bool DistroboxManager::reclaimImages(const QStringList &imageIds)
+{
+    if (imageIds.isEmpty()) {
+        return false;
     }
 
-    QString message = i18n("Press any key to close this terminal…");
+    auto *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        Q_EMIT imageReclaimFinished(watcher->result());
+    });
+    // The configuration is read here, on the GUI thread
+    watcher->setFuture(QtConcurrent::run([imageIds, keptImages = ImageReclaim::keptImages(), knownImages = ImageReclaim::knownImages()]() {
+        return ImageReclaim::reclaim(imageIds, keptImages, knownImages);
+    }));
+
+    return true;
+}
 
-    QString safeMessage = message;
-    safeMessage.replace(u"'"_s, u"'\\''"_s);
+QString DistroboxManager::registryMirrorStatus()
+{
+    return RegistryMirror::statusJson();
+}
 
-    QString innerScript = QStringLiteral("%1 && echo && echo '%2' && read -s -n 1")
-    .arg(*installCmd, safeMessage);
+bool DistroboxManager::setRegistryMirror(const QString &mode, const QString &siteMirror, const QString &mirroredRegistry, bool insecure)
+{
+    RegistryMirror::Settings settings = RegistryMirror::settings();
+    const bool wasLocal = settings.mode == RegistryMirror::Mode::Local;
+    if (mode == u"local"_s) {
+        settings.mode = RegistryMirror::Mode::Local;
+    } else if (mode == u"site"_s) {
+        settings.mode = RegistryMirror::Mode::Site;
+    } else {
+        settings.mode = RegistryMirror::Mode::Off;
+    }
+    settings.siteMirror = siteMirror;
+    settings.mirroredRegistry = mirroredRegistry.trimmed().isEmpty() ? u"docker.io"_s : mirroredRegistry;
+    settings.insecure = insecure;
+
+    if (settings.mode == RegistryMirror::Mode::Site && RegistryMirror::mirrorReference(settings, settings.mirroredRegistry + u"/probe"_s).isEmpty()) {
+        return false;
+    }
+    RegistryMirror::setSettings(settings);
 
-    QString fullCmd = QStringLiteral("distrobox enter %1 -- /usr/bin/env bash -c \"%2\"")
-    .arg(name, innerScript);
+    const bool isLocal = settings.mode == RegistryMirror::Mode::Local;
+    if (isLocal == wasLocal) {
+        Q_EMIT registryMirrorFinished(true, QString());
+        return true;
+    }
 
-    return launchCommandInTerminal(fullCmd, homeDir);
+    // Starting the local mirror may pull the registry image first
+    auto *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, isLocal]() {
+        watcher->deleteLater();
+        const bool success = watcher->result();
+        Q_EMIT registryMirrorFinished(success,
+                                      success       ? QString()
+                                          : isLocal ? i18n("Could not start the local mirror registry.")
+                                                    : i18n("Could not stop the local mirror registry."));
+    });
+    watcher->setFuture(QtConcurrent::run([isLocal]() {
+        return isLocal ? RegistryMirror::startLocalMirror() : RegistryMirror::stopLocalMirror();
+    }));
+    return true;
 }
 
-bool DistroboxManager::isFlatpak() const
+bool DistroboxManager::pinImage(const QString &image)
 {
-    return DistroboxCli::isFlatpak();
+    const QString normalized = RegistryMirror::normalizedReference(image);
+    if (normalized.isEmpty()) {
+        return false;
+    }
+
+    RegistryMirror::Settings settings = RegistryMirror::settings();
+    if (!settings.pinnedImages.contains(normalized)) {
+        settings.pinnedImages.append(normalized);
+        RegistryMirror::setSettings(settings);
+    }
+    return refreshPinnedImages();
 }
 
-QVariantList DistroboxManager::allApps(const QString &container)
+void DistroboxManager::unpinImage(const QString &image)
+{
+    RegistryMirror::Settings settings = RegistryMirror::settings();
+    settings.pinnedImages.removeAll(RegistryMirror::normalizedReference(image));
+    RegistryMirror::setSettings(settings);
+}
+
+bool DistroboxManager::refreshPinnedImages()
+{
+    const RegistryMirror::Settings settings = RegistryMirror::settings();
+
+    auto *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        const bool success = watcher->result();
+        Q_EMIT registryMirrorFinished(success, success ? QString() : i18n("Some pinned images could not be pulled."));
+    });
+    watcher->setFuture(QtConcurrent::run([settings]() {
+        return RegistryMirror::refreshPinnedImages(settings);
+    }));
+    return true;
+}
+
+QString DistroboxManager::resourceLimitPresets()
 {
-    qDebug() << "=== allApps for container:" << container << "===";
+    return ResourceLimits::presetsJson();
+}
+
+QString DistroboxManager::resourceLimitControllers()
+{
+    return ResourceLimits::controllersJson(ResourceLimits::delegatedControllers());
+}
 
-    QString findCmd = QStringLiteral("find /usr/share/applications -type f -name '*.desktop' ! -exec grep -q '^NoDisplay=true' {} \\; -print");
-    QString output = u"distrobox enter %1 -- sh -c %2"_s.arg(container, KShell::quoteArg(findCmd));
+QString DistroboxManager::resourceLimits(const QString &name)
+{
     bool success = false;
-    QString raw = DistroboxCli::runCommand(output, success);
-    QVariantList list;
-    if (!success) {
-        qDebug() << "Find command failed for container:" << container;
-        return list;
+    const ResourceLimits::Limits limits = ResourceLimits::current(name, success);
+    return success ? ResourceLimits::limitsJson(limits) : QString();
+}
+
+bool DistroboxManager::updateResourceLimits(const QString &name, double cpus, int cpuShares, int memoryMiB, int ioWeight)
+{
+    const QString container = name.trimmed();
+    if (container.isEmpty()) {
+        return false;
     }
 
-    for (const QString &line : raw.split(QChar::fromLatin1('\n'), Qt::SkipEmptyParts)) {
-        if (!line.endsWith(QStringLiteral(".desktop"))) {
-            continue;
-        }
+    ResourceLimits::Limits limits;
+    limits.cpus = cpus;
+    limits.cpuShares = cpuShares;
+    limits.memoryBytes = qint64(memoryMiB) * 1024 * 1024;
+    limits.ioWeight = ioWeight;
+
+    QPointer<DistroboxManager> self(this);
+    DistroboxCli::runCommandAsync(
+        ResourceLimits::updateCommand(container, limits, ResourceLimits::delegatedControllers()),
+        this,
+        [self, container](bool success, const QString &) {
+            if (self) {
+                Q_EMIT self->resourceLimitsUpdated(container, success);
+            }
+        },
+        DistroboxCli::DefaultTimeoutMs);
+    return true;
+}
 
-        // Extract basename from the full path
-        QString basename = line;
-        if (basename.startsWith(QStringLiteral("/usr/share/applications/"))) {
-            basename.remove(0, 24);
+bool DistroboxManager::saveAsTemplate(const QString &container, const QString &name, bool squash)
+{
+    const QString trimmedContainer = container.trimmed();
+    const QString templateName = TemplateImages::sanitizedName(name);
+    const auto command = TemplateImages::commitCommand(trimmedContainer, templateName, squash);
+    if (!command) {
+        return false;
+    }
+
+    QPointer<DistroboxManager> self(this);
+    DistroboxCli::runCommandAsync(*command, this, [self, trimmedContainer, templateName, squash](bool success, const QString &) {
+        if (!self) {
+            return;
         }
-        if (basename.endsWith(QStringLiteral(".desktop"))) {
-            basename.chop(8);
+        if (success) {
+            TemplateImages::record(trimmedContainer, templateName, squash);
+            Q_EMIT self->templatesChanged();
         }
+        Q_EMIT self->templateSaveFinished(templateName, success);
+    });
 
-        // Read desktop file from container
-        QString readCmd = QStringLiteral("cat %1").arg(KShell::quoteArg(line));
-        QString desktopOutput = u"distrobox enter %1 -- sh -c %2"_s.arg(container, KShell::quoteArg(readCmd));
-        bool readSuccess = false;
-        QString desktopContent = DistroboxCli::runCommand(desktopOutput, readSuccess);
+    return true;
+}
 
-        if (!readSuccess) {
-            continue;
-        }
+bool DistroboxManager::listTemplates()
+{
+    struct Listing {
+        QList<TemplateImages::Template> templates;
+        QStringList missing;
+    };
 
-        // Parse desktop file content with proper localization handling
-        QVariantMap app;
-        app[QStringLiteral("basename")] = basename;
-
-        QString name = basename;
-        QString icon;
-        QString genericName; // For debugging
-
-        // Prefer English name, fall back to generic name
-        QString englishName;
-
-        for (const QString &desktopLine : desktopContent.split(QChar::fromLatin1('\n'), Qt::SkipEmptyParts)) {
-            if (desktopLine.startsWith(QStringLiteral("Name[en]="))) {
-                englishName = desktopLine.mid(8); // Remove "Name[en]="
-            } else if (desktopLine.startsWith(QStringLiteral("Name=")) && name == basename) {
-                name = desktopLine.mid(5); // Remove "Name=" (only use as fallback)
-            } else if (desktopLine.startsWith(QStringLiteral("Icon="))) {
-                icon = desktopLine.mid(5); // Remove "Icon="
-            } else if (desktopLine.startsWith(QStringLiteral("GenericName="))) {
-                genericName = desktopLine.mid(12); // For debugging
-            }
-        }
+    auto *watcher = new QFutureWatcher<Listing>(this);
+    connect(watcher, &QFutureWatcher<Listing>::finished, this, [this, watcher]() {
+        watcher->deleteLater();
+        const Listing listing = watcher->result();
+        TemplateImages::forget(listing.missing);
+        Q_EMIT templatesListed(TemplateImages::listJson(listing.templates));
+    });
+    // The configuration is read here, on the GUI thread
+    watcher->setFuture(QtConcurrent::run([tracked = TemplateImages::tracked()]() {
+        Listing listing;
+        listing.templates = TemplateImages::list(tracked, listing.missing);
+        return listing;
+    }));
+
+    return true;
+}
 
-        // Prefer English name if available
-        if (!englishName.isEmpty()) {
-            name = englishName;
-        }
+bool DistroboxManager::removeTemplates(const QStringList &names)
+{
+    const bool success = TemplateImages::remove(names);
+    Q_EMIT templatesChanged();
+    return success;
+}
 
-        app[QStringLiteral("name")] = name;
-        app[QStringLiteral("icon")] = icon;
-        app[QStringLiteral("genericName")] = genericName; // For debugging
-        app[QStringLiteral("sourceFile")] = line; // For debugging
+bool DistroboxManager::backupContainer(const QString &name, const QString &fileUrl)
+{
+    return m_containerArchive->backup(name.trimmed(), localArchivePath(fileUrl));
+}
 
-        const QString iconSource = cacheIconFromContainer(container, basename, icon);
-        if (!iconSource.isEmpty()) {
-            app[QStringLiteral("iconSource")] = iconSource;
-        }
+bool DistroboxManager::restoreContainer(const QString &fileUrl, const QString &name)
+{
+    return m_containerArchive->restore(localArchivePath(fileUrl), name.trimmed());
+}
 
-        qDebug() << "App:" << name << "| Basename:" << basename << "| Generic:" << genericName << "| Source:" << line;
-        list << app;
+void DistroboxManager::cancelArchive()
+{
+    m_containerArchive->cancel();
+}
+
+QString DistroboxManager::stalledOperations()
+{
+    QJsonArray array;
+    for (const DistroboxCli::Operation &operation : m_operationWatchdog->stalledOperations()) {
+        QJsonObject object;
+        object[u"id"_s] = static_cast<qint64>(operation.id);
+        object[u"command"_s] = operation.command;
+        object[u"silentSeconds"_s] = operation.silentMs / 1000;
+        object[u"runningMinutes"_s] = operation.runningMs / 60000;
+        object[u"quiet"_s] = operation.quiet;
+        array.append(object);
     }
+    return QString::fromUtf8(QJsonDocument(array).toJson());
+}
 
-    qDebug() << "Total apps found:" << list.size();
-    return list;
+bool DistroboxManager::cancelOperation(qint64 id)
+{
+    return id > 0 && DistroboxCli::cancelOperation(static_cast<quint64>(id));
 }
 
-QVariantList DistroboxManager::exportedApps(const QString &container)
+QString DistroboxManager::lifecyclePolicy(const QString &name)
 {
-    QVariantList list;
-    bool isFlatpakRuntime = DistroboxCli::isFlatpak();
-    QStringList searchPaths;
+    const LifecyclePolicy::Policy policy = m_lifecyclePolicy->policy(name.trimmed());
 
-    if (isFlatpakRuntime) {
-        // Flatpak build only has read access to the host exports directory
-        searchPaths = {QDir::homePath() + QStringLiteral("/.local/share/applications")};
-    } else {
-        searchPaths = {QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation)};
-    }
+    QJsonObject object;
+    object[u"startAtLogin"_s] = policy.startAtLogin;
+    object[u"startOnHover"_s] = policy.startOnHover;
+    object[u"idleStopMinutes"_s] = policy.idleStopMinutes;
+    return QString::fromUtf8(QJsonDocument(object).toJson());
+}
 
-    QStringList patterns;
-    patterns << QStringLiteral("%1-*.desktop").arg(container);
+bool DistroboxManager::setLifecyclePolicy(const QString &name, bool startAtLogin, bool startOnHover, int idleStopMinutes)
+{
+    const QString trimmedName = name.trimmed();
+    if (trimmedName.isEmpty() || idleStopMinutes < 0) {
+        return false;
+    }
 
-    for (const QString &searchPath : searchPaths) {
-        QDir dir(searchPath);
-        if (!dir.exists()) {
-            continue;
-        }
+    m_lifecyclePolicy->setPolicy(trimmedName, LifecyclePolicy::Policy{startAtLogin, startOnHover, idleStopMinutes});
+    return true;
+}
 
-        for (const QFileInfo &file : dir.entryInfoList(patterns, QDir::Files)) {
-            QString fileName = file.fileName();
-            if (!fileName.endsWith(QStringLiteral(".desktop"))) {
-                continue;
-            }
+void DistroboxManager::prewarmContainer(const QString &name)
+{
+    m_lifecyclePolicy->prewarmOnHover(name.trimmed());
+}
 
-            // Skip clone files explicitly
-            if (fileName.endsWith(QStringLiteral("clone.desktop"), Qt::CaseInsensitive)
-                || fileName.contains(QStringLiteral("-clone.desktop"), Qt::CaseInsensitive)) {
-                continue;
-            }
+bool DistroboxManager::refreshPackageInventory()
+{
+    return m_packageInventory->refresh(DistroboxCli::containers());
+}
 
-            // Extract basename from filename
-            QString prefix = container + QLatin1String("-");
-            QString basename = fileName;
-            if (basename.startsWith(prefix)) {
-                basename.remove(0, prefix.length());
-            }
-            if (basename.endsWith(QStringLiteral(".desktop"))) {
-                basename.chop(8);
-            }
+QVariantList DistroboxManager::searchPackages(const QString &query, int limit)
+{
+    QVariantList list;
+    for (const PackageInventory::Match &match : m_packageInventory->search(query, limit)) {
+        QVariantMap package;
+        package[QStringLiteral("name")] = match.name;
+        package[QStringLiteral("version")] = match.version;
+        package[QStringLiteral("container")] = match.container;
+        list << package;
+    }
+    return list;
+}
 
-            // Skip if we already found this app
-            bool alreadyExists = false;
-            for (const QVariant &existingApp : list) {
-                QVariantMap existingMap = existingApp.toMap();
-                if (existingMap[QStringLiteral("basename")].toString() == basename) {
-                    alreadyExists = true;
-                    break;
-                }
-            }
-            if (alreadyExists) {
-                continue;
-            }
+bool DistroboxManager::installPackages(const QStringList &containers, const QString &packageNames)
+{
+    const QStringList names = packageNames.split(QRegularExpression(u"\\s+"_s), Qt::SkipEmptyParts);
+    if (containers.isEmpty() || names.isEmpty()) {
+        return false;
+    }
 
-            QSettings desktop(file.filePath(), QSettings::IniFormat);
-            QVariantMap app;
-            app[QStringLiteral("basename")] = basename;
+    QList<DistroboxCli::Container> selected;
+    for (const DistroboxCli::Container &container : DistroboxCli::containers()) {
+        if (containers.contains(container.name)) {
+            selected.append(container);
+        }
+    }
 
-            QString fullName = desktop.value(QStringLiteral("Desktop Entry/Name"), basename).toString();
-            QString icon = desktop.value(QStringLiteral("Desktop Entry/Icon"), QString()).toString();
+    return m_packageBatchInstall->start(selected, names);
+}
 
-            app[QStringLiteral("name")] = fullName.section(QStringLiteral(" (on "), 0, 0);
-            app[QStringLiteral("icon")] = icon;
+bool DistroboxManager::isFlatpak() const
+{
+    return DistroboxCli::isFlatpak();
+}
 
-            qDebug() << "Exported app:" << app[QStringLiteral("name")].toString() << "| Basename:" << basename << "| File:" << fileName;
-            list << app;
+QVariantList DistroboxManager::allApps(const QString &container)
+{
+    QVariantList list;
+    for (const AvailableApp &entry : AppCatalog::availableApps(container)) {
+        QVariantMap app;
+        app[QStringLiteral("basename")] = entry.basename;
+        app[QStringLiteral("name")] = entry.name;
+        app[QStringLiteral("icon")] = entry.icon;
+        if (!entry.iconSource.isEmpty()) {
+            app[QStringLiteral("iconSource")] = entry.iconSource;
         }
+        list << app;
     }
+    return list;
+}
 
+QVariantList DistroboxManager::exportedApps(const QString &container)
+{
+    QVariantList list;
+    for (const ExportedApp &entry : AppCatalog::exportedApps(container)) {
+        QVariantMap app;
+        app[QStringLiteral("basename")] = entry.basename;
+        app[QStringLiteral("name")] = entry.name;
+        app[QStringLiteral("icon")] = entry.icon;
+        list << app;
+    }
     return list;
 }
 
+void DistroboxManager::loadApps(const QString &container, AppListModel *exportedModel, AppListModel *availableModel)
+{
+    const QList<ExportedApp> exported = AppCatalog::exportedApps(container);
+    if (exportedModel) {
+        exportedModel->setExportedApps(exported);
+    }
+    if (!availableModel) {
+        Q_EMIT appsLoaded(container);
+        return;
+    }
+
+    // Reading the container's entries may run commands in it, keep that off the GUI thread
+    auto *watcher = new QFutureWatcher<QList<AvailableApp>>(this);
+    connect(watcher,
+            &QFutureWatcher<QList<AvailableApp>>::finished,
+            this,
+            [this, watcher, container, exported, model = QPointer<AppListModel>(availableModel)]() {
+                watcher->deleteLater();
+                if (model) {
+                    model->setAvailableApps(watcher->result(), exported);
+                }
+                Q_EMIT appsLoaded(container);
+            });
+    watcher->setFuture(QtConcurrent::run([container]() {
+        return AppCatalog::availableApps(container);
+    }));
+}
+
 bool DistroboxManager::exportApp(const QString &basename, const QString &container)
 {
     // Construct the full path to the desktop file in the container
     QString desktopPath = QStringLiteral("/usr/share/applications/") + basename + QStringLiteral(".desktop");
-    QString command = u"distrobox enter %1 -- distrobox-export --app %2"_s.arg(KShell::quoteArg(container), KShell::quoteArg(desktopPath));
+    const DistroboxCli::Command command(u"distrobox"_s, {u"enter"_s, container, u"--"_s, u"distrobox-export"_s, u"--app"_s, desktopPath});
 
     bool success;
-    QString output = DistroboxCli::runCommand(command, success);
+    QString output = DistroboxCli::runCommand(command, success, DistroboxCli::LongTimeoutMs);
 
     qDebug() << "Export" << basename << ":" << (success ? "SUCCESS" : "FAILED") << "Output:" << output;
     return success;
@@ -714,11 +1145,11 @@ bool DistroboxManager::unexportApp(const QString &basename, const QString &conta
         qDebug() << "STRATEGY: Safe to use distrobox-export --delete (will remove icons/metadata)";
 
         // First try with just the basename (how distrobox-export expects it)
-        QString command = u"distrobox enter %1 -- distrobox-export --app %2 --delete"_s.arg(KShell::quoteArg(container), KShell::quoteArg(basename));
-        qDebug() << "Executing command:" << command;
+        const DistroboxCli::Command command(u"distrobox"_s, {u"enter"_s, container, u"--"_s, u"distrobox-export"_s, u"--app"_s, basename, u"--delete"_s});
+        qDebug() << "Executing command:" << command.toString();
 
         bool success;
-        QString output = DistroboxCli::runCommand(command, success);
+        QString output = DistroboxCli::runCommand(command, success, DistroboxCli::LongTimeoutMs);
         qDebug() << "Command result - Success:" << success << "Output:" << output;
 
         if (success) {
@@ -731,10 +1162,10 @@ bool DistroboxManager::unexportApp(const QString &basename, const QString &conta
 
         // If that fails, try with the full path
         QString desktopPath = QStringLiteral("/usr/share/applications/") + basename + QStringLiteral(".desktop");
-        QString altCommand = u"distrobox enter %1 -- distrobox-export --app %2 --delete"_s.arg(KShell::quoteArg(container), KShell::quoteArg(desktopPath));
-        qDebug() << "Executing alternative command:" << altCommand;
+        const DistroboxCli::Command altCommand(u"distrobox"_s, {u"enter"_s, container, u"--"_s, u"distrobox-export"_s, u"--app"_s, desktopPath, u"--delete"_s});
+        qDebug() << "Executing alternative command:" << altCommand.toString();
 
-        output = DistroboxCli::runCommand(altCommand, success);
+        output = DistroboxCli::runCommand(altCommand, success, DistroboxCli::LongTimeoutMs);
         qDebug() << "Alternative command result - Success:" << success << "Output:" << output;
 
         if (success) {
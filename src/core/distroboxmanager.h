@@ -6,12 +6,24 @@
 
 #pragma once
 
+#include "appcatalog.h"
+
 #include <QDir>
+#include <QList>
 #include <QObject>
 #include <QString>
 #include <QStringList>
 #include <functional>
 
+class AppListModel;
+class AssembleRunner;
+class ContainerArchive;
+class LifecyclePolicy;
+class OperationWatchdog;
+class PackageBatchInstall;
+class PackageInventory;
+class UpdatePrefetcher;
+
 /**
  * @class DistroboxManager
  * @brief Manages interactions with Distrobox containers
@@ -24,6 +36,7 @@
 class DistroboxManager : public QObject
 {
     Q_OBJECT
+    Q_MOC_INCLUDE("applistmodel.h")
 
 public:
     /**
@@ -35,31 +48,8 @@ public:
      */
     explicit DistroboxManager(QObject *parent = nullptr);
 
-    /**
-     * @struct ExportedApp
-     * @brief Represents an application exported from a container to the host
-     *
-     * Contains information about the exported application, including
-     * its filesystem basename, display name, and icon name/path.
-     */
-    struct ExportedApp {
-        QString basename; ///< The binary or executable basename
-        QString name; ///< Display name of the application
-        QString icon; ///< Icon name or path
-    };
-
-    /**
-     * @struct AvailableApp
-     * @brief Represents an application available inside a container
-     *
-     * Contains metadata about an application that exists inside a container,
-     * which can potentially be exported to the host system.
-     */
-    struct AvailableApp {
-        QString basename; ///< The binary or executable basename
-        QString name; ///< Display name of the application
-        QString icon; ///< Icon name or path
-    };
+    using ExportedApp = AppCatalog::ExportedApp; ///< Application exported from a container to the host
+    using AvailableApp = AppCatalog::AvailableApp; ///< Application available inside a container
 
 public Q_SLOTS:
 
@@ -80,9 +70,25 @@ public Q_SLOTS:
      * @param name Name for the new container
      * @param image Base image to use for the container
      * @param args Additional arguments to pass to distrobox create command
+     * @param sharePackageCache Mount the host package download cache shared by containers of the same package manager
+     * @param limitsPreset CPU, memory and IO limits preset from resourceLimitPresets(), empty for none
      * @return true if container creation was successful, false otherwise
      */
-    bool createContainer(const QString &name, const QString &image, const QString &args);
+    bool createContainer(const QString &name, const QString &image, const QString &args, bool sharePackageCache = false, const QString &limitsPreset = QString());
+
+    /**
+     * @brief Checks the additional arguments of createContainer() before creating
+     * @param args Additional arguments in shell syntax
+     * @return Translated reason createContainer() would reject them, or an empty string when they are accepted
+     */
+    QString createArgumentsError(const QString &args);
+
+    /**
+     * @brief Gets the shared package cache a container of the given image would use
+     * @param image Base image of the container
+     * @return Name of the package manager family, e.g. "dnf", or an empty string when no cache can be shared
+     */
+    QString packageCacheFamily(const QString &image);
 
     /**
      * @brief Opens an interactive shell in the specified container
@@ -114,11 +120,32 @@ public Q_SLOTS:
     bool cloneContainer(const QString &sourceName, const QString &cloneName);
 
     /**
-     * @brief Assembles a Distrobox container from an .ini configuration file
-     * @param iniFile Path to the .ini file used to define the container
+     * @brief Clones a container from a snapshot of its writable layer, without stopping it
+     * @param sourceName Name of the container to clone
+     * @param cloneName Name that should be assigned to the cloned container
+     * @param pauseSource Whether to pause the source while the snapshot is taken, for a consistent copy
+     * @return true if the cloning process was started, false otherwise
+     *
+     * Progress is reported through containerCloneProgress() and completion through
+     * containerCloneFinished().
+     */
+    bool snapshotCloneContainer(const QString &sourceName, const QString &cloneName, bool pauseSource = false);
+
+    /**
+     * @brief Assembles the Distrobox containers defined in an .ini configuration file
+     * @param iniFile Path to the .ini file used to define the containers
+     * @param maxParallel Number of containers created at once, stored for later runs; 0 uses the stored value
      * @return true if the assembly process was successfully started, false otherwise
+     *
+     * Sections are created concurrently. Each one reports through containerAssembleProgress()
+     * and the whole manifest through containerAssembleFinished().
+     */
+    bool assembleContainer(const QString &iniFile, int maxParallel = 0);
+
+    /**
+     * @brief Gets the number of containers assembleContainer() creates at once by default
      */
-    bool assembleContainer(const QString &iniFile);
+    int assembleParallelism() const;
 
     /**
      * @brief Upgrades packages in all containers
@@ -129,9 +156,10 @@ public Q_SLOTS:
     /**
      * @brief Gets a color associated with the distribution
      * @param image Base image name to get color for
+     * @param container Container name, its probed distribution takes precedence over the image name (optional)
      * @return Hex color code (e.g., "#FF0000") for the distribution
      */
-    QString getDistroColor(const QString &image);
+    QString getDistroColor(const QString &image, const QString &container = QString());
 
     /**
      * @brief Gets an Icon associated with the distribution
@@ -141,12 +169,24 @@ public Q_SLOTS:
     QString getDistroIcon(const QString &container);
 
     /**
-     * @brief Generates desktop entry files for container applications
+     * @brief Generates the menu entries that open a terminal in containers
      * @param name Container name (optional, generates for all containers if empty)
      * @return true if entry generation was successful, false otherwise
      */
     bool generateEntry(const QString &name = QString());
 
+    /**
+     * @brief Generates the menu entries of the given containers concurrently
+     *
+     * Entries are only rewritten when their content changed. Outside of Flatpak no
+     * container is started or inspected, the entries come from the known metadata. In
+     * the Flatpak distrobox writes them on the host, with a single call when the names
+     * cover every container.
+     * @param names Container names
+     * @return true if every entry was generated
+     */
+    bool generateEntries(const QStringList &names);
+
     /**
      * @brief Installs a package file in a container
      * @param name Container name
@@ -176,6 +216,17 @@ public Q_SLOTS:
      */
     Q_INVOKABLE QVariantList exportedApps(const QString &container);
 
+    /**
+     * @brief Loads the applications of the given container into list models
+     * @param container Name of the container
+     * @param exportedModel Model receiving the applications exported to the host, may be null
+     * @param availableModel Model receiving the applications available inside the container, may be null
+     *
+     * The exported applications are loaded right away, the available ones in the background.
+     * appsLoaded() is emitted once both models are filled.
+     */
+    Q_INVOKABLE void loadApps(const QString &container, AppListModel *exportedModel, AppListModel *availableModel);
+
     /**
      * @brief Exports an application from a container to the host system
      * @param basename Basename of the application to export
@@ -192,6 +243,223 @@ public Q_SLOTS:
      */
     Q_INVOKABLE bool unexportApp(const QString &basename, const QString &container);
 
+    /**
+     * @brief Starts computing the disk usage of a container in the background
+     * @param name Name of the container to scan
+     * @return true if the scan was started, false otherwise
+     *
+     * Reports the size of the writable layer, the size of the shared base image and
+     * the largest directories of the writable layer through diskUsageReady().
+     */
+    bool scanDiskUsage(const QString &name);
+
+    /**
+     * @brief Lists the images no container uses anymore in the background, without removing anything
+     * @return true if the listing was started
+     *
+     * Only images created or pulled for Kontainer and distrobox containers are listed. The JSON
+     * object with the candidate images and the estimated reclaimable bytes is reported through
+     * imageReclaimPreviewReady().
+     */
+    bool previewImageReclaim();
+
+    /**
+     * @brief Removes the selected unused images in one batch in the background
+     * @param imageIds IDs of the images to remove, as listed by imageReclaimPreviewReady()
+     * @return true if the removal was started, false otherwise
+     *
+     * Completion is reported through imageReclaimFinished().
+     */
+    bool reclaimImages(const QStringList &imageIds);
+
+    /**
+     * @brief Describes the registry mirror settings, the pinned images and the pull hit rate
+     * @return JSON object with the mode, the mirror addresses, the pinned images and pull counts
+     */
+    QString registryMirrorStatus();
+
+    /**
+     * @brief Sets where container images are pulled from before a container is created
+     * @param mode "off", "local" for a pull-through registry on this machine, or "site"
+     * @param siteMirror Host, port and optional path prefix of the site mirror
+     * @param mirroredRegistry Upstream registry the site mirror serves, e.g. "docker.io"
+     * @param insecure Whether the site mirror is reached without TLS verification
+     * @return false if the site mirror address is missing
+     *
+     * Starting or stopping the local mirror is reported through registryMirrorFinished().
+     */
+    bool setRegistryMirror(const QString &mode, const QString &siteMirror, const QString &mirroredRegistry, bool insecure);
+
+    /**
+     * @brief Keeps an image local, pulling it through the mirror if it is missing
+     * @param image Image reference, short names are expanded like the container manager does
+     * @return false if the reference is empty
+     *
+     * Pinned images are never offered for reclaiming. The pull is reported through registryMirrorFinished().
+     */
+    bool pinImage(const QString &image);
+
+    /**
+     * @brief Stops keeping an image local, the image itself stays until it is reclaimed
+     */
+    void unpinImage(const QString &image);
+
+    /**
+     * @brief Pulls the pinned images that are missing locally in the background
+     * @return true if the pull was started
+     */
+    bool refreshPinnedImages();
+
+    /**
+     * @brief Lists the resource limit presets, sized for this machine
+     * @return JSON array of presets with their name, label, summary and limits
+     */
+    QString resourceLimitPresets();
+
+    /**
+     * @brief Tells which limits rootless containers can be given on this machine
+     * @return JSON object with cpu, memory and io flags, and a note explaining the missing controllers, empty if none is missing
+     *
+     * Limits of missing controllers are left out when creating or updating a container.
+     */
+    QString resourceLimitControllers();
+
+    /**
+     * @brief Reads the CPU, memory and IO limits a container runs with
+     * @return JSON object with cpus, cpuShares, memoryMiB and ioWeight, empty if the container could not be inspected
+     */
+    QString resourceLimits(const QString &name);
+
+    /**
+     * @brief Changes the limits of a container in place, running or not
+     * @param cpus CPU quota in cores, 0 lifts the quota
+     * @param cpuShares Relative CPU weight, 0 keeps the current one
+     * @param memoryMiB Memory limit, 0 keeps the current one
+     * @param ioWeight Block IO weight from 10 to 1000, 0 keeps the current one
+     * @return true if the update was started
+     *
+     * Completion is reported through resourceLimitsUpdated().
+     */
+    bool updateResourceLimits(const QString &name, double cpus, int cpuShares, int memoryMiB, int ioWeight);
+
+    /**
+     * @brief Commits a container to a local template image in the background
+     * @param container Name of the provisioned container
+     * @param name Name of the template, also used for its image tag
+     * @param squash Whether to flatten the image into a single layer
+     * @return true if the commit was started, false otherwise
+     *
+     * Completion is reported through templateSaveFinished(). Templates show up in
+     * listAvailableImages().
+     */
+    bool saveAsTemplate(const QString &container, const QString &name, bool squash);
+
+    /**
+     * @brief Lists the template images with their source container, creation date and size
+     * @return true if the listing was started
+     *
+     * The images are queried in the background, the result is delivered through
+     * templatesListed(). Templates whose image was removed are forgotten.
+     */
+    bool listTemplates();
+
+    /**
+     * @brief Removes template images and forgets them
+     * @param names Names of the templates, as returned by listTemplates()
+     * @return true if every template was removed, false otherwise
+     */
+    bool removeTemplates(const QStringList &names);
+
+    /**
+     * @brief Backs up a container to a zstd-compressed archive in the background
+     * @param name Container name
+     * @param fileUrl Path or file:// URL of the archive to write
+     * @return true if the backup was started, false if another backup or restore is running
+     *
+     * Progress is reported through archiveStageChanged() and archiveProgress(),
+     * completion through archiveFinished().
+     */
+    bool backupContainer(const QString &name, const QString &fileUrl);
+
+    /**
+     * @brief Restores a container from an archive written by backupContainer()
+     * @param fileUrl Path or file:// URL of the archive
+     * @param name Name of the container to create
+     * @return true if the restore was started, false if another backup or restore is running
+     */
+    bool restoreContainer(const QString &fileUrl, const QString &name);
+
+    /**
+     * @brief Cancels the running backup or restore
+     */
+    void cancelArchive();
+
+    /**
+     * @brief Lists container manager commands that wrote no output for a while
+     * @return JSON string containing an array of operations with id, command and silentSeconds
+     */
+    QString stalledOperations();
+
+    /**
+     * @brief Terminates a running command and every process it started
+     * @param id Operation id, as returned by stalledOperations()
+     * @return true if the command was still running, false otherwise
+     *
+     * The operation that ran the command then fails like any other failed command.
+     */
+    bool cancelOperation(qint64 id);
+
+    /**
+     * @brief Gets the start/stop policy of a container
+     * @param name Container name
+     * @return JSON object with startAtLogin, startOnHover and idleStopMinutes
+     */
+    QString lifecyclePolicy(const QString &name);
+
+    /**
+     * @brief Sets the start/stop policy of a container
+     * @param name Container name
+     * @param startAtLogin Start the container when the user logs in
+     * @param startOnHover Start the container when its card is hovered
+     * @param idleStopMinutes Stop the container after this many idle minutes, 0 disables
+     * @return true if the policy was stored, false otherwise
+     */
+    bool setLifecyclePolicy(const QString &name, bool startAtLogin, bool startOnHover, int idleStopMinutes);
+
+    /**
+     * @brief Starts the container ahead of use if its policy asks for it on hover
+     * @param name Container name
+     */
+    void prewarmContainer(const QString &name);
+
+    /**
+     * @brief Refreshes the installed-package index of all containers in the background
+     * @return true if a refresh was started, false if one is already running
+     *
+     * Only containers whose package database changed are re-read. Completion is
+     * reported through packageInventoryRefreshed().
+     */
+    bool refreshPackageInventory();
+
+    /**
+     * @brief Searches the installed packages of all containers
+     * @param query Part of the package name, case insensitive
+     * @param limit Maximum number of results
+     * @return QVariantList of maps with name, version and container, prefix matches first
+     */
+    Q_INVOKABLE QVariantList searchPackages(const QString &query, int limit = 200);
+
+    /**
+     * @brief Installs packages from the distribution repositories into several containers
+     * @param containers Names of the containers to install into
+     * @param packageNames Package names, separated by whitespace
+     * @return true if the installation was started, false if one is already running
+     *
+     * A few containers are processed concurrently, without prompting. Each container
+     * reports through packageInstallProgress() and the batch through packageInstallFinished().
+     */
+    bool installPackages(const QStringList &containers, const QString &packageNames);
+
 Q_SIGNALS:
     /**
      * @brief Emitted when a container clone operation finishes.
@@ -200,15 +468,163 @@ Q_SIGNALS:
      */
     void containerCloneFinished(const QString &clonedName, bool success);
 
+    /**
+     * @brief Emitted as a snapshot clone moves through its stages.
+     * @param clonedName Name assigned to the cloned container.
+     * @param percent Overall progress, from 0 to 100.
+     * @param stage Human readable description of the current stage.
+     */
+    void containerCloneProgress(const QString &clonedName, int percent, const QString &stage);
+
+    /**
+     * @brief Emitted when a manifest starts being assembled.
+     * @param sections Names of the containers defined by the manifest.
+     */
+    void containerAssembleStarted(const QStringList &sections);
+
+    /**
+     * @brief Emitted when a container of an assembled manifest changes state.
+     * @param section Name of the container.
+     * @param state One of queued, pulling, creating, created or failed.
+     * @param detail Image being pulled, or the output tail of a failure.
+     */
+    void containerAssembleProgress(const QString &section, const QString &state, const QString &detail);
+
     /**
      * @brief Emitted when a container assembly operation finishes.
-     * @param success Whether the assembly command completed successfully.
+     * @param success Whether every container of the manifest was created.
+     * @param error Why the manifest could not be assembled at all, empty otherwise.
+     */
+    void containerAssembleFinished(bool success, const QString &error);
+
+    /**
+     * @brief Emitted when a disk usage scan finishes.
+     * @param name Name of the scanned container.
+     * @param report JSON object with the writable layer size, image size and largest directories.
+     */
+    void diskUsageReady(const QString &name, const QString &report);
+
+    /**
+     * @brief Emitted when loadApps() filled the models.
+     * @param container Name of the container whose applications were loaded.
+     */
+    void appsLoaded(const QString &container);
+
+    /**
+     * @brief Emitted when the preview started by previewImageReclaim() is ready.
+     * @param plan JSON object with the candidate images and the estimated reclaimable bytes.
+     */
+    void imageReclaimPreviewReady(const QString &plan);
+
+    /**
+     * @brief Emitted when an image reclaim operation finishes.
+     * @param success Whether every selected image was removed.
+     */
+    void imageReclaimFinished(bool success);
+
+    /**
+     * @brief Emitted when the local mirror was started or stopped, or pinned images were pulled.
+     * @param success Whether the operation succeeded.
+     * @param message Error to show when it did not.
+     */
+    void registryMirrorFinished(bool success, const QString &message);
+
+    /**
+     * @brief Emitted when changing the resource limits of a container finishes.
+     * @param name Name of the container.
+     * @param success Whether the container manager applied the limits.
+     */
+    void resourceLimitsUpdated(const QString &name, bool success);
+
+    /**
+     * @brief Emitted when saving a template finishes.
+     * @param name Name of the template.
+     * @param success Whether the container was committed.
+     */
+    void templateSaveFinished(const QString &name, bool success);
+
+    /**
+     * @brief Emitted when templates were added or removed.
+     */
+    void templatesChanged();
+
+    /**
+     * @brief Emitted when listing the templates finishes.
+     * @param templates JSON string containing an array of templates.
+     */
+    void templatesListed(const QString &templates);
+
+    /**
+     * @brief Emitted when a backup or restore moves to its next step.
+     * @param stage Translated description of the step.
+     */
+    void archiveStageChanged(const QString &stage);
+
+    /**
+     * @brief Emitted periodically while a backup or restore copies data.
+     * @param percent Percentage done, -1 when the total size is unknown.
+     * @param detail Translated amount copied and throughput.
+     */
+    void archiveProgress(int percent, const QString &detail);
+
+    /**
+     * @brief Emitted when a backup or restore finishes.
+     * @param success Whether the archive was written or the container created.
+     * @param message Translated error, empty on success.
+     */
+    void archiveFinished(bool success, const QString &message);
+
+    /**
+     * @brief Emitted periodically while commands are stalled, and once when none are left.
+     * @param operations JSON array as returned by stalledOperations().
+     */
+    void stalledOperationsChanged(const QString &operations);
+
+    /**
+     * @brief Emitted when updates of a container were fetched in the background or installed.
+     * @param container Name of the container.
+     * @param count Number of updates waiting to be installed.
+     */
+    void pendingUpdatesChanged(const QString &container, int count);
+
+    /**
+     * @brief Emitted when a container was started or stopped by its lifecycle policy.
+     * @param name Name of the container.
+     * @param running Whether the container is now running.
+     */
+    void containerStateChanged(const QString &name, bool running);
+
+    /**
+     * @brief Emitted when the installed-package index was refreshed.
+     */
+    void packageInventoryRefreshed();
+
+    /**
+     * @brief Emitted when a container of a package installation changes state.
+     * @param container Name of the container.
+     * @param state One of queued, installing, installed, failed or unsupported.
+     * @param completed Number of containers done so far.
+     * @param total Number of containers in the installation.
+     */
+    void packageInstallProgress(const QString &container, const QString &state, int completed, int total);
+
+    /**
+     * @brief Emitted when a package installation finished in every container.
+     * @param success Whether the packages were installed in every container.
+     * @param results JSON array with the state and, for failures, the output of each container.
      */
-    void containerAssembleFinished(bool success);
+    void packageInstallFinished(bool success, const QString &results);
 
 private:
     QStringList m_availableImages; ///< List of available container base images
     QStringList m_fullImageNames; ///< List of full image names/URLs
+    LifecyclePolicy *m_lifecyclePolicy; ///< Pre-warming and idle auto-stop of containers
+    PackageInventory *m_packageInventory; ///< Installed packages of every container
+    PackageBatchInstall *m_packageBatchInstall; ///< Repository package installs across containers
+    AssembleRunner *m_assembleRunner; ///< Concurrent creation of assemble manifests
+    UpdatePrefetcher *m_updatePrefetcher; ///< Background download of container updates
+    ContainerArchive *m_containerArchive; ///< Compressed backup and restore of containers
+    OperationWatchdog *m_operationWatchdog; ///< Detection of hung container manager commands
 
     /**
      * @brief Checks if an application with the given basename is exported by other containers
@@ -0,0 +1,419 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "icontheme.h"
+
+#include "containerfs.h"
+
+#include <QElapsedTimer>
+#include <QMutex>
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <memory>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Deep enough for <theme>/<size>/<context>/<icon> and <theme>/<size>@2x/<context>/<icon>
+constexpr int ThemeWalkDepth = 4;
+
+const QStringList &baseDirectories()
+{
+    static const QStringList directories{u"/usr/share/icons"_s, u"/usr/local/share/icons"_s};
+    return directories;
+}
+
+const QStringList &fallbackDirectories()
+{
+    static const QStringList directories{u"/usr/share/pixmaps"_s, u"/usr/share/icons"_s, u"/usr/local/share/icons"_s};
+    return directories;
+}
+
+// In order of preference, as the specification asks for
+const QStringList &extensions()
+{
+    static const QStringList suffixes{u".png"_s, u".svg"_s, u".xpm"_s};
+    return suffixes;
+}
+
+struct ThemeDirectory {
+    enum class Type {
+        Fixed,
+        Scalable,
+        Threshold,
+    };
+
+    int size = 0;
+    int scale = 1;
+    int minSize = 0;
+    int maxSize = 0;
+    int threshold = 2;
+    Type type = Type::Threshold;
+};
+
+struct IconFile {
+    int directory; ///< Index into Theme::directories
+    int extension; ///< Index into extensions()
+    QString path;
+};
+
+struct Theme {
+    QStringList inherits;
+    QList<ThemeDirectory> directories;
+    QHash<QString, QList<IconFile>> icons; ///< Sorted by directory, then extension
+};
+
+// Packages installed later add icons, an index older than this is built again
+constexpr qint64 IndexLifetimeMs = 60 * 1000;
+
+struct ContainerIndex {
+    QHash<QString, std::shared_ptr<const Theme>> themes; ///< nullptr for themes the container lacks
+    QElapsedTimer age;
+};
+
+// Only held around the lookups, never while a theme is read from a container
+QMutex indexMutex;
+QHash<QString, ContainerIndex> indexes; ///< Guarded by indexMutex
+QHash<QString, std::shared_ptr<QMutex>> loadMutexes; ///< Guarded by indexMutex
+QString preferredTheme; ///< Guarded by indexMutex
+
+// Held while resolving icons of the container, so threads resolving it build each index once
+// while other containers go on
+std::shared_ptr<QMutex> loadMutex(const QString &container)
+{
+    QMutexLocker locker(&indexMutex);
+    std::shared_ptr<QMutex> &mutex = loadMutexes[container];
+    if (!mutex) {
+        mutex = std::make_shared<QMutex>();
+    }
+    return mutex;
+}
+
+using IniSections = QHash<QString, QHash<QString, QString>>;
+
+IniSections parseIni(const QString &content)
+{
+    IniSections sections;
+    QString current;
+    for (const QString &rawLine : content.split(QLatin1Char('\n'))) {
+        const QString line = rawLine.trimmed();
+        if (line.isEmpty() || line.startsWith(QLatin1Char('#'))) {
+            continue;
+        }
+        if (line.startsWith(QLatin1Char('[')) && line.endsWith(QLatin1Char(']'))) {
+            current = line.mid(1, line.size() - 2);
+            continue;
+        }
+        const qsizetype separator = line.indexOf(QLatin1Char('='));
+        if (separator > 0) {
+            sections[current].insert(line.left(separator).trimmed(), line.mid(separator + 1).trimmed());
+        }
+    }
+    return sections;
+}
+
+QStringList listValue(const QString &value)
+{
+    QStringList items = value.split(QLatin1Char(','), Qt::SkipEmptyParts);
+    for (QString &item : items) {
+        item = item.trimmed();
+    }
+    return items;
+}
+
+ThemeDirectory parseDirectory(const QHash<QString, QString> &keys)
+{
+    ThemeDirectory directory;
+    directory.size = keys.value(u"Size"_s).toInt();
+    directory.scale = std::max(1, keys.value(u"Scale"_s, u"1"_s).toInt());
+    directory.minSize = keys.value(u"MinSize"_s, QString::number(directory.size)).toInt();
+    directory.maxSize = keys.value(u"MaxSize"_s, QString::number(directory.size)).toInt();
+    directory.threshold = keys.value(u"Threshold"_s, u"2"_s).toInt();
+
+    const QString type = keys.value(u"Type"_s, u"Threshold"_s);
+    if (type == u"Fixed"_s) {
+        directory.type = ThemeDirectory::Type::Fixed;
+    } else if (type == u"Scalable"_s) {
+        directory.type = ThemeDirectory::Type::Scalable;
+    }
+    return directory;
+}
+
+std::shared_ptr<const Theme> loadTheme(const QString &container, const QString &name)
+{
+    QString indexContent;
+    for (const QString &base : baseDirectories()) {
+        QByteArray data;
+        if (ContainerFs::readFile(container, base + QLatin1Char('/') + name + u"/index.theme"_s, data)) {
+            indexContent = QString::fromUtf8(data);
+            break;
+        }
+    }
+    if (indexContent.isEmpty()) {
+        return nullptr;
+    }
+
+    const IniSections sections = parseIni(indexContent);
+    const QHash<QString, QString> header = sections.value(u"Icon Theme"_s);
+
+    auto theme = std::make_shared<Theme>();
+    theme->inherits = listValue(header.value(u"Inherits"_s));
+
+    QHash<QString, int> directoryIndex;
+    const QStringList directoryNames = listValue(header.value(u"Directories"_s)) + listValue(header.value(u"ScaledDirectories"_s));
+    for (const QString &directoryName : directoryNames) {
+        if (directoryIndex.contains(directoryName) || !sections.contains(directoryName)) {
+            continue;
+        }
+        directoryIndex.insert(directoryName, theme->directories.size());
+        theme->directories.append(parseDirectory(sections.value(directoryName)));
+    }
+
+    // One walk per base directory instead of a listing per theme directory
+    for (const QString &base : baseDirectories()) {
+        const QString themeRoot = base + QLatin1Char('/') + name + QLatin1Char('/');
+        for (const QString &path : ContainerFs::files(container, themeRoot, ThemeWalkDepth)) {
+            const qsizetype slash = path.lastIndexOf(QLatin1Char('/'));
+            const QString fileName = path.mid(slash + 1);
+
+            const auto extension = std::find_if(extensions().cbegin(), extensions().cend(), [&fileName](const QString &suffix) {
+                return fileName.endsWith(suffix);
+            });
+            if (extension == extensions().cend()) {
+                continue;
+            }
+
+            const auto directory = directoryIndex.constFind(path.mid(themeRoot.size(), slash - themeRoot.size()));
+            if (directory == directoryIndex.cend()) {
+                continue;
+            }
+
+            theme->icons[fileName.chopped(extension->size())].append(
+                IconFile{*directory, static_cast<int>(std::distance(extensions().cbegin(), extension)), path});
+        }
+    }
+
+    for (QList<IconFile> &files : theme->icons) {
+        std::sort(files.begin(), files.end(), [](const IconFile &a, const IconFile &b) {
+            return a.directory != b.directory ? a.directory < b.directory : a.extension < b.extension;
+        });
+    }
+    return theme;
+}
+
+// Callers hold the loadMutex() of the container
+std::shared_ptr<const Theme> theme(const QString &container, const QString &name)
+{
+    {
+        QMutexLocker locker(&indexMutex);
+        ContainerIndex &index = indexes[container];
+        if (!index.age.isValid() || index.age.hasExpired(IndexLifetimeMs)) {
+            index.themes.clear();
+            index.age.start();
+        }
+
+        const auto cached = index.themes.constFind(name);
+        if (cached != index.themes.cend()) {
+            return *cached;
+        }
+    }
+
+    const std::shared_ptr<const Theme> loaded = loadTheme(container, name);
+    QMutexLocker locker(&indexMutex);
+    indexes[container].themes.insert(name, loaded);
+    return loaded;
+}
+
+bool matchesSize(const ThemeDirectory &directory, int size, int scale)
+{
+    if (directory.scale != scale) {
+        return false;
+    }
+    switch (directory.type) {
+    case ThemeDirectory::Type::Fixed:
+        return directory.size == size;
+    case ThemeDirectory::Type::Scalable:
+        return directory.minSize <= size && size <= directory.maxSize;
+    case ThemeDirectory::Type::Threshold:
+        return directory.size - directory.threshold <= size && size <= directory.size + directory.threshold;
+    }
+    return false;
+}
+
+int sizeDistance(const ThemeDirectory &directory, int size, int scale)
+{
+    const int scaledSize = size * scale;
+    const auto outside = [scaledSize, &directory](int minimum, int maximum) {
+        if (scaledSize < minimum * directory.scale) {
+            return minimum * directory.scale - scaledSize;
+        }
+        if (scaledSize > maximum * directory.scale) {
+            return scaledSize - maximum * directory.scale;
+        }
+        return 0;
+    };
+
+    switch (directory.type) {
+    case ThemeDirectory::Type::Fixed:
+        return std::abs(directory.size * directory.scale - scaledSize);
+    case ThemeDirectory::Type::Scalable:
+        return outside(directory.minSize, directory.maxSize);
+    case ThemeDirectory::Type::Threshold:
+        return outside(directory.size - directory.threshold, directory.size + directory.threshold);
+    }
+    return INT_MAX;
+}
+
+// LookupIcon of the specification: an exact size match first, else the closest size
+QString lookupIcon(const Theme &theme, const QString &iconName, int size, int scale)
+{
+    const auto files = theme.icons.constFind(iconName);
+    if (files == theme.icons.cend()) {
+        return {};
+    }
+
+    for (const IconFile &file : *files) {
+        if (matchesSize(theme.directories[file.directory], size, scale)) {
+            return file.path;
+        }
+    }
+
+    QString closest;
+    int minimalDistance = INT_MAX;
+    for (const IconFile &file : *files) {
+        const int distance = sizeDistance(theme.directories[file.directory], size, scale);
+        if (distance < minimalDistance) {
+            closest = file.path;
+            minimalDistance = distance;
+        }
+    }
+    return closest;
+}
+
+// FindIconHelper of the specification, callers hold the loadMutex() of the container
+QString findIconHelper(const QString &container, const QString &iconName, int size, int scale, const QString &themeName, QStringList &visited)
+{
+    if (visited.contains(themeName)) {
+        return {};
+    }
+    visited.append(themeName);
+
+    const std::shared_ptr<const Theme> current = theme(container, themeName);
+    if (!current) {
+        return {};
+    }
+
+    const QString path = lookupIcon(*current, iconName, size, scale);
+    if (!path.isEmpty()) {
+        return path;
+    }
+
+    for (const QString &parent : current->inherits) {
+        const QString inherited = findIconHelper(container, iconName, size, scale, parent, visited);
+        if (!inherited.isEmpty()) {
+            return inherited;
+        }
+    }
+    return {};
+}
+
+QString lookupFallbackIcon(const QString &container, const QString &iconName)
+{
+    for (const QString &directory : fallbackDirectories()) {
+        for (const QString &extension : extensions()) {
+            const QString path = directory + QLatin1Char('/') + iconName + extension;
+            if (ContainerFs::stamp(container, path).exists()) {
+                return path;
+            }
+        }
+    }
+    return {};
+}
+
+// Callers hold the loadMutex() of the container
+QString findIcon(const QString &container, const QString &iconName, int size, int scale, const QString &preferred)
+{
+    if (iconName.startsWith(QLatin1Char('/'))) {
+        return ContainerFs::stamp(container, iconName).exists() ? iconName : QString();
+    }
+
+    // Legacy entries name the file, with its extension, instead of the icon
+    QString name = iconName;
+    for (const QString &extension : extensions()) {
+        if (name.endsWith(extension)) {
+            name.chop(extension.size());
+            break;
+        }
+    }
+    if (name.isEmpty() || name.contains(QLatin1Char('/'))) {
+        return {};
+    }
+
+    QStringList visited;
+    if (!preferred.isEmpty()) {
+        const QString path = findIconHelper(container, name, size, scale, preferred, visited);
+        if (!path.isEmpty()) {
+            return path;
+        }
+    }
+
+    const QString path = findIconHelper(container, name, size, scale, u"hicolor"_s, visited);
+    if (!path.isEmpty()) {
+        return path;
+    }
+    return lookupFallbackIcon(container, name);
+}
+}
+
+namespace IconTheme
+{
+void setPreferredTheme(const QString &theme)
+{
+    QMutexLocker locker(&indexMutex);
+    preferredTheme = theme;
+}
+
+QHash<QString, QString> resolveAll(const QString &container, const QStringList &iconNames, int size, int scale)
+{
+    QHash<QString, QString> paths;
+
+    QString preferred;
+    {
+        QMutexLocker locker(&indexMutex);
+        preferred = preferredTheme;
+    }
+
+    // Building a theme index is the expensive part, threads resolving the same container wait for it
+    const std::shared_ptr<QMutex> mutex = loadMutex(container);
+    QMutexLocker locker(mutex.get());
+    for (const QString &iconName : iconNames) {
+        const QString trimmed = iconName.trimmed();
+        if (trimmed.isEmpty() || paths.contains(iconName)) {
+            continue;
+        }
+
+        const QString path = findIcon(container, trimmed, size, scale, preferred);
+        if (!path.isEmpty()) {
+            paths.insert(iconName, path);
+        }
+    }
+    return paths;
+}
+
+QString resolve(const QString &container, const QString &iconName, int size, int scale)
+{
+    return resolveAll(container, {iconName}, size, scale).value(iconName);
+}
+
+void forget(const QString &container)
+{
+    QMutexLocker locker(&indexMutex);
+    indexes.remove(container);
+    loadMutexes.remove(container);
+}
+}
@@ -0,0 +1,42 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+/**
+ * Icon lookup inside a container following the freedesktop icon theme specification.
+ *
+ * Themes are read from index.theme in the container's icon directories, including their
+ * Inherits chain and the Size, Scale, Type, MinSize, MaxSize and Threshold of every
+ * directory. Each theme of a container is indexed once with a single walk of its
+ * directories, later lookups are hash lookups. Lookups go through the preferred theme,
+ * its parents and hicolor, then the unthemed fallback directories such as
+ * /usr/share/pixmaps. Safe to call from any thread.
+ */
+namespace IconTheme
+{
+/**
+ * @brief Sets the theme tried before hicolor, usually the one of the host
+ */
+void setPreferredTheme(const QString &theme);
+
+/**
+ * @brief Resolves icon names to files inside the container
+ * @param iconNames Icon names or absolute paths, as found in Icon= of desktop entries
+ * @param size Icon size in device independent pixels
+ * @param scale Device pixel ratio the icons are shown at
+ * @return Absolute container path of the best matching file by icon name, missing when none matched
+ */
+QHash<QString, QString> resolveAll(const QString &container, const QStringList &iconNames, int size, int scale = 1);
+
+QString resolve(const QString &container, const QString &iconName, int size, int scale = 1);
+
+// Drops the index of a removed container
+void forget(const QString &container);
+}
@@ -0,0 +1,346 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "imagereclaim.h"
+
+#include "distroboxcli.h"
+#include "registrymirror.h"
+#include "templateimages.h"
+
+#include <KConfigGroup>
+#include <KFormat>
+#include <KSharedConfig>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+
+#include <algorithm>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+struct LocalImage {
+    QString id;
+    QStringList tags;
+    QStringList layers;
+    qint64 sizeBytes = 0;
+};
+
+QString normalizedId(QString id)
+{
+    id = id.trimmed();
+    if (id.startsWith(u"sha256:"_s)) {
+        id.remove(0, 7);
+    }
+    return id;
+}
+
+QStringList splitLines(const QString &output)
+{
+    return output.split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+}
+
+// Images created or pulled for Kontainer and distrobox containers, remembered after the containers are gone
+constexpr int MaxKnownImages = 500;
+
+KConfigGroup reclaimGroup()
+{
+    return KConfigGroup(KSharedConfig::openConfig(), u"ImageReclaim"_s);
+}
+
+// Image IDs referenced by any container, distrobox or not, so foreign containers are never broken.
+// The ones of distrobox containers are also collected into distroboxUsed.
+bool usedImageIds(const QString &manager, QSet<QString> &used, QStringList *distroboxUsed = nullptr)
+{
+    bool success = false;
+    const QStringList containerIds = splitLines(DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"ps"_s, u"-aq"_s, u"--no-trunc"_s}), success));
+    if (!success) {
+        return false;
+    }
+    if (containerIds.isEmpty()) {
+        return true;
+    }
+
+    const QString format = u"{{.Image}}|{{index .Config.Labels \"manager\"}}"_s;
+    const QString output =
+        DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"inspect"_s, u"--type"_s, u"container"_s, u"--format"_s, format}) << containerIds, success);
+    if (!success) {
+        return false;
+    }
+
+    for (const QString &line : splitLines(output)) {
+        const QString id = normalizedId(line.section(QLatin1Char('|'), 0, 0));
+        used.insert(id);
+        if (distroboxUsed && line.section(QLatin1Char('|'), 1) == u"distrobox"_s) {
+            distroboxUsed->append(id);
+        }
+    }
+    return true;
+}
+
+bool localImages(const QString &manager, QList<LocalImage> &images)
+{
+    bool success = false;
+    QStringList ids = splitLines(DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"images"_s, u"-q"_s, u"--no-trunc"_s}), success));
+    if (!success) {
+        return false;
+    }
+
+    ids.removeDuplicates();
+    if (ids.isEmpty()) {
+        return true;
+    }
+
+    const QString format = u"{{.Id}}|{{.Size}}|{{join .RepoTags \",\"}}|{{join .RootFS.Layers \",\"}}"_s;
+    const QString output = DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"image"_s, u"inspect"_s, u"--format"_s, format}) << ids, success);
+    if (!success) {
+        return false;
+    }
+
+    for (const QString &line : splitLines(output)) {
+        const QStringList fields = line.split(QLatin1Char('|'));
+        if (fields.size() < 4) {
+            continue;
+        }
+
+        LocalImage image;
+        image.id = normalizedId(fields[0]);
+        image.sizeBytes = fields[1].toLongLong();
+        image.tags = fields[2].split(QLatin1Char(','), Qt::SkipEmptyParts);
+        image.layers = fields[3].split(QLatin1Char(','), Qt::SkipEmptyParts);
+        images.append(image);
+    }
+    return true;
+}
+
+// Layer sizes are not exposed by inspect. Approximate them by attributing to the layers an
+// image adds on top of its deepest local ancestor (an image whose layers are a prefix of
+// its own) the difference of their sizes, spread evenly.
+QHash<QString, qint64> estimateLayerSizes(QList<LocalImage> images)
+{
+    std::sort(images.begin(), images.end(), [](const LocalImage &a, const LocalImage &b) {
+        return a.layers.size() < b.layers.size();
+    });
+
+    QHash<QString, qint64> layerSizes;
+    for (int i = 0; i < images.size(); ++i) {
+        const LocalImage &image = images[i];
+
+        qsizetype ancestorLayers = 0;
+        qint64 ancestorSize = 0;
+        for (int j = 0; j < i; ++j) {
+            const LocalImage &candidate = images[j];
+            if (candidate.layers.size() <= ancestorLayers || candidate.layers.size() >= image.layers.size()) {
+                continue;
+            }
+            if (std::equal(candidate.layers.cbegin(), candidate.layers.cend(), image.layers.cbegin())) {
+                ancestorLayers = candidate.layers.size();
+                ancestorSize = candidate.sizeBytes;
+            }
+        }
+
+        const qsizetype ownLayers = image.layers.size() - ancestorLayers;
+        if (ownLayers <= 0) {
+            continue;
+        }
+
+        const qint64 perLayer = std::max<qint64>(0, image.sizeBytes - ancestorSize) / ownLayers;
+        for (qsizetype k = ancestorLayers; k < image.layers.size(); ++k) {
+            if (!layerSizes.contains(image.layers[k])) {
+                layerSizes.insert(image.layers[k], perLayer);
+            }
+        }
+    }
+    return layerSizes;
+}
+
+bool isKept(const LocalImage &image, const QStringList &keptImages)
+{
+    return std::any_of(image.tags.cbegin(), image.tags.cend(), [&keptImages](const QString &tag) {
+        return keptImages.contains(RegistryMirror::normalizedReference(tag));
+    });
+}
+
+bool isKnown(const LocalImage &image, const QStringList &knownImages)
+{
+    return knownImages.contains(image.id) || isKept(image, knownImages);
+}
+}
+
+namespace ImageReclaim
+{
+Plan plan(const QStringList &keptImages, const QStringList &knownImages)
+{
+    Plan result;
+
+    const QString manager = DistroboxCli::containerManager();
+    QSet<QString> used;
+    QList<LocalImage> images;
+    if (!usedImageIds(manager, used, &result.distroboxImages) || !localImages(manager, images)) {
+        return result;
+    }
+
+    // Pinned base images and templates are kept on purpose, and images Kontainer or distrobox
+    // never dealt with belong to someone else: count them all as used
+    for (const LocalImage &image : std::as_const(images)) {
+        if (isKept(image, keptImages) || !isKnown(image, knownImages)) {
+            used.insert(image.id);
+        }
+    }
+
+    QSet<QString> keptLayers;
+    for (const LocalImage &image : std::as_const(images)) {
+        if (used.contains(image.id)) {
+            for (const QString &layer : image.layers) {
+                keptLayers.insert(layer);
+            }
+        }
+    }
+
+    const QHash<QString, qint64> layerSizes = estimateLayerSizes(images);
+    QSet<QString> countedLayers;
+
+    for (const LocalImage &image : std::as_const(images)) {
+        if (used.contains(image.id)) {
+            continue;
+        }
+
+        Candidate candidate;
+        candidate.id = image.id;
+        candidate.tags = image.tags;
+        candidate.sizeBytes = image.sizeBytes;
+
+        // A layer shared by several candidates is only counted for the first one
+        for (const QString &layer : image.layers) {
+            if (keptLayers.contains(layer) || countedLayers.contains(layer)) {
+                continue;
+            }
+            countedLayers.insert(layer);
+            candidate.freedBytes += layerSizes.value(layer);
+        }
+
+        result.reclaimableBytes += candidate.freedBytes;
+        result.candidates.append(candidate);
+    }
+
+    std::sort(result.candidates.begin(), result.candidates.end(), [](const Candidate &a, const Candidate &b) {
+        return a.freedBytes > b.freedBytes;
+    });
+
+    result.valid = true;
+    return result;
+}
+
+QString planJson(const Plan &plan)
+{
+    const KFormat format;
+
+    QJsonObject object;
+    object[u"valid"_s] = plan.valid;
+    object[u"reclaimableBytes"_s] = plan.reclaimableBytes;
+    object[u"reclaimableSize"_s] = format.formatByteSize(plan.reclaimableBytes);
+
+    QJsonArray candidates;
+    for (const Candidate &candidate : plan.candidates) {
+        QJsonObject entry;
+        entry[u"id"_s] = candidate.id;
+        entry[u"shortId"_s] = candidate.id.left(12);
+        entry[u"tags"_s] = QJsonArray::fromStringList(candidate.tags);
+        entry[u"sizeBytes"_s] = candidate.sizeBytes;
+        entry[u"size"_s] = format.formatByteSize(candidate.sizeBytes);
+        entry[u"freedBytes"_s] = candidate.freedBytes;
+        entry[u"freedSize"_s] = format.formatByteSize(candidate.freedBytes);
+        candidates.append(entry);
+    }
+    object[u"images"_s] = candidates;
+
+    return QString::fromUtf8(QJsonDocument(object).toJson());
+}
+
+QStringList keptImages()
+{
+    QStringList kept = RegistryMirror::settings().pinnedImages;
+    for (const TemplateImages::Template &entry : TemplateImages::tracked()) {
+        kept.append(RegistryMirror::normalizedReference(entry.image));
+    }
+    return kept;
+}
+
+QStringList knownImages()
+{
+    return reclaimGroup().readEntry("KnownImages", QStringList());
+}
+
+void rememberImages(const QStringList &images)
+{
+    QStringList known = knownImages();
+    bool changed = false;
+    for (const QString &image : images) {
+        // Either an image ID or a reference
+        const QString id = normalizedId(image);
+        const bool isId = id.size() == 64 && std::all_of(id.cbegin(), id.cend(), [](QChar c) {
+                              return c.isDigit() || (c >= QLatin1Char('a') && c <= QLatin1Char('f'));
+                          });
+        const QString entry = isId ? id : RegistryMirror::normalizedReference(image);
+        if (!entry.isEmpty() && !known.contains(entry)) {
+            known.append(entry);
+            changed = true;
+        }
+    }
+    if (!changed) {
+        return;
+    }
+
+    if (known.size() > MaxKnownImages) {
+        known = known.mid(known.size() - MaxKnownImages);
+    }
+    KConfigGroup group = reclaimGroup();
+    group.writeEntry("KnownImages", known);
+    group.sync();
+}
+
+bool reclaim(const QStringList &imageIds, const QStringList &keptImages, const QStringList &knownImages)
+{
+    if (imageIds.isEmpty()) {
+        return true;
+    }
+
+    // Re-check right before removing: a container may have been created from one of these
+    // meanwhile, or the image been pinned or made a template
+    const QString manager = DistroboxCli::containerManager();
+    QSet<QString> used;
+    QList<LocalImage> images;
+    if (!usedImageIds(manager, used) || !localImages(manager, images)) {
+        return false;
+    }
+
+    QSet<QString> requested;
+    for (const QString &id : imageIds) {
+        requested.insert(normalizedId(id));
+    }
+
+    // Tagged images are removed through their tags: removing a multi-tagged image by ID
+    // needs --force, which podman also applies to containers using it
+    QStringList references;
+    for (const LocalImage &image : std::as_const(images)) {
+        if (!requested.contains(image.id) || used.contains(image.id) || isKept(image, keptImages) || !isKnown(image, knownImages)) {
+            continue;
+        }
+        references.append(image.tags.isEmpty() ? QStringList{image.id} : image.tags);
+    }
+
+    // No image prune afterwards: it would also remove dangling images of other tools the user
+    // never saw. The layers only the removed images used go with them, and dangling images of
+    // Kontainer's own containers are remembered by ID, so they are offered like the others.
+    bool success = true;
+    if (!references.isEmpty()) {
+        DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"rmi"_s}) << references, success, DistroboxCli::LongTimeoutMs);
+    }
+    return success;
+}
+}
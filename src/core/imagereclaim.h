@@ -0,0 +1,68 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+namespace ImageReclaim
+{
+struct Candidate {
+    QString id; ///< Full image ID without the "sha256:" prefix
+    QStringList tags;
+    qint64 sizeBytes = 0; ///< Size reported by the container manager, shared layers included
+    qint64 freedBytes = 0; ///< Estimated bytes freed when this image is removed together with the other candidates
+};
+
+struct Plan {
+    QList<Candidate> candidates;
+    qint64 reclaimableBytes = 0;
+    QStringList distroboxImages; ///< IDs of the images distrobox containers use now, for rememberImages()
+    bool valid = false;
+};
+
+/**
+ * Works out which local images are used by no container and how much removing them frees.
+ *
+ * Only images among knownImages are candidates, so images pulled by other tools are never
+ * offered. Layers still referenced by an image that stays are not counted as freed. Images
+ * among keptImages count as used. Nothing is removed. Blocks, call it off the GUI thread.
+ */
+Plan plan(const QStringList &keptImages, const QStringList &knownImages);
+QString planJson(const Plan &plan);
+
+/**
+ * @brief Normalized references of the images kept on purpose: pinned images and templates
+ *
+ * Reads the application configuration, call it on the GUI thread.
+ */
+QStringList keptImages();
+
+/**
+ * @brief Image IDs and normalized references Kontainer or distrobox created or pulled
+ *
+ * Reads the application configuration, call it on the GUI thread.
+ */
+QStringList knownImages();
+
+/**
+ * @brief Remembers images as created or pulled for Kontainer, by ID or by reference
+ *
+ * Writes the application configuration, call it on the GUI thread.
+ */
+void rememberImages(const QStringList &images);
+
+/**
+ * Removes exactly the given images in one batch, nothing else.
+ *
+ * Images that gained a container or are among keptImages since the plan was computed, and
+ * images not among knownImages, are skipped. Layers only those images used go with them.
+ * There is no global prune, it would also remove dangling images of other tools.
+ * @return true if every requested image that was still unused got removed
+ */
+bool reclaim(const QStringList &imageIds, const QStringList &keptImages, const QStringList &knownImages);
+}
@@ -0,0 +1,140 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "launcherentries.h"
+
+#include "containermetadata.h"
+#include "distroboxcli.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <iterator>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+enum class Result {
+    Unchanged,
+    Written,
+    Failed,
+};
+
+QString iconsDirectory()
+{
+    return QDir::homePath() + u"/.local/share/icons/distrobox"_s;
+}
+
+// Keeps the icon of an existing entry, distrobox may have downloaded a distribution logo for it
+QString iconFor(const QString &container, const QString &existingPath)
+{
+    if (QFile::exists(existingPath)) {
+        const QString icon = QSettings(existingPath, QSettings::IniFormat).value(u"Desktop Entry/Icon"_s).toString();
+        if (!icon.isEmpty()) {
+            return icon;
+        }
+    }
+
+    const std::optional<ContainerMetadata::Metadata> metadata = ContainerMetadata::cached(container);
+    if (metadata && !metadata->osId.isEmpty()) {
+        for (const QString &extension : {u"svg"_s, u"png"_s}) {
+            const QString path = u"%1/%2.%3"_s.arg(iconsDirectory(), metadata->osId, extension);
+            if (QFile::exists(path)) {
+                return path;
+            }
+        }
+    }
+
+    const QString terminalIcon = iconsDirectory() + u"/terminal-distrobox-icon.svg"_s;
+    return QFile::exists(terminalIcon) ? terminalIcon : u"preferences-virtualization-container"_s;
+}
+
+QByteArray entryContent(const QString &container, const QString &distrobox, const QString &icon)
+{
+    QString name = container;
+    name[0] = name[0].toUpper();
+
+    return u"[Desktop Entry]\n"
+           "Name=%1\n"
+           "GenericName=Terminal entering %1\n"
+           "Comment=Terminal entering %1\n"
+           "Categories=Distrobox;System;Utility\n"
+           "Exec=%2 enter %3\n"
+           "Icon=%4\n"
+           "Keywords=distrobox;\n"
+           "NoDisplay=false\n"
+           "Terminal=true\n"
+           "TryExec=%2\n"
+           "Type=Application\n"
+           "Actions=Remove;\n"
+           "\n"
+           "[Desktop Action Remove]\n"
+           "Name=Remove %1 from system\n"
+           "Exec=%2 rm %3\n"_s.arg(name, distrobox, container, icon)
+        .toUtf8();
+}
+
+Result writeEntry(const QString &container, const QString &distrobox)
+{
+    const QString path = LauncherEntries::entryPath(container);
+    const QByteArray content = entryContent(container, distrobox, iconFor(container, path));
+
+    QFile existing(path);
+    if (existing.open(QIODevice::ReadOnly) && existing.readAll() == content) {
+        return Result::Unchanged;
+    }
+    existing.close();
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size() || !file.commit()) {
+        qWarning() << "Could not write the launcher entry" << path << file.errorString();
+        return Result::Failed;
+    }
+    return Result::Written;
+}
+}
+
+namespace LauncherEntries
+{
+bool generate(const QStringList &containers)
+{
+    const QString directory = QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation);
+    QDir().mkpath(directory);
+
+    // The menu runs the entry outside of our environment, it gets the absolute path like distrobox writes
+    QString distrobox = QStandardPaths::findExecutable(u"distrobox"_s);
+    if (distrobox.isEmpty()) {
+        distrobox = u"distrobox"_s;
+    }
+
+    QStringList valid;
+    std::copy_if(containers.cbegin(), containers.cend(), std::back_inserter(valid), [](const QString &container) {
+        return !container.isEmpty() && !container.contains(QLatin1Char('/'));
+    });
+
+    const QList<Result> results = QtConcurrent::blockingMapped<QList<Result>>(valid, [&distrobox](const QString &container) {
+        return writeEntry(container, distrobox);
+    });
+
+    if (results.contains(Result::Written)) {
+        // Optional on most desktops, the menus also notice the new files by themselves
+        bool refreshed = false;
+        DistroboxCli::runCommand(DistroboxCli::Command(u"update-desktop-database"_s, {directory}), refreshed);
+    }
+    return !results.contains(Result::Failed);
+}
+
+QString entryPath(const QString &container)
+{
+    return QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation) + QLatin1Char('/') + container + u".desktop"_s;
+}
+}
@@ -0,0 +1,27 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include <QStringList>
+
+/**
+ * Host menu entries that open a terminal in a container, as distrobox generate-entry writes them.
+ *
+ * The entries are computed from what is already known about the containers, so no container
+ * is started or inspected. Containers are handled concurrently, an entry is only rewritten when
+ * its content changed, and the desktop database is refreshed once at the end.
+ */
+namespace LauncherEntries
+{
+/**
+ * @brief Writes the launcher entries of the containers
+ * @return false if an entry could not be written
+ */
+bool generate(const QStringList &containers);
+
+// Path of the launcher entry of a container
+QString entryPath(const QString &container);
+}
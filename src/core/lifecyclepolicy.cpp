@@ -0,0 +1,291 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "lifecyclepolicy.h"
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QPointer>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QStringList>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+constexpr int IdleCheckIntervalMs = 60 * 1000;
+constexpr int HoverPrewarmCooldownSecs = 5 * 60;
+constexpr double IdleCpuPercent = 2.0;
+
+KConfigGroup lifecycleGroup()
+{
+    return KConfigGroup(KSharedConfig::openConfig(), u"Lifecycle"_s);
+}
+
+QStringList configuredContainers()
+{
+    return lifecycleGroup().groupList();
+}
+
+// The host's autostart directory, also from inside the Flatpak sandbox, where the
+// configuration location points into the sandbox
+QString autostartFilePath()
+{
+    const QString configHome = DistroboxCli::isFlatpak() ? QDir::homePath() + u"/.config"_s
+                                                         : QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation);
+    return configHome + u"/autostart/io.github.DenysMb.Kontainer-prestart.desktop"_s;
+}
+
+QString autostartEntry()
+{
+    const QString exec = DistroboxCli::isFlatpak() ? u"flatpak run --command=kontainer io.github.DenysMb.Kontainer --prestart"_s : u"kontainer --prestart"_s;
+    return u"[Desktop Entry]\n"
+           u"Type=Application\n"
+           u"Name=Kontainer container pre-start\n"
+           u"Comment=Starts the containers Kontainer was asked to start at login\n"
+           u"Exec=%1\n"
+           u"Icon=io.github.DenysMb.Kontainer\n"
+           u"Terminal=false\n"
+           u"NoDisplay=true\n"
+           u"X-GNOME-Autostart-Delay=10\n"_s.arg(exec);
+}
+}
+
+LifecyclePolicy::LifecyclePolicy(QObject *parent)
+    : QObject(parent)
+{
+    m_idleTimer.setInterval(IdleCheckIntervalMs);
+    connect(&m_idleTimer, &QTimer::timeout, this, &LifecyclePolicy::checkIdleContainers);
+    updateIdleMonitor();
+    updateAutostart();
+}
+
+LifecyclePolicy::Policy LifecyclePolicy::policy(const QString &container) const
+{
+    const KConfigGroup group = lifecycleGroup().group(container);
+
+    Policy result;
+    result.startAtLogin = group.readEntry("StartAtLogin", false);
+    result.startOnHover = group.readEntry("StartOnHover", false);
+    result.idleStopMinutes = group.readEntry("IdleStopMinutes", 0);
+    return result;
+}
+
+void LifecyclePolicy::setPolicy(const QString &container, const Policy &policy)
+{
+    KConfigGroup group = lifecycleGroup().group(container);
+
+    if (!policy.startAtLogin && !policy.startOnHover && policy.idleStopMinutes <= 0) {
+        group.deleteGroup();
+    } else {
+        group.writeEntry("StartAtLogin", policy.startAtLogin);
+        group.writeEntry("StartOnHover", policy.startOnHover);
+        group.writeEntry("IdleStopMinutes", qMax(0, policy.idleStopMinutes));
+    }
+    group.sync();
+
+    m_lastActive.remove(container);
+    m_cpuSamples.remove(container);
+    updateIdleMonitor();
+    updateAutostart();
+}
+
+QStringList LifecyclePolicy::loginContainers()
+{
+    QStringList containers;
+    const KConfigGroup group = lifecycleGroup();
+    for (const QString &container : group.groupList()) {
+        if (group.group(container).readEntry("StartAtLogin", false)) {
+            containers.append(container);
+        }
+    }
+    return containers;
+}
+
+// Entering with a no-op waits for the distrobox init to complete, which is the expensive part
+// of the first enterContainer(). On an already running container this is a cheap exec.
+DistroboxCli::Command LifecyclePolicy::prewarmCommand(const QString &container)
+{
+    return DistroboxCli::Command(u"distrobox"_s, {u"enter"_s, container, u"--"_s, u"true"_s});
+}
+
+// Installed while any container starts at login, removed with the last one
+void LifecyclePolicy::updateAutostart()
+{
+    const QString path = autostartFilePath();
+    if (loginContainers().isEmpty()) {
+        QFile::remove(path);
+        return;
+    }
+    if (QFile::exists(path)) {
+        return;
+    }
+
+    QDir().mkpath(QFileInfo(path).path());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Could not write the autostart entry" << path;
+        return;
+    }
+    file.write(autostartEntry().toUtf8());
+    file.commit();
+}
+
+void LifecyclePolicy::prewarmOnHover(const QString &container)
+{
+    if (!policy(container).startOnHover) {
+        return;
+    }
+
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    const QDateTime last = m_lastPrewarm.value(container);
+    if (last.isValid() && last.secsTo(now) < HoverPrewarmCooldownSecs) {
+        return;
+    }
+
+    m_lastPrewarm.insert(container, now);
+    startContainer(container);
+}
+
+void LifecyclePolicy::startContainer(const QString &container)
+{
+    QPointer<LifecyclePolicy> self(this);
+    DistroboxCli::runCommandAsync(prewarmCommand(container), this, [self, container](bool success, const QString &) {
+        if (self && success) {
+            // A pre-warmed container starts its idle countdown now
+            self->m_lastActive.insert(container, QDateTime::currentDateTimeUtc());
+            Q_EMIT self->containerStarted(container);
+        }
+    });
+}
+
+void LifecyclePolicy::updateIdleMonitor()
+{
+    bool anyIdlePolicy = false;
+    for (const QString &container : configuredContainers()) {
+        if (policy(container).idleStopMinutes > 0) {
+            anyIdlePolicy = true;
+            break;
+        }
+    }
+
+    if (anyIdlePolicy && !m_idleTimer.isActive()) {
+        m_idleTimer.start();
+    } else if (!anyIdlePolicy) {
+        m_idleTimer.stop();
+        m_lastActive.clear();
+        m_cpuSamples.clear();
+    }
+}
+
+void LifecyclePolicy::checkIdleContainers()
+{
+    const QString manager = DistroboxCli::containerManager();
+    // podman's CPU percentage averages over the container's whole lifetime, so a container busy
+    // an hour ago would never look idle. Its CPU time is compared with the previous check
+    // instead. docker's percentage already covers the last second.
+    const bool isPodman = manager.endsWith(u"podman"_s);
+    const DistroboxCli::Command statsCmd(manager, {u"stats"_s, u"--no-stream"_s, u"--format"_s, isPodman ? u"{{.Name}}|{{.CPUNano}}"_s : u"{{.Name}}|{{.CPUPerc}}"_s});
+
+    QPointer<LifecyclePolicy> self(this);
+    DistroboxCli::runCommandAsync(statsCmd, this, [self, manager, isPodman](bool success, const QString &output) {
+        if (!self || !success) {
+            return;
+        }
+
+        // Only running containers show up in stats. Without a previous sample a container
+        // counts as busy, its countdown starts with the next check.
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        QHash<QString, double> cpuUsage;
+        QHash<QString, CpuSample> samples;
+        for (const QString &line : output.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+            const QString name = line.section(QLatin1Char('|'), 0, 0).trimmed();
+            QString cpu = line.section(QLatin1Char('|'), 1).trimmed();
+            if (!isPodman) {
+                cpu.remove(QLatin1Char('%'));
+                cpuUsage.insert(name, cpu.toDouble());
+                continue;
+            }
+
+            const CpuSample sample{cpu.toLongLong(), now};
+            const CpuSample previous = self->m_cpuSamples.value(name);
+            const qint64 elapsedMs = previous.taken.isValid() ? previous.taken.msecsTo(now) : 0;
+            cpuUsage.insert(name,
+                            elapsedMs > 0 && sample.cpuNanos >= previous.cpuNanos ? (sample.cpuNanos - previous.cpuNanos) / (elapsedMs * 1e4)
+                                                                                 : IdleCpuPercent);
+            samples.insert(name, sample);
+        }
+        if (isPodman) {
+            // Stopped containers drop out, a restart begins a new series
+            self->m_cpuSamples = samples;
+        }
+
+        QStringList monitored;
+        for (const QString &container : configuredContainers()) {
+            if (cpuUsage.contains(container) && self->policy(container).idleStopMinutes > 0) {
+                monitored.append(container);
+            }
+        }
+
+        if (monitored.isEmpty()) {
+            return;
+        }
+
+        const DistroboxCli::Command inspectCmd =
+            DistroboxCli::Command(manager, {u"inspect"_s, u"--type"_s, u"container"_s, u"--format"_s, u"{{.Name}}|{{len .ExecIDs}}"_s}) << monitored;
+        DistroboxCli::runCommandAsync(inspectCmd, self.data(), [self, cpuUsage](bool inspected, const QString &inspectOutput) {
+            if (!self || !inspected) {
+                return;
+            }
+
+            QHash<QString, int> execSessions;
+            for (const QString &line : inspectOutput.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+                QString name = line.section(QLatin1Char('|'), 0, 0).trimmed();
+                // docker prefixes container names with a slash
+                if (name.startsWith(QLatin1Char('/'))) {
+                    name.remove(0, 1);
+                }
+                execSessions.insert(name, line.section(QLatin1Char('|'), 1).trimmed().toInt());
+            }
+
+            self->applyIdleSamples(cpuUsage, execSessions);
+        });
+    });
+}
+
+void LifecyclePolicy::applyIdleSamples(const QHash<QString, double> &cpuUsage, const QHash<QString, int> &execSessions)
+{
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+
+    for (auto it = execSessions.cbegin(); it != execSessions.cend(); ++it) {
+        const QString &container = it.key();
+        const bool busy = it.value() > 0 || cpuUsage.value(container) >= IdleCpuPercent;
+
+        if (busy || !m_lastActive.contains(container)) {
+            m_lastActive.insert(container, now);
+            continue;
+        }
+
+        const int idleMinutes = policy(container).idleStopMinutes;
+        if (idleMinutes <= 0 || m_lastActive.value(container).secsTo(now) < idleMinutes * 60) {
+            continue;
+        }
+
+        m_lastActive.remove(container);
+
+        const DistroboxCli::Command command(u"distrobox"_s, {u"stop"_s, u"--yes"_s, container});
+        QPointer<LifecyclePolicy> self(this);
+        DistroboxCli::runCommandAsync(command, this, [self, container](bool success, const QString &) {
+            if (self && success) {
+                Q_EMIT self->containerStopped(container);
+            }
+        });
+    }
+}
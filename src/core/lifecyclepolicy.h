@@ -0,0 +1,78 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include "distroboxcli.h"
+
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+/**
+ * @class LifecyclePolicy
+ * @brief Starts containers ahead of use and stops the ones left idle
+ *
+ * Policies are stored per container in the application config. A container can be
+ * started at login or when the pointer hovers its card, so entering it does not pay the
+ * distrobox init. Login starts run from an XDG autostart entry, installed while any
+ * container asks for it, which runs "kontainer --prestart" without opening the window.
+ * Running containers with an idle threshold are stopped once they had no exec session
+ * and low CPU usage for that long.
+ */
+class LifecyclePolicy : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Policy {
+        bool startAtLogin = false; ///< Start when the user logs in
+        bool startOnHover = false; ///< Start when the container card is hovered
+        int idleStopMinutes = 0; ///< Stop after this many idle minutes, 0 disables
+    };
+
+    explicit LifecyclePolicy(QObject *parent = nullptr);
+
+    Policy policy(const QString &container) const;
+    void setPolicy(const QString &container, const Policy &policy);
+
+    /**
+     * @brief Containers whose policy asks to be started at login
+     */
+    static QStringList loginContainers();
+
+    /**
+     * @brief Command starting the container and waiting for its distrobox init
+     */
+    static DistroboxCli::Command prewarmCommand(const QString &container);
+
+    /**
+     * @brief Starts the container if its policy asks to be started on hover
+     */
+    void prewarmOnHover(const QString &container);
+
+Q_SIGNALS:
+    void containerStarted(const QString &container);
+    void containerStopped(const QString &container);
+
+private:
+    void startContainer(const QString &container);
+    void updateIdleMonitor();
+    void checkIdleContainers();
+    void applyIdleSamples(const QHash<QString, double> &cpuUsage, const QHash<QString, int> &execSessions);
+    void updateAutostart();
+
+    struct CpuSample {
+        qint64 cpuNanos = 0; ///< CPU time the container used since it started
+        QDateTime taken;
+    };
+
+    QTimer m_idleTimer;
+    QHash<QString, CpuSample> m_cpuSamples; ///< Previous sample of each running container, podman only
+    QHash<QString, QDateTime> m_lastActive; ///< Last time each monitored container was seen busy
+    QHash<QString, QDateTime> m_lastPrewarm; ///< Throttles hover pre-warming
+};
@@ -0,0 +1,44 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "operationwatchdog.h"
+
+namespace
+{
+constexpr int CheckIntervalMs = 2000;
+constexpr qint64 StallAfterMs = 20 * 1000;
+// Quiet commands are only judged by how long they run, a commit of a large container takes minutes
+constexpr qint64 QuietStallAfterMs = 15 * 60 * 1000;
+}
+
+OperationWatchdog::OperationWatchdog(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setInterval(CheckIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &OperationWatchdog::check);
+    m_timer.start();
+}
+
+QList<DistroboxCli::Operation> OperationWatchdog::stalledOperations() const
+{
+    return m_stalled;
+}
+
+void OperationWatchdog::check()
+{
+    QList<DistroboxCli::Operation> stalled;
+    for (const DistroboxCli::Operation &operation : DistroboxCli::runningOperations()) {
+        if (operation.quiet ? operation.runningMs >= QuietStallAfterMs : operation.silentMs >= StallAfterMs) {
+            stalled.append(operation);
+        }
+    }
+
+    if (stalled.isEmpty() && m_stalled.isEmpty()) {
+        return;
+    }
+
+    m_stalled = stalled;
+    Q_EMIT stalledOperationsChanged();
+}
@@ -0,0 +1,45 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include "distroboxcli.h"
+
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+/**
+ * @class OperationWatchdog
+ * @brief Spots container manager commands that stopped making progress
+ *
+ * A command counts as stalled once it wrote no output for a while, which is what a
+ * podman stuck on its storage lock or a dead registry looks like. Pulls and installs
+ * keep printing progress and are left alone. Commands marked quiet, which print nothing
+ * while they work, only count as stalled once they ran for far longer than usual. The
+ * stalled commands are offered for cancelling, so a misbehaving runtime never leaves the
+ * UI waiting without recourse.
+ */
+class OperationWatchdog : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit OperationWatchdog(QObject *parent = nullptr);
+
+    QList<DistroboxCli::Operation> stalledOperations() const;
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted on every check while commands are stalled, and once when none are left
+     */
+    void stalledOperationsChanged();
+
+private:
+    void check();
+
+    QTimer m_timer;
+    QList<DistroboxCli::Operation> m_stalled;
+};
@@ -0,0 +1,134 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "packagebatchinstall.h"
+
+#include "containermetadata.h"
+#include "packageinstallcommand.h"
+
+#include <QPointer>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Package managers are mostly network bound and each one starts its container
+constexpr int MaxParallelInstalls = 3;
+constexpr int OutputTailLines = 20;
+
+QString outputTail(const QString &output)
+{
+    const QStringList lines = output.split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    return lines.mid(qMax<qsizetype>(0, lines.size() - OutputTailLines)).join(QLatin1Char('\n'));
+}
+}
+
+PackageBatchInstall::PackageBatchInstall(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool PackageBatchInstall::start(const QList<DistroboxCli::Container> &containers, const QStringList &packageNames)
+{
+    if (isRunning() || containers.isEmpty() || packageNames.isEmpty()) {
+        return false;
+    }
+
+    m_results.clear();
+    m_commands.clear();
+    m_nextIndex = 0;
+    m_completed = 0;
+
+    for (const DistroboxCli::Container &container : containers) {
+        m_results.append(Result{container.name, State::Queued, QString()});
+        m_commands.append(PackageInstallCommand::forPackageNames(ContainerMetadata::packageManager(container.name, container.image), packageNames).value_or(QString()));
+    }
+
+    for (int i = 0; i < MaxParallelInstalls; ++i) {
+        startNext();
+    }
+    return true;
+}
+
+bool PackageBatchInstall::isRunning() const
+{
+    return m_completed < m_results.size();
+}
+
+QList<PackageBatchInstall::Result> PackageBatchInstall::results() const
+{
+    return m_results;
+}
+
+QString PackageBatchInstall::stateName(State state)
+{
+    switch (state) {
+    case State::Queued:
+        return u"queued"_s;
+    case State::Installing:
+        return u"installing"_s;
+    case State::Installed:
+        return u"installed"_s;
+    case State::Failed:
+        return u"failed"_s;
+    case State::Unsupported:
+        return u"unsupported"_s;
+    }
+    return QString();
+}
+
+void PackageBatchInstall::startNext()
+{
+    // Unsupported containers complete right away without taking a slot
+    while (m_nextIndex < m_results.size() && m_commands[m_nextIndex].isEmpty()) {
+        complete(m_nextIndex++, State::Unsupported, QString());
+    }
+    if (m_nextIndex >= m_results.size() || m_running >= MaxParallelInstalls) {
+        return;
+    }
+
+    const qsizetype index = m_nextIndex++;
+    Result &result = m_results[index];
+    result.state = State::Installing;
+    ++m_running;
+    Q_EMIT progress(result.container, result.state, m_completed, m_results.size());
+
+    // Errors go to stderr, merge them so failures can be shown
+    const DistroboxCli::Command command(u"distrobox"_s, {u"enter"_s, result.container, u"--"_s, u"sh"_s, u"-c"_s, m_commands[index] + u" 2>&1"_s});
+
+    QPointer<PackageBatchInstall> self(this);
+    DistroboxCli::runCommandAsync(command, this, [self, index](bool success, const QString &output) {
+        if (!self) {
+            return;
+        }
+        --self->m_running;
+        self->complete(index, success ? State::Installed : State::Failed, success ? QString() : outputTail(output));
+        self->startNext();
+    });
+}
+
+void PackageBatchInstall::complete(qsizetype index, State state, const QString &output)
+{
+    Result &result = m_results[index];
+    result.state = state;
+    result.output = output;
+    ++m_completed;
+    Q_EMIT progress(result.container, state, m_completed, m_results.size());
+
+    if (m_completed == m_results.size()) {
+        bool success = true;
+        for (const Result &entry : std::as_const(m_results)) {
+            success = success && entry.state == State::Installed;
+        }
+        // Queued: when every container is unsupported this runs inside start(), before the
+        // caller has even seen it return
+        QMetaObject::invokeMethod(
+            this,
+            [this, success]() {
+                Q_EMIT finished(success);
+            },
+            Qt::QueuedConnection);
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include "distroboxcli.h"
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+/**
+ * @class PackageBatchInstall
+ * @brief Installs the same repository packages into several containers at once
+ *
+ * Each container gets the non-interactive install command of its package manager. A
+ * few containers are processed at a time, so installing a toolchain into five
+ * containers costs about one wait instead of five without every package manager
+ * downloading at the same time.
+ */
+class PackageBatchInstall : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class State {
+        Queued,
+        Installing,
+        Installed,
+        Failed,
+        Unsupported,
+    };
+
+    struct Result {
+        QString container;
+        State state = State::Queued;
+        QString output; ///< Tail of the package manager output, kept for failures
+    };
+
+    explicit PackageBatchInstall(QObject *parent = nullptr);
+
+    /**
+     * @brief Starts installing packageNames into every container
+     * @return false if a batch is already running or there is nothing to install
+     */
+    bool start(const QList<DistroboxCli::Container> &containers, const QStringList &packageNames);
+
+    bool isRunning() const;
+    QList<Result> results() const;
+
+    static QString stateName(State state);
+
+Q_SIGNALS:
+    void progress(const QString &container, PackageBatchInstall::State state, int completed, int total);
+    void finished(bool success);
+
+private:
+    void startNext();
+    void complete(qsizetype index, State state, const QString &output);
+
+    QList<Result> m_results;
+    QStringList m_commands; ///< Install command of each container, empty when unsupported
+    qsizetype m_nextIndex = 0;
+    int m_running = 0;
+    int m_completed = 0;
+};
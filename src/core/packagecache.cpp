@@ -0,0 +1,229 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "packagecache.h"
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QList>
+#include <QMutex>
+#include <QStandardPaths>
+#include <QThreadPool>
+
+#include <algorithm>
+#include <optional>
+
+using namespace Qt::Literals::StringLiterals;
+using PackageInstallCommand::PackageManager;
+
+namespace
+{
+constexpr qint64 DefaultBudgetMiB = 4096;
+constexpr qint64 RecentlyUsedSecs = 60 * 60;
+
+QMutex pruneMutex;
+
+struct Mount {
+    QString hostDirectory; ///< Relative to the family directory
+    QString containerPath;
+};
+
+struct Family {
+    QString name;
+    QList<Mount> mounts;
+    QString initHook; ///< Makes the package manager keep downloaded packages, runs as root on every start
+};
+
+std::optional<Family> family(PackageManager packageManager)
+{
+    switch (packageManager) {
+    case PackageManager::Dnf:
+        // dnf4 and dnf5 keep their caches in different places, both read the same dnf.conf. dnf4
+        // has no drop-in directory and dnf.conf overrides the dnf5 ones, so an existing
+        // keepcache=False is replaced in place.
+        return Family{u"dnf"_s,
+                      {{u"dnf"_s, u"/var/cache/dnf"_s}, {u"libdnf5"_s, u"/var/cache/libdnf5"_s}},
+                      u"[ -f /etc/dnf/dnf.conf ] || echo '[main]' > /etc/dnf/dnf.conf; "
+                      "sed -i -e '/^keepcache[[:space:]]*=/d' -e '/^[[]main[]]/a keepcache=True' /etc/dnf/dnf.conf"_s};
+    case PackageManager::Apt:
+        // Debian and Ubuntu images ship a hook deleting the archives after every install
+        return Family{u"apt"_s,
+                      {{u"archives"_s, u"/var/cache/apt/archives"_s}},
+                      u"rm -f /etc/apt/apt.conf.d/docker-clean; "
+                      "echo 'Binary::apt::APT::Keep-Downloaded-Packages \"true\";' > /etc/apt/apt.conf.d/01kontainer-keep-cache"_s};
+    case PackageManager::Pacman:
+        return Family{u"pacman"_s, {{u"pkg"_s, u"/var/cache/pacman/pkg"_s}}, QString()};
+    case PackageManager::Apk:
+        return Family{u"apk"_s, {{u"apk"_s, u"/var/cache/apk"_s}}, u"[ -e /etc/apk/cache ] || ln -s /var/cache/apk /etc/apk/cache"_s};
+    case PackageManager::Zypper:
+        return Family{u"zypper"_s,
+                      {{u"packages"_s, u"/var/cache/zypp/packages"_s}},
+                      u"zypper --non-interactive modifyrepo --all --keep-packages >/dev/null 2>&1 || true"_s};
+    case PackageManager::Xbps:
+        return Family{u"xbps"_s, {{u"xbps"_s, u"/var/cache/xbps"_s}}, QString()};
+    default:
+        return std::nullopt;
+    }
+}
+
+QString cacheRoot()
+{
+    const QString cacheBase = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheBase.isEmpty()) {
+        return {};
+    }
+    return QDir(cacheBase).filePath(u"kontainer/package-cache"_s);
+}
+
+// Only downloaded packages are evicted, repository metadata is small and always needed
+bool isPackageFile(const QString &fileName)
+{
+    for (const QString &suffix : {u".rpm"_s, u".deb"_s, u".apk"_s, u".xbps"_s, u".pkg.tar.zst"_s, u".pkg.tar.xz"_s, u".pkg.tar.zst.sig"_s, u".pkg.tar.xz.sig"_s}) {
+        if (fileName.endsWith(suffix)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+struct CachedFile {
+    QString path;
+    qint64 size;
+    QDateTime lastUsed;
+};
+}
+
+namespace PackageCache
+{
+QString familyName(PackageManager packageManager)
+{
+    const auto entry = family(packageManager);
+    return entry ? entry->name : QString();
+}
+
+QStringList createArguments(PackageManager packageManager)
+{
+    const auto entry = family(packageManager);
+    const QString root = cacheRoot();
+    if (!entry || root.isEmpty()) {
+        return {};
+    }
+
+    QStringList arguments;
+    for (const Mount &mount : entry->mounts) {
+        const QString hostDirectory = QDir(root).filePath(entry->name + QLatin1Char('/') + mount.hostDirectory);
+        if (!QDir().mkpath(hostDirectory)) {
+            return {};
+        }
+        arguments << u"--volume"_s << hostDirectory + QLatin1Char(':') + mount.containerPath;
+    }
+    if (!entry->initHook.isEmpty()) {
+        arguments << u"--init-hooks"_s << entry->initHook;
+    }
+    return arguments;
+}
+
+QStringList mergeInitHooks(const QStringList &arguments)
+{
+    const QString option = u"--init-hooks"_s;
+    const QString optionWithValue = option + QLatin1Char('=');
+
+    QStringList merged;
+    QStringList hooks;
+    for (int i = 0; i < arguments.size(); ++i) {
+        if (arguments[i] == option && i + 1 < arguments.size()) {
+            hooks << arguments[++i];
+        } else if (arguments[i].startsWith(optionWithValue)) {
+            hooks << arguments[i].mid(optionWithValue.size());
+        } else {
+            merged << arguments[i];
+        }
+    }
+    hooks.removeAll(QString());
+    if (!hooks.isEmpty()) {
+        merged << option << hooks.join(u" && "_s);
+    }
+    return merged;
+}
+
+qint64 budgetBytes()
+{
+    const qint64 budgetMiB = KConfigGroup(KSharedConfig::openConfig(), u"PackageCache"_s).readEntry("BudgetMiB", DefaultBudgetMiB);
+    return std::max<qint64>(0, budgetMiB) * 1024 * 1024;
+}
+
+qint64 usageBytes()
+{
+    const QString root = cacheRoot();
+    if (root.isEmpty()) {
+        return 0;
+    }
+
+    qint64 total = 0;
+    QDirIterator it(root, QDir::Files | QDir::Hidden | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        total += it.fileInfo().size();
+    }
+    return total;
+}
+
+qint64 prune()
+{
+    const QString root = cacheRoot();
+    if (root.isEmpty() || !pruneMutex.tryLock()) {
+        return 0;
+    }
+
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    qint64 total = 0;
+    QList<CachedFile> candidates;
+
+    QDirIterator it(root, QDir::Files | QDir::Hidden | QDir::NoSymLinks, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        total += info.size();
+
+        // relatime still refreshes the access time once a day, enough to rank by use
+        const QDateTime lastUsed = std::max(info.lastRead(), info.lastModified());
+        if (isPackageFile(info.fileName()) && lastUsed.secsTo(now) > RecentlyUsedSecs) {
+            candidates.append({info.filePath(), info.size(), lastUsed});
+        }
+    }
+
+    const qint64 budget = budgetBytes();
+    qint64 freed = 0;
+    if (total > budget) {
+        std::sort(candidates.begin(), candidates.end(), [](const CachedFile &a, const CachedFile &b) {
+            return a.lastUsed < b.lastUsed;
+        });
+
+        for (const CachedFile &file : std::as_const(candidates)) {
+            if (total - freed <= budget) {
+                break;
+            }
+            if (QFile::remove(file.path)) {
+                freed += file.size;
+            }
+        }
+    }
+
+    pruneMutex.unlock();
+    return freed;
+}
+
+void pruneInBackground()
+{
+    QThreadPool::globalInstance()->start([]() {
+        prune();
+    });
+}
+}
@@ -0,0 +1,61 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include "packageinstallcommand.h"
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * Package download caches kept on the host and shared by the containers of a package
+ * manager family, so a package fetched by one container is a cache hit for the others.
+ *
+ * The caches are bind-mounted over the package manager's cache directory when a container
+ * is created, together with an init hook telling the package manager to keep what it
+ * downloads. They live under the application cache directory and are pruned, least recently
+ * used packages first, to stay within a size budget (config key PackageCache/BudgetMiB).
+ */
+namespace PackageCache
+{
+/**
+ * @brief Name of the shared cache used by the package manager, e.g. "dnf"
+ * @return Empty when the package manager has no shareable download cache
+ */
+QString familyName(PackageInstallCommand::PackageManager packageManager);
+
+/**
+ * @brief Arguments for distrobox create mounting the shared cache of the package manager
+ *
+ * Creates the host directories. Empty when the package manager is not supported.
+ */
+QStringList createArguments(PackageInstallCommand::PackageManager packageManager);
+
+/**
+ * @brief Joins every --init-hooks of distrobox create arguments into one, in their order
+ *
+ * distrobox keeps only the last --init-hooks, the hook of the cache would otherwise replace
+ * the user's own one or be replaced by it.
+ */
+QStringList mergeInitHooks(const QStringList &arguments);
+
+qint64 budgetBytes();
+qint64 usageBytes();
+
+/**
+ * @brief Removes the least recently used packages until the caches fit the budget
+ * @return Number of bytes freed
+ *
+ * Packages touched in the last hour are kept, they may belong to a running transaction.
+ * Blocks on disk I/O, safe to call from any thread.
+ */
+qint64 prune();
+
+/**
+ * @brief Runs prune() on the thread pool
+ */
+void pruneInBackground();
+}
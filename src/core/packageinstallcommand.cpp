@@ -13,40 +13,111 @@ using namespace Qt::Literals::StringLiterals;
 namespace PackageInstallCommand
 {
 
-std::optional<QString> forImage(const QString &image, const QString &packagePath)
+PackageManager packageManagerForImage(const QString &image)
 {
     const QString imageLower = image.toLower();
-    const QString quotedPath = KShell::quoteArg(packagePath);
 
     if (imageLower.contains(QRegularExpression(u"fedora|bluefin|ublue-os/fedora|fedoraproject\\.org/fedora"_s))) {
-        return u"sudo dnf install %1"_s.arg(quotedPath);
+        return PackageManager::Dnf;
     }
     if (imageLower.contains(QRegularExpression(u"ubuntu|toolbx/ubuntu|ubuntu-toolbox|debian|neurodebian|mint|kali|neon"_s))) {
-        return u"sudo apt install %1"_s.arg(quotedPath);
+        return PackageManager::Apt;
     }
     if (imageLower.contains(QRegularExpression(u"opensuse|tumbleweed|leap"_s))) {
-        return u"sudo zypper install %1"_s.arg(quotedPath);
+        return PackageManager::Zypper;
     }
     if (imageLower.contains(QRegularExpression(u"arch|blackarch|ublue-os/arch|bazzite-arch|arch-toolbox"_s))) {
-        return u"sudo pacman -U --noconfirm %1"_s.arg(quotedPath);
+        return PackageManager::Pacman;
     }
     if (imageLower.contains(QRegularExpression(u"centos|rhel|rocky|alma|ubi[789]?/|amazonlinux|oracle"_s))) {
-        return u"sudo dnf install %1"_s.arg(quotedPath);
+        return PackageManager::Dnf;
     }
     if (imageLower.contains(QRegularExpression(u"alpine"_s))) {
-        return u"sudo apk add --allow-untrusted %1"_s.arg(quotedPath);
+        return PackageManager::Apk;
     }
     if (imageLower.contains(QRegularExpression(u"void"_s))) {
-        return u"sudo xbps-install %1"_s.arg(quotedPath);
+        return PackageManager::Xbps;
     }
     if (imageLower.contains(QRegularExpression(u"gentoo"_s))) {
-        return u"sudo emerge %1"_s.arg(quotedPath);
+        return PackageManager::Emerge;
     }
     if (imageLower.contains(QRegularExpression(u"slack"_s))) {
-        return u"sudo installpkg %1"_s.arg(quotedPath);
+        return PackageManager::Installpkg;
     }
     if (imageLower.contains(QRegularExpression(u"wolfi|chainguard"_s))) {
+        return PackageManager::Apk;
+    }
+
+    return PackageManager::Unknown;
+}
+
+std::optional<QString> forImage(const QString &image, const QString &packagePath)
+{
+    return forPackageManager(packageManagerForImage(image), packagePath);
+}
+
+std::optional<QString> forPackageManager(PackageManager packageManager, const QString &packagePath)
+{
+    const QString quotedPath = KShell::quoteArg(packagePath);
+
+    switch (packageManager) {
+    case PackageManager::Dnf:
+        return u"sudo dnf install %1"_s.arg(quotedPath);
+    case PackageManager::Apt:
+        return u"sudo apt install %1"_s.arg(quotedPath);
+    case PackageManager::Zypper:
+        return u"sudo zypper install %1"_s.arg(quotedPath);
+    case PackageManager::Pacman:
+        return u"sudo pacman -U --noconfirm %1"_s.arg(quotedPath);
+    case PackageManager::Apk:
         return u"sudo apk add --allow-untrusted %1"_s.arg(quotedPath);
+    case PackageManager::Xbps:
+        return u"sudo xbps-install %1"_s.arg(quotedPath);
+    case PackageManager::Emerge:
+        return u"sudo emerge %1"_s.arg(quotedPath);
+    case PackageManager::Installpkg:
+        return u"sudo installpkg %1"_s.arg(quotedPath);
+    case PackageManager::Unknown:
+        break;
+    }
+
+    return std::nullopt;
+}
+
+std::optional<QString> forPackageNames(PackageManager packageManager, const QStringList &packageNames)
+{
+    if (packageNames.isEmpty()) {
+        return std::nullopt;
+    }
+
+    QStringList quotedNames;
+    for (const QString &packageName : packageNames) {
+        quotedNames.append(KShell::quoteArg(packageName));
+    }
+    const QString names = quotedNames.join(QLatin1Char(' '));
+
+    // sudo -n fails instead of waiting for a password nobody can type. Fresh images ship without
+    // package indexes, refresh them first; pacman upgrades along, since installing against a
+    // newer index on top of old libraries is a partial upgrade.
+    switch (packageManager) {
+    case PackageManager::Dnf:
+        return u"sudo -n dnf install -y %1"_s.arg(names);
+    case PackageManager::Apt:
+        return u"sudo -n env DEBIAN_FRONTEND=noninteractive apt-get update && sudo -n env DEBIAN_FRONTEND=noninteractive apt-get install -y %1"_s.arg(names);
+    case PackageManager::Zypper:
+        return u"sudo -n zypper --non-interactive install %1"_s.arg(names);
+    case PackageManager::Pacman:
+        return u"sudo -n pacman -Syu --needed --noconfirm %1"_s.arg(names);
+    case PackageManager::Apk:
+        return u"sudo -n apk add --update-cache %1"_s.arg(names);
+    case PackageManager::Xbps:
+        return u"sudo -n xbps-install -Sy %1"_s.arg(names);
+    case PackageManager::Emerge:
+        return u"sudo -n emerge --ask=n %1"_s.arg(names);
+    case PackageManager::Installpkg:
+        // installpkg only takes package files
+    case PackageManager::Unknown:
+        break;
     }
 
     return std::nullopt;
@@ -6,9 +6,27 @@
 #pragma once
 
 #include <QString>
+#include <QStringList>
 #include <optional>
 
 namespace PackageInstallCommand
 {
+enum class PackageManager {
+    Unknown,
+    Dnf,
+    Apt,
+    Zypper,
+    Pacman,
+    Apk,
+    Xbps,
+    Emerge,
+    Installpkg,
+};
+
+PackageManager packageManagerForImage(const QString &image);
 std::optional<QString> forImage(const QString &image, const QString &packagePath);
+std::optional<QString> forPackageManager(PackageManager packageManager, const QString &packagePath);
+
+// Installs packages by name from the distribution repositories, without prompting, refreshing the package indexes first
+std::optional<QString> forPackageNames(PackageManager packageManager, const QStringList &packageNames);
 }
@@ -0,0 +1,388 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "packageinventory.h"
+
+#include "containermetadata.h"
+#include "packageinstallcommand.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QtConcurrent>
+
+#include <algorithm>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+constexpr quint32 CacheVersion = 1;
+
+enum class DatabaseFormat {
+    Dpkg,
+    Rpm,
+    Pacman,
+    Apk,
+};
+
+struct Database {
+    DatabaseFormat format;
+    QString path;
+};
+
+// Known database locations, the one matching the container's package manager is probed first
+QList<Database> candidateDatabases(PackageInstallCommand::PackageManager packageManager)
+{
+    QList<Database> databases = {
+        {DatabaseFormat::Dpkg, u"/var/lib/dpkg/status"_s},
+        {DatabaseFormat::Rpm, u"/usr/lib/sysimage/rpm/rpmdb.sqlite"_s},
+        {DatabaseFormat::Rpm, u"/var/lib/rpm/rpmdb.sqlite"_s},
+        {DatabaseFormat::Rpm, u"/var/lib/rpm/Packages"_s},
+        {DatabaseFormat::Pacman, u"/var/lib/pacman/local"_s},
+        {DatabaseFormat::Apk, u"/lib/apk/db/installed"_s},
+    };
+
+    DatabaseFormat preferred = DatabaseFormat::Dpkg;
+    switch (packageManager) {
+    case PackageInstallCommand::PackageManager::Apt:
+        preferred = DatabaseFormat::Dpkg;
+        break;
+    case PackageInstallCommand::PackageManager::Dnf:
+    case PackageInstallCommand::PackageManager::Zypper:
+        preferred = DatabaseFormat::Rpm;
+        break;
+    case PackageInstallCommand::PackageManager::Pacman:
+        preferred = DatabaseFormat::Pacman;
+        break;
+    case PackageInstallCommand::PackageManager::Apk:
+        preferred = DatabaseFormat::Apk;
+        break;
+    default:
+        return databases;
+    }
+
+    std::stable_partition(databases.begin(), databases.end(), [preferred](const Database &database) {
+        return database.format == preferred;
+    });
+    return databases;
+}
+
+QList<PackageInventory::Package> parseDpkgStatus(const QByteArray &data)
+{
+    QList<PackageInventory::Package> packages;
+
+    PackageInventory::Package current;
+    bool installed = false;
+    const auto flush = [&]() {
+        if (installed && !current.name.isEmpty()) {
+            packages.append(current);
+        }
+        current = {};
+        installed = false;
+    };
+
+    for (const QByteArray &line : data.split('\n')) {
+        if (line.isEmpty()) {
+            flush();
+        } else if (line.startsWith("Package: ")) {
+            current.name = QString::fromUtf8(line.mid(9).trimmed());
+        } else if (line.startsWith("Version: ")) {
+            current.version = QString::fromUtf8(line.mid(9).trimmed());
+        } else if (line.startsWith("Status: ")) {
+            installed = line.endsWith(" installed");
+        }
+    }
+    flush();
+
+    return packages;
+}
+
+QList<PackageInventory::Package> parseApkInstalled(const QByteArray &data)
+{
+    QList<PackageInventory::Package> packages;
+
+    PackageInventory::Package current;
+    for (const QByteArray &line : data.split('\n')) {
+        if (line.isEmpty()) {
+            if (!current.name.isEmpty()) {
+                packages.append(current);
+            }
+            current = {};
+        } else if (line.startsWith("P:")) {
+            current.name = QString::fromUtf8(line.mid(2));
+        } else if (line.startsWith("V:")) {
+            current.version = QString::fromUtf8(line.mid(2));
+        }
+    }
+    if (!current.name.isEmpty()) {
+        packages.append(current);
+    }
+
+    return packages;
+}
+
+// Entries of the pacman local database are named <name>-<version>-<release>
+QList<PackageInventory::Package> parsePacmanLocal(const QStringList &entries)
+{
+    QList<PackageInventory::Package> packages;
+    for (const QString &entry : entries) {
+        const qsizetype releaseDash = entry.lastIndexOf(QLatin1Char('-'));
+        const qsizetype versionDash = releaseDash > 0 ? entry.lastIndexOf(QLatin1Char('-'), releaseDash - 1) : -1;
+        if (versionDash <= 0) {
+            continue;
+        }
+        packages.append({entry.left(versionDash), entry.mid(versionDash + 1)});
+    }
+    return packages;
+}
+
+// Names of the running containers, docker and podman only list those by default
+QSet<QString> runningContainers()
+{
+    bool success = false;
+    const QString output =
+        DistroboxCli::runCommand(DistroboxCli::Command(DistroboxCli::containerManager(), {u"ps"_s, u"--format"_s, u"{{.Names}}"_s}), success);
+    if (!success) {
+        return {};
+    }
+
+    QSet<QString> names;
+    for (const QString &line : output.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+        names.insert(line.trimmed());
+    }
+    return names;
+}
+
+// The rpm database is an sqlite/BDB file of binary headers, rpm itself is the reliable reader.
+// This only runs when the database stamp changed, and only for running containers.
+QList<PackageInventory::Package> queryRpm(const QString &container)
+{
+    // rpm expands the escapes of the query format itself
+    const DistroboxCli::Command query(u"distrobox"_s,
+                                      {u"enter"_s, container, u"--"_s, u"rpm"_s, u"-qa"_s, u"--qf"_s, u"%{NAME}\\t%{VERSION}-%{RELEASE}\\n"_s});
+    bool success = false;
+    const QString output = DistroboxCli::runCommand(query, success, DistroboxCli::LongTimeoutMs);
+
+    QList<PackageInventory::Package> packages;
+    if (!success) {
+        return packages;
+    }
+
+    for (const QString &line : output.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+        const qsizetype tab = line.indexOf(QLatin1Char('\t'));
+        if (tab > 0) {
+            packages.append({line.left(tab), line.mid(tab + 1)});
+        }
+    }
+    return packages;
+}
+
+PackageInventory::ContainerPackages
+readContainer(const DistroboxCli::Container &container, const PackageInventory::ContainerPackages &previous, const QSet<QString> &running)
+{
+    for (const Database &database : candidateDatabases(ContainerMetadata::packageManager(container.name, container.image))) {
+        const ContainerFs::FileStamp stamp = ContainerFs::stamp(container.name, database.path);
+        if (!stamp.exists()) {
+            continue;
+        }
+
+        if (previous.database == database.path && previous.stamp == stamp) {
+            return previous;
+        }
+
+        // Querying rpm enters the container, which would start a stopped one. Keep what is
+        // known with the old stamp, so the database is read once the container runs.
+        if (database.format == DatabaseFormat::Rpm && !running.contains(container.name)) {
+            return previous;
+        }
+
+        PackageInventory::ContainerPackages result;
+        result.database = database.path;
+        result.stamp = stamp;
+
+        QByteArray data;
+        switch (database.format) {
+        case DatabaseFormat::Dpkg:
+            if (ContainerFs::readFile(container.name, database.path, data)) {
+                result.packages = parseDpkgStatus(data);
+            }
+            break;
+        case DatabaseFormat::Apk:
+            if (ContainerFs::readFile(container.name, database.path, data)) {
+                result.packages = parseApkInstalled(data);
+            }
+            break;
+        case DatabaseFormat::Pacman:
+            result.packages = parsePacmanLocal(ContainerFs::entryList(container.name, database.path));
+            break;
+        case DatabaseFormat::Rpm:
+            result.packages = queryRpm(container.name);
+            break;
+        }
+
+        return result;
+    }
+
+    return {};
+}
+
+QString cacheFilePath()
+{
+    const QString cacheBase = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheBase.isEmpty()) {
+        return {};
+    }
+
+    const QString directory = QDir(cacheBase).filePath(u"kontainer"_s);
+    QDir().mkpath(directory);
+    return QDir(directory).filePath(u"packages.cache"_s);
+}
+
+QHash<QString, PackageInventory::ContainerPackages> loadCache()
+{
+    QHash<QString, PackageInventory::ContainerPackages> containers;
+
+    QFile file(cacheFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return containers;
+    }
+
+    QDataStream stream(&file);
+    quint32 version = 0;
+    qint64 containerCount = 0;
+    stream >> version;
+    if (version != CacheVersion) {
+        return containers;
+    }
+
+    stream >> containerCount;
+    for (qint64 i = 0; i < containerCount && stream.status() == QDataStream::Ok; ++i) {
+        QString name;
+        PackageInventory::ContainerPackages entry;
+        qint64 packageCount = 0;
+        stream >> name >> entry.database >> entry.stamp.mtime >> entry.stamp.size >> packageCount;
+        for (qint64 j = 0; j < packageCount && stream.status() == QDataStream::Ok; ++j) {
+            PackageInventory::Package package;
+            stream >> package.name >> package.version;
+            entry.packages.append(package);
+        }
+        containers.insert(name, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return {};
+    }
+    return containers;
+}
+
+void storeCache(const QHash<QString, PackageInventory::ContainerPackages> &containers)
+{
+    QSaveFile file(cacheFilePath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream << CacheVersion << qint64(containers.size());
+    for (auto it = containers.cbegin(); it != containers.cend(); ++it) {
+        stream << it.key() << it->database << it->stamp.mtime << it->stamp.size << qint64(it->packages.size());
+        for (const PackageInventory::Package &package : it->packages) {
+            stream << package.name << package.version;
+        }
+    }
+    file.commit();
+}
+}
+
+PackageInventory::PackageInventory(QObject *parent)
+    : QObject(parent)
+    , m_containers(loadCache())
+{
+    rebuildIndex();
+
+    connect(&m_watcher, &QFutureWatcher<QHash<QString, ContainerPackages>>::finished, this, [this]() {
+        m_containers = m_watcher.result();
+        rebuildIndex();
+        Q_EMIT refreshed();
+    });
+}
+
+bool PackageInventory::refresh(const QList<DistroboxCli::Container> &containers)
+{
+    if (m_watcher.isRunning()) {
+        return false;
+    }
+
+    const QHash<QString, ContainerPackages> previous = m_containers;
+    m_watcher.setFuture(QtConcurrent::run([containers, previous]() {
+        const QSet<QString> running = runningContainers();
+        const QList<ContainerPackages> results =
+            QtConcurrent::blockingMapped<QList<ContainerPackages>>(containers, [&previous, &running](const DistroboxCli::Container &container) {
+                return readContainer(container, previous.value(container.name), running);
+            });
+
+        QHash<QString, ContainerPackages> fresh;
+        for (qsizetype i = 0; i < containers.size(); ++i) {
+            fresh.insert(containers[i].name, results[i]);
+        }
+
+        storeCache(fresh);
+        return fresh;
+    }));
+
+    return true;
+}
+
+bool PackageInventory::isRefreshing() const
+{
+    return m_watcher.isRunning();
+}
+
+void PackageInventory::rebuildIndex()
+{
+    m_index.clear();
+    for (auto it = m_containers.cbegin(); it != m_containers.cend(); ++it) {
+        for (const Package &package : it->packages) {
+            m_index.append({package.name.toLower(), Match{package.name, package.version, it.key()}});
+        }
+    }
+
+    std::sort(m_index.begin(), m_index.end(), [](const IndexEntry &a, const IndexEntry &b) {
+        return a.key < b.key;
+    });
+}
+
+QList<PackageInventory::Match> PackageInventory::search(const QString &query, int limit) const
+{
+    QList<Match> matches;
+
+    const QString needle = query.trimmed().toLower();
+    if (needle.isEmpty() || limit <= 0) {
+        return matches;
+    }
+
+    // Prefix matches are contiguous in the sorted index
+    auto it = std::lower_bound(m_index.cbegin(), m_index.cend(), needle, [](const IndexEntry &entry, const QString &value) {
+        return entry.key < value;
+    });
+    for (; it != m_index.cend() && it->key.startsWith(needle) && matches.size() < limit; ++it) {
+        matches.append(it->match);
+    }
+
+    for (const IndexEntry &entry : m_index) {
+        if (matches.size() >= limit) {
+            break;
+        }
+        if (!entry.key.startsWith(needle) && entry.key.contains(needle)) {
+            matches.append(entry.match);
+        }
+    }
+
+    return matches;
+}
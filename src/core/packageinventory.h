@@ -0,0 +1,81 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include "containerfs.h"
+#include "distroboxcli.h"
+
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+/**
+ * @class PackageInventory
+ * @brief Index of the packages installed in every container
+ *
+ * Package databases (dpkg status, rpm, pacman local DB, apk installed) are read from
+ * the container filesystem and only re-read when the database file changed since the
+ * previous refresh. rpm databases are queried through rpm inside the container, so they
+ * are only read while the container runs. The per-container lists are persisted in the cache directory so
+ * the index is available right after start. Searching works on a sorted, lowercased
+ * index: prefix matches by binary search, then substring matches.
+ */
+class PackageInventory : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Package {
+        QString name;
+        QString version;
+    };
+
+    struct Match {
+        QString name;
+        QString version;
+        QString container;
+    };
+
+    /// Installed packages of one container together with the database state they were read from
+    struct ContainerPackages {
+        QString database; ///< Path of the package database inside the container
+        ContainerFs::FileStamp stamp;
+        QList<Package> packages;
+    };
+
+    explicit PackageInventory(QObject *parent = nullptr);
+
+    /**
+     * @brief Re-reads the package databases that changed, in the background
+     * @param containers Containers to index; containers not listed are dropped from the index
+     * @return false if a refresh is already running
+     */
+    bool refresh(const QList<DistroboxCli::Container> &containers);
+
+    bool isRefreshing() const;
+
+    /**
+     * @brief Finds packages whose name contains the query, prefix matches first
+     */
+    QList<Match> search(const QString &query, int limit) const;
+
+Q_SIGNALS:
+    void refreshed();
+
+private:
+    struct IndexEntry {
+        QString key; ///< Lowercased package name
+        Match match;
+    };
+
+    void rebuildIndex();
+
+    QHash<QString, ContainerPackages> m_containers;
+    QList<IndexEntry> m_index;
+    QFutureWatcher<QHash<QString, ContainerPackages>> m_watcher;
+};
@@ -0,0 +1,508 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "registrymirror.h"
+
+#include "distroboxcli.h"
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+#include <QByteArrayList>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QThread>
+
+#include <cmath>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+const QString LocalMirrorContainer = u"kontainer-registry-mirror"_s;
+const QString LocalMirrorVolume = u"kontainer-registry-mirror"_s;
+const QString LocalMirrorImage = u"docker.io/library/registry:2"_s;
+// registry:2 proxies a single upstream, Docker Hub is where the base images come from
+const QString LocalMirrorUpstream = u"https://registry-1.docker.io"_s;
+const QString DockerHub = u"docker.io"_s;
+
+// Only the recent pulls count towards the hit rate
+constexpr int StatisticsWindow = 1000;
+// The log is cut back to the window once it grows past this, a line takes around 100 bytes
+constexpr qint64 MaxLogBytes = 256 * 1024;
+constexpr int MirrorStartupPolls = 20;
+constexpr int MirrorStartupPollMs = 250;
+// registry:2 serves its expvar counters there, inside the container only
+const QString LocalMirrorDebugAddress = u"localhost:5001"_s;
+
+QMutex logMutex;
+
+KConfigGroup mirrorGroup()
+{
+    return KConfigGroup(KSharedConfig::openConfig(), u"RegistryMirror"_s);
+}
+
+QString modeName(RegistryMirror::Mode mode)
+{
+    switch (mode) {
+    case RegistryMirror::Mode::Local:
+        return u"local"_s;
+    case RegistryMirror::Mode::Site:
+        return u"site"_s;
+    case RegistryMirror::Mode::Off:
+        break;
+    }
+    return u"off"_s;
+}
+
+RegistryMirror::Mode modeFromName(const QString &name)
+{
+    if (name == u"local"_s) {
+        return RegistryMirror::Mode::Local;
+    }
+    if (name == u"site"_s) {
+        return RegistryMirror::Mode::Site;
+    }
+    return RegistryMirror::Mode::Off;
+}
+
+QString sourceName(RegistryMirror::PullSource source)
+{
+    switch (source) {
+    case RegistryMirror::PullSource::Local:
+        return u"local"_s;
+    case RegistryMirror::PullSource::Mirror:
+        return u"mirror"_s;
+    case RegistryMirror::PullSource::MirrorMiss:
+        return u"mirror-miss"_s;
+    case RegistryMirror::PullSource::Upstream:
+        return u"upstream"_s;
+    case RegistryMirror::PullSource::Failed:
+        break;
+    }
+    return u"failed"_s;
+}
+
+QString logPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + u"/kontainer/registry-pulls.log"_s;
+}
+
+void logPull(RegistryMirror::PullSource source, const QString &reference)
+{
+    QMutexLocker locker(&logMutex);
+    const QString path = logPath();
+    QDir().mkpath(QFileInfo(path).path());
+
+    QFile file(path);
+    if (!file.open(QIODevice::Append | QIODevice::Text)) {
+        return;
+    }
+    file.write(u"%1\t%2\t%3\n"_s.arg(QDateTime::currentDateTimeUtc().toString(Qt::ISODate), sourceName(source), reference).toUtf8());
+    if (file.size() <= MaxLogBytes) {
+        return;
+    }
+    file.close();
+
+    // Keeps only the pulls statistics() looks at
+    QByteArrayList lines;
+    if (file.open(QIODevice::ReadOnly)) {
+        lines = file.readAll().split('\n');
+        file.close();
+    }
+    lines.removeAll(QByteArray());
+    if (lines.size() > StatisticsWindow) {
+        lines = lines.mid(lines.size() - StatisticsWindow);
+    }
+    QSaveFile trimmed(path);
+    if (trimmed.open(QIODevice::WriteOnly)) {
+        trimmed.write(lines.join('\n') + '\n');
+        trimmed.commit();
+    }
+}
+
+// Registry host and the rest of a normalized reference
+std::pair<QString, QString> splitRegistry(const QString &normalized)
+{
+    const qsizetype slash = normalized.indexOf(QLatin1Char('/'));
+    return {normalized.left(slash), normalized.mid(slash + 1)};
+}
+
+QString canonicalRegistry(const QString &registry)
+{
+    const QString lowered = registry.trimmed().toLower();
+    if (lowered == u"index.docker.io"_s || lowered == u"registry-1.docker.io"_s || lowered == u"registry.hub.docker.com"_s) {
+        return DockerHub;
+    }
+    return lowered;
+}
+
+bool isPodman(const QString &manager)
+{
+    return manager.endsWith(u"podman"_s);
+}
+
+bool imageExists(const QString &manager, const QString &reference)
+{
+    bool success = false;
+    DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"image"_s, u"inspect"_s, u"--format"_s, u"{{.Id}}"_s, reference}), success);
+    return success;
+}
+
+// References of every local image, normalized
+QSet<QString> localReferences(const QString &manager)
+{
+    bool success = false;
+    const QString output =
+        DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"images"_s, u"--format"_s, u"{{.Repository}}:{{.Tag}}"_s}), success);
+
+    QSet<QString> references;
+    for (const QString &line : output.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+        if (!line.contains(u"<none>"_s)) {
+            references.insert(RegistryMirror::normalizedReference(line.trimmed()));
+        }
+    }
+    return references;
+}
+
+// Layers the local mirror had to fetch from upstream since it started, -1 when it cannot tell
+qint64 localMirrorBlobMisses(const QString &manager)
+{
+    bool success = false;
+    const QString output = DistroboxCli::runCommand(
+        DistroboxCli::Command(manager,
+                              {u"exec"_s, LocalMirrorContainer, u"wget"_s, u"-q"_s, u"-O"_s, u"-"_s, u"http://%1/debug/vars"_s.arg(LocalMirrorDebugAddress)}),
+        success);
+    if (!success) {
+        return -1;
+    }
+    const QJsonObject blobs = QJsonDocument::fromJson(output.toUtf8())
+                                  .object()
+                                  .value(u"registry"_s)
+                                  .toObject()
+                                  .value(u"proxy"_s)
+                                  .toObject()
+                                  .value(u"blobs"_s)
+                                  .toObject();
+    return blobs.value(u"Misses"_s).toInteger(-1);
+}
+
+bool pullFromMirror(const QString &manager, const RegistryMirror::Settings &settings, const QString &mirror, const QString &normalized)
+{
+    DistroboxCli::Command pull(manager, {u"pull"_s});
+    // Docker has no such switch, it trusts localhost and takes insecure registries from its daemon configuration
+    if (isPodman(manager) && (settings.mode == RegistryMirror::Mode::Local || settings.insecure)) {
+        pull << u"--tls-verify=false"_s;
+    }
+    pull << mirror;
+
+    bool pulled = false;
+    DistroboxCli::runCommand(pull, pulled, DistroboxCli::LongTimeoutMs);
+    if (!pulled) {
+        return false;
+    }
+
+    bool tagged = false;
+    DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"tag"_s, mirror, normalized}), tagged);
+
+    // Only drops the mirror name, the image stays under its original one
+    bool untagged = false;
+    DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"rmi"_s, mirror}), untagged);
+    return tagged;
+}
+}
+
+namespace RegistryMirror
+{
+Settings settings()
+{
+    const KConfigGroup group = mirrorGroup();
+
+    Settings result;
+    result.mode = modeFromName(group.readEntry("Mode", u"off"_s));
+    result.siteMirror = group.readEntry("SiteMirror", QString());
+    result.mirroredRegistry = group.readEntry("MirroredRegistry", DockerHub);
+    result.insecure = group.readEntry("Insecure", false);
+    result.pinnedImages = group.readEntry("PinnedImages", QStringList());
+    return result;
+}
+
+void setSettings(const Settings &settings)
+{
+    KConfigGroup group = mirrorGroup();
+    group.writeEntry("Mode", modeName(settings.mode));
+    group.writeEntry("SiteMirror", settings.siteMirror.trimmed());
+    group.writeEntry("MirroredRegistry", canonicalRegistry(settings.mirroredRegistry));
+    group.writeEntry("Insecure", settings.insecure);
+
+    QStringList pinned;
+    for (const QString &image : settings.pinnedImages) {
+        const QString normalized = normalizedReference(image);
+        if (!normalized.isEmpty() && !pinned.contains(normalized)) {
+            pinned.append(normalized);
+        }
+    }
+    group.writeEntry("PinnedImages", pinned);
+    group.sync();
+}
+
+QString normalizedReference(const QString &reference)
+{
+    QString normalized = reference.trimmed();
+    if (normalized.isEmpty()) {
+        return {};
+    }
+
+    const qsizetype slash = normalized.indexOf(QLatin1Char('/'));
+    const QString first = normalized.left(slash);
+    if (slash < 0 || (!first.contains(QLatin1Char('.')) && !first.contains(QLatin1Char(':')) && first != u"localhost"_s)) {
+        normalized.prepend(slash < 0 ? DockerHub + u"/library/"_s : DockerHub + QLatin1Char('/'));
+    } else {
+        normalized = canonicalRegistry(first) + normalized.mid(slash);
+    }
+
+    const qsizetype lastSlash = normalized.lastIndexOf(QLatin1Char('/'));
+    if (!normalized.contains(QLatin1Char('@')) && normalized.indexOf(QLatin1Char(':'), lastSlash) < 0) {
+        normalized += u":latest"_s;
+    }
+    return normalized;
+}
+
+QString mirrorReference(const Settings &settings, const QString &reference)
+{
+    const QString normalized = normalizedReference(reference);
+    if (normalized.isEmpty()) {
+        return {};
+    }
+    const auto [registry, path] = splitRegistry(normalized);
+
+    switch (settings.mode) {
+    case Mode::Local:
+        return registry == DockerHub ? QString::fromLatin1(LocalMirrorAddress) + QLatin1Char('/') + path : QString();
+    case Mode::Site: {
+        QString mirror = settings.siteMirror.trimmed();
+        while (mirror.endsWith(QLatin1Char('/'))) {
+            mirror.chop(1);
+        }
+        if (mirror.isEmpty() || registry != canonicalRegistry(settings.mirroredRegistry)) {
+            return {};
+        }
+        return mirror + QLatin1Char('/') + path;
+    }
+    case Mode::Off:
+        break;
+    }
+    return {};
+}
+
+PullSource prepareImage(const Settings &settings, const QString &reference)
+{
+    const QString normalized = normalizedReference(reference);
+    if (normalized.isEmpty()) {
+        return PullSource::Failed;
+    }
+
+    const QString manager = DistroboxCli::containerManager();
+    if (imageExists(manager, normalized)) {
+        logPull(PullSource::Local, normalized);
+        return PullSource::Local;
+    }
+
+    const QString mirror = mirrorReference(settings, normalized);
+    const bool local = settings.mode == Mode::Local;
+    if (!mirror.isEmpty() && (!local || startLocalMirror())) {
+        // The local mirror proxies every pull, only its own counters tell whether the layers came
+        // from its cache. A site mirror is what served the image as far as this machine is concerned
+        const qint64 missesBefore = local ? localMirrorBlobMisses(manager) : -1;
+        if (pullFromMirror(manager, settings, mirror, normalized)) {
+            const qint64 missesAfter = local ? localMirrorBlobMisses(manager) : -1;
+            const PullSource source = missesBefore >= 0 && missesAfter > missesBefore ? PullSource::MirrorMiss : PullSource::Mirror;
+            logPull(source, normalized);
+            return source;
+        }
+    }
+
+    if (!mirror.isEmpty()) {
+        qWarning() << "Could not pull" << mirror << "from the mirror, leaving it to the upstream registry";
+    }
+
+    // distrobox create pulls it from upstream
+    logPull(PullSource::Upstream, normalized);
+    return PullSource::Upstream;
+}
+
+bool refreshPinnedImages(const Settings &settings)
+{
+    const QString manager = DistroboxCli::containerManager();
+    const QSet<QString> present = localReferences(manager);
+
+    bool success = true;
+    for (const QString &image : settings.pinnedImages) {
+        if (present.contains(image)) {
+            continue;
+        }
+        if (prepareImage(settings, image) != PullSource::Upstream) {
+            continue;
+        }
+
+        bool pulled = false;
+        DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"pull"_s, image}), pulled, DistroboxCli::LongTimeoutMs);
+        if (!pulled) {
+            logPull(PullSource::Failed, image);
+            success = false;
+        }
+    }
+    return success;
+}
+
+bool startLocalMirror()
+{
+    if (isLocalMirrorRunning()) {
+        return true;
+    }
+
+    const QString manager = DistroboxCli::containerManager();
+    bool exists = false;
+    const QString environment = DistroboxCli::runCommand(
+        DistroboxCli::Command(manager, {u"container"_s, u"inspect"_s, u"--format"_s, u"{{range .Config.Env}}{{println .}}{{end}}"_s, LocalMirrorContainer}),
+        exists);
+    // Mirrors created before the debug server was configured cannot report their hits, the cache
+    // lives in the volume and survives the re-creation
+    if (exists && !environment.contains(u"REGISTRY_HTTP_DEBUG_ADDR="_s)) {
+        bool removed = false;
+        DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"rm"_s, u"--force"_s, LocalMirrorContainer}), removed);
+        exists = !removed;
+    }
+
+    bool started = false;
+    if (exists) {
+        DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"start"_s, LocalMirrorContainer}), started);
+    } else {
+        // Published on the loopback interface only, the cache is no business of the network
+        const QString port = QString::fromLatin1(LocalMirrorAddress).section(QLatin1Char(':'), 1);
+        DistroboxCli::runCommand(DistroboxCli::Command(manager,
+                                                       {u"run"_s,
+                                                        u"--detach"_s,
+                                                        u"--name"_s,
+                                                        LocalMirrorContainer,
+                                                        u"--publish"_s,
+                                                        u"127.0.0.1:%1:5000"_s.arg(port),
+                                                        u"--env"_s,
+                                                        u"REGISTRY_PROXY_REMOTEURL=%1"_s.arg(LocalMirrorUpstream),
+                                                        u"--env"_s,
+                                                        u"REGISTRY_HTTP_DEBUG_ADDR=%1"_s.arg(LocalMirrorDebugAddress),
+                                                        u"--volume"_s,
+                                                        u"%1:/var/lib/registry"_s.arg(LocalMirrorVolume),
+                                                        LocalMirrorImage}),
+                                 started,
+                                 DistroboxCli::LongTimeoutMs);
+    }
+    if (!started) {
+        return false;
+    }
+
+    for (int poll = 0; poll < MirrorStartupPolls; ++poll) {
+        if (isLocalMirrorRunning()) {
+            return true;
+        }
+        QThread::msleep(MirrorStartupPollMs);
+    }
+    return false;
+}
+
+bool stopLocalMirror()
+{
+    if (!isLocalMirrorRunning()) {
+        return true;
+    }
+    bool stopped = false;
+    DistroboxCli::runCommand(DistroboxCli::Command(DistroboxCli::containerManager(), {u"stop"_s, LocalMirrorContainer}), stopped);
+    return stopped;
+}
+
+bool isLocalMirrorRunning()
+{
+    bool success = false;
+    const QString output = DistroboxCli::runCommand(
+        DistroboxCli::Command(DistroboxCli::containerManager(), {u"container"_s, u"inspect"_s, u"--format"_s, u"{{.State.Running}}"_s, LocalMirrorContainer}),
+        success);
+    return success && output.trimmed() == u"true"_s;
+}
+
+Statistics statistics()
+{
+    QStringList lines;
+    {
+        QMutexLocker locker(&logMutex);
+        QFile file(logPath());
+        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            lines = QString::fromUtf8(file.readAll()).split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+        }
+    }
+    if (lines.size() > StatisticsWindow) {
+        lines = lines.mid(lines.size() - StatisticsWindow);
+    }
+
+    Statistics result;
+    for (const QString &line : std::as_const(lines)) {
+        const QString source = line.section(QLatin1Char('\t'), 1, 1);
+        ++result.pulls;
+        if (source == u"local"_s) {
+            ++result.localHits;
+        } else if (source == u"mirror"_s) {
+            ++result.mirrorHits;
+        } else if (source == u"mirror-miss"_s) {
+            ++result.mirrorMisses;
+        } else if (source == u"upstream"_s) {
+            ++result.upstreamPulls;
+        } else {
+            ++result.failures;
+        }
+    }
+    return result;
+}
+
+QString statusJson()
+{
+    const Settings current = settings();
+    const Statistics stats = statistics();
+    const QSet<QString> present = current.pinnedImages.isEmpty() ? QSet<QString>() : localReferences(DistroboxCli::containerManager());
+
+    QJsonArray pinned;
+    for (const QString &image : current.pinnedImages) {
+        QJsonObject entry;
+        entry[u"image"_s] = image;
+        entry[u"present"_s] = present.contains(image);
+        pinned.append(entry);
+    }
+
+    QJsonObject object;
+    object[u"mode"_s] = modeName(current.mode);
+    object[u"siteMirror"_s] = current.siteMirror;
+    object[u"mirroredRegistry"_s] = current.mirroredRegistry;
+    object[u"insecure"_s] = current.insecure;
+    object[u"localMirror"_s] = QString::fromLatin1(LocalMirrorAddress);
+    object[u"localMirrorRunning"_s] = current.mode == Mode::Local && isLocalMirrorRunning();
+    object[u"pinned"_s] = pinned;
+    object[u"pulls"_s] = stats.pulls;
+    object[u"localHits"_s] = stats.localHits;
+    object[u"mirrorHits"_s] = stats.mirrorHits;
+    object[u"mirrorMisses"_s] = stats.mirrorMisses;
+    object[u"upstreamPulls"_s] = stats.upstreamPulls;
+    object[u"failures"_s] = stats.failures;
+    object[u"networkPulls"_s] = stats.networkPulls();
+    object[u"hitRate"_s] = int(std::lround(stats.hitRate() * 100));
+    return QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Compact));
+}
+}
@@ -0,0 +1,110 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * Pulls of container images through a registry mirror, and base images kept pinned locally.
+ *
+ * The mirror is either a pull-through cache registry Kontainer runs itself on localhost, which
+ * mirrors Docker Hub, or a site mirror of one upstream registry. Before a container is created
+ * its image is pulled from the mirror and tagged with its original name, so distrobox finds
+ * it locally and the container keeps the usual image name. When the mirror fails the image is
+ * left for distrobox to pull from upstream. Every pull is logged for the hit rate, the log
+ * keeps the recent pulls only. Whether a pull through the local mirror came from its cache is
+ * read from the registry's own proxy counters.
+ *
+ * The settings live in the application configuration, which is only read and written on the
+ * GUI thread. Functions running elsewhere get them passed in.
+ */
+namespace RegistryMirror
+{
+enum class Mode {
+    Off,
+    Local, ///< Pull-through cache registry in a container on this machine
+    Site, ///< Mirror run by someone else, e.g. a registry cache in the local network
+};
+
+struct Settings {
+    Mode mode = Mode::Off;
+    QString siteMirror; ///< Host, port and optional path prefix, e.g. "registry.lan:5000/hub"
+    QString mirroredRegistry = QStringLiteral("docker.io"); ///< Upstream registry the site mirror serves
+    bool insecure = false; ///< The site mirror speaks plain HTTP or has a self-signed certificate
+    QStringList pinnedImages; ///< Normalized references kept local and never offered for reclaiming
+};
+
+enum class PullSource {
+    Local, ///< Already present, nothing was pulled
+    Mirror,
+    MirrorMiss, ///< Through the local mirror, which had to fetch layers from upstream first
+    Upstream, ///< The image is not mirrored or the mirror failed
+    Failed,
+};
+
+struct Statistics {
+    int pulls = 0;
+    int localHits = 0;
+    int mirrorHits = 0;
+    int mirrorMisses = 0;
+    int upstreamPulls = 0;
+    int failures = 0;
+
+    // Images that had to be downloaded, from the mirror or upstream
+    int networkPulls() const
+    {
+        return mirrorHits + mirrorMisses + upstreamPulls;
+    }
+    // Share of the downloaded images the mirror served from its cache
+    double hitRate() const
+    {
+        return networkPulls() > 0 ? double(mirrorHits) / networkPulls() : 0.0;
+    }
+};
+
+// Registry address of the local mirror
+inline constexpr char LocalMirrorAddress[] = "localhost:5000";
+
+Settings settings();
+void setSettings(const Settings &settings);
+
+/**
+ * @brief Expands a short reference the way the container managers do, e.g. "fedora" to
+ * "docker.io/library/fedora:latest"
+ */
+QString normalizedReference(const QString &reference);
+
+/**
+ * @brief Reference of the image on the mirror, empty when the image is not mirrored
+ */
+QString mirrorReference(const Settings &settings, const QString &reference);
+
+/**
+ * @brief Makes the image local before a container is created from it
+ *
+ * Pulls it through the mirror when it is missing and mirrored. Blocks, call off the GUI thread.
+ */
+PullSource prepareImage(const Settings &settings, const QString &reference);
+
+/**
+ * @brief Pulls the pinned images that are missing locally
+ * @return false if one of them could be pulled neither from the mirror nor upstream
+ */
+bool refreshPinnedImages(const Settings &settings);
+
+/**
+ * @brief Starts the local mirror registry, creating it on first use
+ *
+ * Waits for the registry to come up, call off the GUI thread.
+ */
+bool startLocalMirror();
+bool stopLocalMirror();
+bool isLocalMirrorRunning();
+
+Statistics statistics();
+QString statusJson();
+}
@@ -0,0 +1,271 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "resourcelimits.h"
+
+#include <KFormat>
+#include <KLocalizedString>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+#include <QThread>
+
+#include <algorithm>
+#include <cmath>
+#include <unistd.h>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+constexpr int DefaultCpuShares = 1024;
+constexpr qint64 MiB = 1024 * 1024;
+
+// Physical memory of the host, /proc/meminfo is the host's in Flatpak too
+qint64 totalMemoryBytes()
+{
+    static const qint64 total = []() -> qint64 {
+        QFile file(u"/proc/meminfo"_s);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            return 0;
+        }
+        while (!file.atEnd()) {
+            const QByteArray line = file.readLine();
+            if (line.startsWith("MemTotal:")) {
+                return line.mid(9).trimmed().split(' ').constFirst().toLongLong() * 1024;
+            }
+        }
+        return 0;
+    }();
+    return total;
+}
+
+// Rounded down to whole MiB, the container managers reject odd byte counts on some cgroup versions
+qint64 memoryShare(double fraction)
+{
+    return qint64(totalMemoryBytes() * fraction) / MiB * MiB;
+}
+
+QString cpusArgument(double cpus)
+{
+    return QString::number(cpus, 'f', 2);
+}
+
+// Options are only added when their controller is available
+ResourceLimits::Limits applicable(ResourceLimits::Limits limits, const ResourceLimits::Controllers &controllers)
+{
+    if (!controllers.cpu) {
+        limits.cpus = 0;
+        limits.cpuShares = 0;
+    }
+    if (!controllers.memory) {
+        limits.memoryBytes = 0;
+    }
+    if (!controllers.io) {
+        limits.ioWeight = 0;
+    }
+    return limits;
+}
+}
+
+namespace ResourceLimits
+{
+Controllers delegatedControllers(bool rootful)
+{
+    Controllers controllers;
+    if (rootful || !DistroboxCli::containerManager().endsWith(u"podman"_s)) {
+        return controllers;
+    }
+
+    // Without the unified hierarchy rootless podman cannot limit anything
+    if (!QFile::exists(u"/sys/fs/cgroup/cgroup.controllers"_s)) {
+        return Controllers{false, false, false};
+    }
+
+    const uid_t uid = ::getuid();
+    QFile file(u"/sys/fs/cgroup/user.slice/user-%1.slice/user@%1.service/cgroup.controllers"_s.arg(uid));
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        // Not a systemd layout we know, leave it to the container manager
+        return controllers;
+    }
+
+    const QList<QByteArray> names = file.readAll().simplified().split(' ');
+    controllers.cpu = names.contains("cpu");
+    controllers.memory = names.contains("memory");
+    controllers.io = names.contains("io");
+    return controllers;
+}
+
+QStringList presetNames()
+{
+    return {u"none"_s, u"background"_s, u"interactive"_s, u"build"_s};
+}
+
+Limits preset(const QString &name)
+{
+    const int cores = std::max(1, QThread::idealThreadCount());
+
+    Limits limits;
+    if (name == u"background"_s) {
+        limits.cpus = std::max(1.0, cores / 4.0);
+        limits.cpuShares = DefaultCpuShares / 4;
+        limits.memoryBytes = memoryShare(0.25);
+        limits.ioWeight = 100;
+    } else if (name == u"interactive"_s) {
+        limits.cpuShares = DefaultCpuShares;
+        limits.memoryBytes = memoryShare(0.5);
+        limits.ioWeight = 500;
+    } else if (name == u"build"_s) {
+        // One core and a higher weight stay with the desktop
+        limits.cpus = std::max(1, cores - 1);
+        limits.cpuShares = DefaultCpuShares / 2;
+        limits.memoryBytes = memoryShare(0.75);
+        limits.ioWeight = 250;
+    }
+    return limits;
+}
+
+QStringList createFlags(const Limits &requested, const Controllers &controllers)
+{
+    const Limits limits = applicable(requested, controllers);
+    QStringList flags;
+    if (limits.cpus > 0) {
+        flags << u"--cpus=%1"_s.arg(cpusArgument(limits.cpus));
+    }
+    if (limits.cpuShares > 0) {
+        flags << u"--cpu-shares=%1"_s.arg(limits.cpuShares);
+    }
+    if (limits.memoryBytes > 0) {
+        flags << u"--memory=%1"_s.arg(limits.memoryBytes);
+    }
+    if (limits.ioWeight > 0) {
+        flags << u"--blkio-weight=%1"_s.arg(std::clamp(limits.ioWeight, 10, 1000));
+    }
+    return flags;
+}
+
+DistroboxCli::Command updateCommand(const QString &container, const Limits &requested, const Controllers &controllers)
+{
+    const Limits limits = applicable(requested, controllers);
+    DistroboxCli::Command command(DistroboxCli::containerManager(), {u"update"_s});
+
+    // No quota lifts a previous one, the other limits are kept when left at 0
+    if (controllers.cpu) {
+        command << (limits.cpus > 0 ? u"--cpus=%1"_s.arg(cpusArgument(limits.cpus)) : u"--cpu-quota=-1"_s);
+    }
+    if (limits.cpuShares > 0) {
+        command << u"--cpu-shares=%1"_s.arg(limits.cpuShares);
+    }
+    if (limits.memoryBytes > 0) {
+        // Swap is left unlimited, otherwise raising the memory above the swap limit set at creation fails
+        command << u"--memory=%1"_s.arg(limits.memoryBytes) << u"--memory-swap=-1"_s;
+    }
+    if (limits.ioWeight > 0) {
+        command << u"--blkio-weight=%1"_s.arg(std::clamp(limits.ioWeight, 10, 1000));
+    }
+    command << container;
+    return command;
+}
+
+Limits current(const QString &container, bool &success)
+{
+    const QString format = u"{{.HostConfig.NanoCpus}}|{{.HostConfig.CpuShares}}|{{.HostConfig.Memory}}|{{.HostConfig.BlkioWeight}}"_s;
+    const QString output = DistroboxCli::runCommand(
+        DistroboxCli::Command(DistroboxCli::containerManager(), {u"container"_s, u"inspect"_s, u"--format"_s, format, container}),
+        success);
+
+    Limits limits;
+    const QStringList fields = output.trimmed().split(QLatin1Char('|'));
+    if (!success || fields.size() < 4) {
+        success = false;
+        return limits;
+    }
+
+    limits.cpus = fields[0].toLongLong() / 1e9;
+    limits.cpuShares = fields[1].toInt();
+    limits.memoryBytes = fields[2].toLongLong();
+    limits.ioWeight = fields[3].toInt();
+    return limits;
+}
+
+QString limitsJson(const Limits &limits)
+{
+    QJsonObject object;
+    object[u"cpus"_s] = std::round(limits.cpus * 100) / 100;
+    object[u"cpuShares"_s] = limits.cpuShares;
+    object[u"memoryMiB"_s] = limits.memoryBytes / MiB;
+    object[u"ioWeight"_s] = limits.ioWeight;
+    return QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Compact));
+}
+
+QString controllersJson(const Controllers &controllers)
+{
+    QStringList missing;
+    if (!controllers.cpu) {
+        missing << u"cpu"_s;
+    }
+    if (!controllers.memory) {
+        missing << u"memory"_s;
+    }
+    if (!controllers.io) {
+        missing << u"io"_s;
+    }
+
+    QJsonObject object;
+    object[u"cpu"_s] = controllers.cpu;
+    object[u"memory"_s] = controllers.memory;
+    object[u"io"_s] = controllers.io;
+    object[u"note"_s] = missing.isEmpty()
+        ? QString()
+        : i18np("The %2 cgroup controller is not delegated to your user, so rootless containers cannot be limited by it and those limits are left out. "
+                "Delegate it to user@.service with a systemd drop-in to use them.",
+                "The %2 cgroup controllers are not delegated to your user, so rootless containers cannot be limited by them and those limits are left out. "
+                "Delegate them to user@.service with a systemd drop-in to use them.",
+                missing.size(),
+                missing.join(u", "_s));
+    return QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Compact));
+}
+
+QString presetsJson()
+{
+    const KFormat format;
+    const QHash<QString, QString> labels{
+        {u"none"_s, i18nc("@item resource limits preset", "No limits")},
+        {u"background"_s, i18nc("@item resource limits preset", "Background")},
+        {u"interactive"_s, i18nc("@item resource limits preset", "Interactive")},
+        {u"build"_s, i18nc("@item resource limits preset", "Build")},
+    };
+
+    QJsonArray array;
+    for (const QString &name : presetNames()) {
+        const Limits limits = preset(name);
+
+        QStringList summary;
+        if (limits.cpus > 0) {
+            summary << i18n("%1 cores", QLocale().toString(limits.cpus, 'g', 3));
+        }
+        if (limits.memoryBytes > 0) {
+            summary << i18n("%1 of memory", format.formatByteSize(limits.memoryBytes, 0));
+        }
+        if (limits.cpuShares > 0 && limits.cpuShares < DefaultCpuShares) {
+            summary << i18n("lower priority");
+        }
+
+        QJsonObject object;
+        object[u"name"_s] = name;
+        object[u"label"_s] = labels.value(name);
+        object[u"summary"_s] = summary.join(u", "_s);
+        object[u"cpus"_s] = std::round(limits.cpus * 100) / 100;
+        object[u"cpuShares"_s] = limits.cpuShares;
+        object[u"memoryMiB"_s] = limits.memoryBytes / MiB;
+        object[u"ioWeight"_s] = limits.ioWeight;
+        array.append(object);
+    }
+    return QString::fromUtf8(QJsonDocument(array).toJson(QJsonDocument::Compact));
+}
+}
@@ -0,0 +1,86 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include "distroboxcli.h"
+
+#include <QString>
+#include <QStringList>
+
+/**
+ * CPU, memory and IO limits of containers, backed by their cgroup.
+ *
+ * Presets scale with the machine: "background" keeps a container out of the way of the
+ * desktop, "interactive" only caps memory, "build" may use all but one core at a lower
+ * priority than the desktop. Limits are passed to the container manager when a container
+ * is created, and changed on a running container with its update command. Rootless
+ * containers need the cpu, memory and io controllers delegated to the user by systemd,
+ * limits of controllers that are not delegated are left out instead of failing the command.
+ */
+namespace ResourceLimits
+{
+struct Limits {
+    double cpus = 0; ///< CPU quota in cores, 0 for no quota
+    int cpuShares = 0; ///< Relative CPU weight, 1024 is the default, 0 to keep it
+    qint64 memoryBytes = 0; ///< Hard memory limit, 0 for none
+    int ioWeight = 0; ///< Relative block IO weight from 10 to 1000, 0 to keep it
+
+    bool isEmpty() const
+    {
+        return cpus <= 0 && cpuShares <= 0 && memoryBytes <= 0 && ioWeight <= 0;
+    }
+};
+
+// cgroup controllers the limits can be applied with
+struct Controllers {
+    bool cpu = true; ///< --cpus and --cpu-shares
+    bool memory = true;
+    bool io = true; ///< --blkio-weight
+
+    bool all() const
+    {
+        return cpu && memory && io;
+    }
+};
+
+/**
+ * @brief Controllers systemd delegates to this user, which rootless podman containers are limited to
+ * @param rootful Whether the container runs rootful, those and docker ones may use every controller
+ */
+Controllers delegatedControllers(bool rootful = false);
+
+QStringList presetNames();
+
+/**
+ * @brief Limits of a preset on this machine, empty for "none" and unknown names
+ */
+Limits preset(const QString &name);
+
+/**
+ * @brief Container manager options applying the limits, for distrobox create --additional-flags
+ *
+ * Limits of controllers that are not available are left out.
+ */
+QStringList createFlags(const Limits &limits, const Controllers &controllers);
+
+/**
+ * @brief Command changing the limits of an existing container without re-creating it
+ *
+ * A CPU quota of 0 lifts the current quota, the other limits are kept when left at 0.
+ * Limits of controllers that are not available are left out.
+ */
+DistroboxCli::Command updateCommand(const QString &container, const Limits &limits, const Controllers &controllers);
+
+/**
+ * @brief Reads the limits a container currently runs with. Blocks.
+ */
+Limits current(const QString &container, bool &success);
+
+QString limitsJson(const Limits &limits);
+// Which controllers are available, and a note on the missing ones for the user
+QString controllersJson(const Controllers &controllers);
+QString presetsJson();
+}
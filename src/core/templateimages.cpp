@@ -0,0 +1,208 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "templateimages.h"
+
+#include "distroboxcli.h"
+
+#include <KConfigGroup>
+#include <KFormat>
+#include <KSharedConfig>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+#include <QRegularExpression>
+
+#include <algorithm>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+KConfigGroup templatesGroup()
+{
+    return KConfigGroup(KSharedConfig::openConfig(), u"Templates"_s);
+}
+
+TemplateImages::Template readTemplate(const KConfigGroup &group)
+{
+    TemplateImages::Template entry;
+    entry.name = group.name();
+    entry.image = group.readEntry("Image", TemplateImages::imageForName(entry.name));
+    entry.sourceContainer = group.readEntry("SourceContainer", QString());
+    entry.created = group.readEntry("Created", QDateTime());
+    entry.squashed = group.readEntry("Squashed", false);
+    return entry;
+}
+}
+
+namespace TemplateImages
+{
+QString imageForName(const QString &name)
+{
+    return u"localhost/kontainer-template/%1:latest"_s.arg(sanitizedName(name));
+}
+
+// Image names must be lowercase and may only contain a few separators
+QString sanitizedName(const QString &name)
+{
+    static const QRegularExpression invalid(u"[^a-z0-9._-]+"_s);
+    QString result = name.trimmed().toLower().replace(invalid, u"-"_s);
+    while (!result.isEmpty() && !result.front().isLetterOrNumber()) {
+        result.remove(0, 1);
+    }
+    return result;
+}
+
+std::optional<DistroboxCli::Command> commitCommand(const QString &container, const QString &name, bool squash)
+{
+    const QString templateName = sanitizedName(name);
+    if (container.isEmpty() || templateName.isEmpty()) {
+        return std::nullopt;
+    }
+
+    const QString manager = DistroboxCli::containerManager();
+    const QString image = imageForName(templateName);
+
+    if (squash && manager == u"docker"_s) {
+        // The names travel as positional parameters, the shell only provides the pipe
+        DistroboxCli::Command command(u"sh"_s, {u"-c"_s, u"docker export \"$1\" | docker import - \"$2\""_s, u"sh"_s, container, image});
+        command.quiet = true;
+        return command;
+    }
+
+    DistroboxCli::Command command(manager, {u"container"_s, u"commit"_s, u"--pause=true"_s});
+    command.quiet = true;
+    if (squash) {
+        command << u"--squash"_s;
+    }
+    return command << container << image;
+}
+
+void record(const QString &container, const QString &name, bool squash)
+{
+    const QString templateName = sanitizedName(name);
+
+    KConfigGroup group = templatesGroup().group(templateName);
+    group.writeEntry("Image", imageForName(templateName));
+    group.writeEntry("SourceContainer", container);
+    group.writeEntry("Created", QDateTime::currentDateTimeUtc());
+    group.writeEntry("Squashed", squash);
+    group.sync();
+}
+
+QList<Template> tracked()
+{
+    QList<Template> templates;
+    const KConfigGroup group = templatesGroup();
+    for (const QString &name : group.groupList()) {
+        templates.append(readTemplate(group.group(name)));
+    }
+
+    std::sort(templates.begin(), templates.end(), [](const Template &a, const Template &b) {
+        return a.created > b.created;
+    });
+    return templates;
+}
+
+QList<Template> list(const QList<Template> &tracked, QStringList &missing)
+{
+    bool listed = false;
+    const QList<DistroboxCli::LocalImage> images = DistroboxCli::localImages(listed);
+    if (!listed) {
+        // Unknown, not gone, so nothing is forgotten
+        return tracked;
+    }
+
+    QHash<QString, qint64> sizeByTag;
+    for (const DistroboxCli::LocalImage &image : images) {
+        for (const QString &tag : image.tags) {
+            sizeByTag.insert(tag, image.sizeBytes);
+        }
+    }
+
+    QList<Template> templates;
+    for (Template entry : tracked) {
+        const auto size = sizeByTag.constFind(entry.image);
+        if (size == sizeByTag.cend()) {
+            missing.append(entry.name);
+            continue;
+        }
+
+        entry.sizeBytes = size.value();
+        templates.append(entry);
+    }
+    return templates;
+}
+
+void forget(const QStringList &names)
+{
+    if (names.isEmpty()) {
+        return;
+    }
+
+    KConfigGroup group = templatesGroup();
+    for (const QString &name : names) {
+        group.group(name).deleteGroup();
+    }
+    group.sync();
+}
+
+bool remove(const QStringList &names)
+{
+    const QString manager = DistroboxCli::containerManager();
+
+    bool allRemoved = true;
+    for (const QString &name : names) {
+        KConfigGroup group = templatesGroup().group(name);
+        if (!group.exists()) {
+            continue;
+        }
+
+        const Template entry = readTemplate(group);
+        bool removed = false;
+        DistroboxCli::runCommand(DistroboxCli::Command(manager, {u"rmi"_s, entry.image}), removed);
+
+        if (!removed) {
+            // An image that is already gone only needs forgetting
+            QStringList missing;
+            list({entry}, missing);
+            if (missing.isEmpty()) {
+                allRemoved = false;
+                continue;
+            }
+        }
+
+        group.deleteGroup();
+    }
+
+    templatesGroup().sync();
+    return allRemoved;
+}
+
+QString listJson(const QList<Template> &templates)
+{
+    const KFormat format;
+
+    QJsonArray array;
+    for (const Template &entry : templates) {
+        QJsonObject object;
+        object[u"name"_s] = entry.name;
+        object[u"image"_s] = entry.image;
+        object[u"sourceContainer"_s] = entry.sourceContainer;
+        object[u"created"_s] = entry.created.toString(Qt::ISODate);
+        object[u"createdText"_s] = QLocale().toString(entry.created.toLocalTime(), QLocale::ShortFormat);
+        object[u"squashed"_s] = entry.squashed;
+        object[u"sizeBytes"_s] = entry.sizeBytes;
+        if (entry.sizeBytes >= 0) {
+            object[u"size"_s] = format.formatByteSize(entry.sizeBytes);
+        }
+        array.append(object);
+    }
+    return QString::fromUtf8(QJsonDocument(array).toJson());
+}
+}
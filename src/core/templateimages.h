@@ -0,0 +1,89 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include "distroboxcli.h"
+
+#include <QDateTime>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include <optional>
+
+/**
+ * Local images committed from provisioned containers, so new containers start from a
+ * configured system instead of repeating the package installs.
+ *
+ * Templates are tagged localhost/kontainer-template/<name>:latest. Where each one came
+ * from is recorded in the application config, entries whose image was removed behind our
+ * back are forgotten after listing. The config is only touched from the GUI thread.
+ */
+namespace TemplateImages
+{
+struct Template {
+    QString name;
+    QString image; ///< Local image reference
+    QString sourceContainer;
+    QDateTime created;
+    bool squashed = false;
+    qint64 sizeBytes = -1; ///< -1 when not queried
+};
+
+/**
+ * @brief Name usable in an image reference, lowercase with unsupported characters replaced
+ */
+QString sanitizedName(const QString &name);
+
+/**
+ * @brief Image reference a template of the given name is tagged with
+ */
+QString imageForName(const QString &name);
+
+/**
+ * @brief Command committing the container to a template image
+ * @param squash Flatten the layers into one, smaller on disk but shares nothing with the base image
+ * @return Nothing when the container or the name is empty
+ *
+ * The container is paused while its filesystem is copied. Docker has no squashing commit,
+ * there the container is exported and re-imported, which drops the image configuration
+ * distrobox does not need anyway.
+ */
+std::optional<DistroboxCli::Command> commitCommand(const QString &container, const QString &name, bool squash);
+
+/**
+ * @brief Records a template once commitCommand() succeeded
+ */
+void record(const QString &container, const QString &name, bool squash);
+
+/**
+ * @brief Templates recorded in the config, without asking the container manager
+ */
+QList<Template> tracked();
+
+/**
+ * @brief Templates whose image still exists, with their size, blocking
+ * @param tracked Templates as returned by tracked()
+ * @param missing Receives the names of templates whose image is definitely gone
+ *
+ * Queries all images at once and does not touch the config, safe to call from any thread.
+ * When the images cannot be listed the templates are returned without their size.
+ */
+QList<Template> list(const QList<Template> &tracked, QStringList &missing);
+
+/**
+ * @brief Forgets templates whose image is gone
+ */
+void forget(const QStringList &names);
+
+/**
+ * @brief Removes the images of the templates and forgets them, blocking
+ * @return false if any image could not be removed, e.g. because a container uses it
+ */
+bool remove(const QStringList &names);
+
+QString listJson(const QList<Template> &templates);
+}
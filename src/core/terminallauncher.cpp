@@ -9,14 +9,28 @@
 #include <KService>
 #include <KSharedConfig>
 #include <KShell>
+#include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
+#include <QFileInfo>
 #include <QObject>
+#include <QPointer>
 #include <QProcess>
 #include <QStandardPaths>
 #include <QStringList>
+#include <QTimer>
+#include <QUuid>
+
+#include <memory>
+#include <optional>
 
 namespace
 {
+// Terminals handing the window to a running instance return at once, the status file is
+// polled until the command wrote it, up to this long
+constexpr int StatusPollIntervalMs = 1000;
+constexpr qint64 StatusPollLimitMs = 2 * 60 * 60 * 1000;
+
 struct TerminalLaunchConfig {
     QString commandLine;
     QString desktopName;
@@ -56,7 +70,70 @@ bool hostExecutableExists(const QString &executable)
     return process.exitCode() == 0;
 }
 
-TerminalLaunchConfig buildTerminalLaunchConfig(const QString &command, const QString &workingDirectory)
+// In the cache directory, which the host sees under the same path in a Flatpak too
+QString statusFilePath()
+{
+    const QString directory = QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath(QStringLiteral("kontainer/terminal"));
+    QDir().mkpath(directory);
+    return QDir(directory).filePath(QUuid::createUuid().toString(QUuid::WithoutBraces) + QStringLiteral(".status"));
+}
+
+// Whether the command exited with 0, nothing while it has not recorded its status yet
+std::optional<bool> readStatusFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+    const bool success = file.readAll().trimmed() == "0";
+    file.remove();
+    return success;
+}
+
+// Polls for the status once the terminal returned, the command may still run in another process
+void waitForStatusFile(const QString &path, QObject *context, const std::function<void(bool)> &callback)
+{
+    if (const std::optional<bool> status = readStatusFile(path)) {
+        callback(*status);
+        return;
+    }
+
+    auto *timer = new QTimer(context);
+    auto waited = std::make_shared<QElapsedTimer>();
+    waited->start();
+    timer->setInterval(StatusPollIntervalMs);
+    QObject::connect(timer, &QTimer::timeout, timer, [timer, waited, path, callback]() {
+        std::optional<bool> status = readStatusFile(path);
+        if (!status && !waited->hasExpired(StatusPollLimitMs)) {
+            return;
+        }
+        timer->deleteLater();
+        // Closed before the command finished, or never started
+        if (!status) {
+            QFile::remove(path);
+        }
+        callback(status.value_or(false));
+    });
+    timer->start();
+}
+
+// Options keeping the terminal in the foreground until the command finished, instead of
+// handing the window to an already running instance
+QString waitOption(const QString &programName)
+{
+    if (programName.startsWith(QLatin1String("konsole"))) {
+        return QStringLiteral(" --nofork");
+    }
+    if (programName == QLatin1String("gnome-terminal")) {
+        return QStringLiteral(" --wait");
+    }
+    if (programName == QLatin1String("xfce4-terminal")) {
+        return QStringLiteral(" --disable-server");
+    }
+    return QString();
+}
+
+TerminalLaunchConfig buildTerminalLaunchConfig(const QString &command, const QString &workingDirectory, bool wait)
 {
     TerminalLaunchConfig config;
 
@@ -97,6 +174,9 @@ TerminalLaunchConfig buildTerminalLaunchConfig(const QString &command, const QSt
         const bool isKonsole = programName.startsWith(QLatin1String("konsole"));
         const bool isXterm = programName == QLatin1String("xterm");
 
+        if (wait) {
+            exec += waitOption(programName);
+        }
         if (isKonsole && !workingDirectory.isEmpty()) {
             exec += QStringLiteral(" --workdir %1").arg(KShell::quoteArg(workingDirectory));
         }
@@ -147,6 +227,10 @@ TerminalLaunchConfig buildTerminalLaunchConfig(const QString &command, const QSt
 
     const bool isKonsole = exec.startsWith(QLatin1String("konsole")) || config.desktopName == QStringLiteral("org.kde.konsole");
 
+    if (wait) {
+        const QStringList execParts = KShell::splitArgs(exec);
+        exec += isKonsole ? QStringLiteral(" --nofork") : waitOption(execParts.isEmpty() ? QString() : QFileInfo(execParts.first()).fileName());
+    }
     if (isKonsole && !workingDirectory.isEmpty()) {
         exec += QStringLiteral(" --workdir %1").arg(KShell::quoteArg(workingDirectory));
     }
@@ -168,9 +252,18 @@ namespace TerminalLauncher
 {
 bool launch(const QString &command, const QString &workingDirectory, QObject *parent, const std::function<void(bool)> &onFinished)
 {
-    Q_UNUSED(parent);
+    QString statusFile;
+    QString terminalCommand = command;
+    if (onFinished && !command.isEmpty()) {
+        // Written aside and renamed, so the file only appears once complete
+        statusFile = statusFilePath();
+        const QString partialFile = statusFile + QStringLiteral(".part");
+        terminalCommand = QStringLiteral("sh -c %1")
+                              .arg(KShell::quoteArg(QStringLiteral("%1; echo $? > %2 && mv %2 %3")
+                                                        .arg(command, KShell::quoteArg(partialFile), KShell::quoteArg(statusFile))));
+    }
 
-    const TerminalLaunchConfig config = buildTerminalLaunchConfig(command, workingDirectory);
+    const TerminalLaunchConfig config = buildTerminalLaunchConfig(terminalCommand, workingDirectory, !statusFile.isEmpty());
     if (!config.valid) {
         if (onFinished) {
             auto callback = onFinished;
@@ -187,15 +280,24 @@ bool launch(const QString &command, const QString &workingDirectory, QObject *pa
     QObject::connect(process,
                      QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
                      process,
-                     [process, callback = onFinished](int exitCode, QProcess::ExitStatus exitStatus) {
+                     [process, context = QPointer<QObject>(parent), callback = onFinished, statusFile]() {
                          process->deleteLater();
-                         if (callback) {
-                             const bool success = exitStatus == QProcess::NormalExit && exitCode == 0;
-                             callback(success);
+                         if (callback && context) {
+                             waitForStatusFile(statusFile, context, callback);
                          }
                      });
 
-    process->startCommand(config.commandLine);
+    // Split like a shell does, the commands quote their scripts with single quotes too
+    const QStringList arguments = KShell::splitArgs(config.commandLine);
+    if (arguments.isEmpty()) {
+        process->deleteLater();
+        if (onFinished) {
+            auto callback = onFinished;
+            callback(false);
+        }
+        return false;
+    }
+    process->start(arguments.first(), arguments.mid(1));
     if (!process->waitForStarted()) {
         process->deleteLater();
         if (onFinished) {
@@ -12,5 +12,13 @@ class QObject;
 
 namespace TerminalLauncher
 {
+/**
+ * @brief Runs the command in a terminal window
+ *
+ * onFinished gets whether the command itself exited with 0 once it finished. The command
+ * records its exit status in a file for that, the exit code of the terminal says nothing
+ * about it. Known terminals are asked to stay in the foreground until the command finished;
+ * for the others the file is polled after the terminal returned. parent bounds the wait.
+ */
 Q_REQUIRED_RESULT bool launch(const QString &command, const QString &workingDirectory, QObject *parent, const std::function<void(bool)> &onFinished = {});
 }
@@ -0,0 +1,269 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#include "updateprefetcher.h"
+
+#include "containermetadata.h"
+#include "distroboxcli.h"
+#include "packageinstallcommand.h"
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QPointer>
+#include <QThread>
+
+using namespace Qt::Literals::StringLiterals;
+using PackageInstallCommand::PackageManager;
+
+namespace
+{
+constexpr int CheckIntervalMs = 15 * 60 * 1000;
+constexpr int FirstCheckDelayMs = 2 * 60 * 1000;
+constexpr int DefaultIntervalHours = 6;
+constexpr double IdleLoadPerCpu = 0.3;
+
+KConfigGroup prefetchGroup()
+{
+    return KConfigGroup(KSharedConfig::openConfig(), u"UpdatePrefetch"_s);
+}
+
+QByteArray readSysfs(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    return file.readAll().trimmed();
+}
+
+// Machines without a battery are always on AC
+bool onAcPower()
+{
+    const QDir supplies(u"/sys/class/power_supply"_s);
+    bool hasBattery = false;
+    for (const QString &supply : supplies.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        const QByteArray type = readSysfs(supplies.filePath(supply + u"/type"_s));
+        if (type == "Mains" && readSysfs(supplies.filePath(supply + u"/online"_s)) == "1") {
+            return true;
+        }
+        if (type == "Battery") {
+            hasBattery = true;
+        }
+    }
+    return !hasBattery;
+}
+
+bool isIdle()
+{
+    const QByteArray loadAverage = readSysfs(u"/proc/loadavg"_s);
+    bool ok = false;
+    const double load = loadAverage.split(' ').value(0).toDouble(&ok);
+    return ok && load < IdleLoadPerCpu * QThread::idealThreadCount();
+}
+
+// Fetches the updates without installing them and prints how many are pending on the last line.
+// Runs unattended, so sudo must not prompt.
+std::optional<QString> prefetchScript(PackageManager packageManager)
+{
+    switch (packageManager) {
+    case PackageManager::Dnf:
+        return u"sudo -n dnf upgrade -y -q --downloadonly >/dev/null 2>&1 || exit 1; "
+               "dnf -q -C check-update 2>/dev/null | awk 'NF == 3 && $1 ~ /\\./' | wc -l"_s;
+    case PackageManager::Apt:
+        return u"sudo -n apt-get update -qq >/dev/null 2>&1 && sudo -n apt-get upgrade -d -y -qq >/dev/null 2>&1 || exit 1; "
+               "apt-get upgrade -s -qq 2>/dev/null | grep -c '^Inst ' || true"_s;
+    case PackageManager::Pacman:
+        // pacman -Syw would leave a synced database behind and invite partial upgrades,
+        // checkupdates works on a temporary copy
+        return u"command -v checkupdates >/dev/null || exit 1; sudo -n checkupdates -d 2>/dev/null | wc -l"_s;
+    case PackageManager::Zypper:
+        return u"sudo -n zypper --non-interactive --quiet update --download-only >/dev/null 2>&1 || exit 1; "
+               "zypper --quiet --no-refresh list-updates 2>/dev/null | grep -c '^v ' || true"_s;
+    default:
+        return std::nullopt;
+    }
+}
+
+// Installs what prefetchScript() fetched, without refreshing the repository metadata first
+std::optional<QString> applyScript(PackageManager packageManager)
+{
+    switch (packageManager) {
+    case PackageManager::Dnf:
+        return u"sudo dnf upgrade -y --cacheonly"_s;
+    case PackageManager::Apt:
+        return u"sudo apt-get upgrade -y --no-download"_s;
+    case PackageManager::Pacman:
+        return u"sudo pacman -Syu --noconfirm"_s;
+    case PackageManager::Zypper:
+        return u"sudo zypper --non-interactive --no-refresh update"_s;
+    default:
+        return std::nullopt;
+    }
+}
+
+// Only what is already known, probing the container could start it
+PackageManager knownPackageManager(const QString &container, const QString &image)
+{
+    if (const auto metadata = ContainerMetadata::cached(container)) {
+        if (metadata->packageManager != PackageManager::Unknown) {
+            return metadata->packageManager;
+        }
+    }
+    return PackageInstallCommand::packageManagerForImage(image);
+}
+}
+
+UpdatePrefetcher::UpdatePrefetcher(QObject *parent)
+    : QObject(parent)
+{
+    m_timer.setInterval(CheckIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &UpdatePrefetcher::checkConditions);
+    m_timer.start();
+
+    QTimer::singleShot(FirstCheckDelayMs, this, &UpdatePrefetcher::checkConditions);
+}
+
+int UpdatePrefetcher::pendingUpdates(const QString &container) const
+{
+    return prefetchGroup().group(container).readEntry("PendingUpdates", -1);
+}
+
+QHash<QString, int> UpdatePrefetcher::pendingUpdates() const
+{
+    QHash<QString, int> counts;
+    const KConfigGroup group = prefetchGroup();
+    for (const QString &container : group.groupList()) {
+        counts.insert(container, group.group(container).readEntry("PendingUpdates", -1));
+    }
+    return counts;
+}
+
+std::optional<QString> UpdatePrefetcher::applyCommand(const QString &container) const
+{
+    const KConfigGroup group = prefetchGroup().group(container);
+    if (group.readEntry("PendingUpdates", -1) <= 0) {
+        return std::nullopt;
+    }
+    return applyScript(knownPackageManager(container, group.readEntry("Image", QString())));
+}
+
+void UpdatePrefetcher::markApplied(const QString &container)
+{
+    setPendingUpdates(container, 0);
+}
+
+void UpdatePrefetcher::forget(const QString &container)
+{
+    KConfigGroup group = prefetchGroup().group(container);
+    group.deleteGroup();
+    group.sync();
+
+    m_queue.removeAll(container);
+    m_images.remove(container);
+}
+
+void UpdatePrefetcher::checkConditions()
+{
+    const KConfigGroup settings = prefetchGroup();
+    if (m_busy || !m_queue.isEmpty() || !settings.readEntry("Enabled", true) || !onAcPower() || !isIdle()) {
+        return;
+    }
+
+    // Stopped containers are left alone, starting them would defeat the point of waiting for idle
+    const DistroboxCli::Command command(DistroboxCli::containerManager(),
+                                        {u"ps"_s, u"--filter"_s, u"label=manager=distrobox"_s, u"--format"_s, u"{{.Names}}|{{.Image}}"_s});
+    const int intervalHours = qMax(1, settings.readEntry("IntervalHours", DefaultIntervalHours));
+
+    QPointer<UpdatePrefetcher> self(this);
+    DistroboxCli::runCommandAsync(command, this, [self, intervalHours](bool success, const QString &output) {
+        if (!self || !success) {
+            return;
+        }
+
+        const QDateTime now = QDateTime::currentDateTimeUtc();
+        for (const QString &line : output.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+            const QString container = line.section(QLatin1Char('|'), 0, 0).trimmed();
+            const QString image = line.section(QLatin1Char('|'), 1).trimmed();
+            if (container.isEmpty() || self->m_queue.contains(container) || !prefetchScript(knownPackageManager(container, image))) {
+                continue;
+            }
+
+            const QDateTime last = prefetchGroup().group(container).readEntry("LastPrefetch", QDateTime());
+            if (last.isValid() && last.secsTo(now) < intervalHours * 60 * 60) {
+                continue;
+            }
+
+            self->m_queue.append(container);
+            self->m_images.insert(container, image);
+        }
+
+        self->prefetchNext();
+    });
+}
+
+void UpdatePrefetcher::prefetchNext()
+{
+    if (m_busy || m_queue.isEmpty()) {
+        return;
+    }
+
+    // Conditions may have changed since the queue was filled, the rest waits for the next check
+    if (!onAcPower() || !isIdle()) {
+        m_queue.clear();
+        m_images.clear();
+        return;
+    }
+
+    const QString container = m_queue.takeFirst();
+    const QString image = m_images.take(container);
+    const auto script = prefetchScript(knownPackageManager(container, image));
+    if (!script) {
+        prefetchNext();
+        return;
+    }
+
+    m_busy = true;
+    // The script sends the package manager's output to /dev/null and only prints the count
+    DistroboxCli::Command command(u"distrobox"_s, {u"enter"_s, container, u"--"_s, u"sh"_s, u"-c"_s, *script});
+    command.quiet = true;
+
+    QPointer<UpdatePrefetcher> self(this);
+    DistroboxCli::runCommandAsync(command, this, [self, container, image](bool success, const QString &output) {
+        if (!self) {
+            return;
+        }
+        self->m_busy = false;
+
+        // Failures are not retried before the next interval either, e.g. when sudo wants a password
+        KConfigGroup group = prefetchGroup().group(container);
+        group.writeEntry("LastPrefetch", QDateTime::currentDateTimeUtc());
+        group.writeEntry("Image", image);
+        group.sync();
+
+        bool ok = false;
+        const QStringList lines = output.split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+        const int count = lines.isEmpty() ? -1 : lines.constLast().trimmed().toInt(&ok);
+        if (success && ok) {
+            self->setPendingUpdates(container, count);
+        }
+
+        self->prefetchNext();
+    });
+}
+
+void UpdatePrefetcher::setPendingUpdates(const QString &container, int count)
+{
+    KConfigGroup group = prefetchGroup().group(container);
+    if (group.readEntry("PendingUpdates", -1) == count) {
+        return;
+    }
+
+    group.writeEntry("PendingUpdates", count);
+    group.sync();
+    Q_EMIT pendingUpdatesChanged(container, count);
+}
@@ -0,0 +1,65 @@
+/*
+ *    SPDX-License-Identifier: GPL-3.0-or-later
+ *    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <optional>
+
+/**
+ * @class UpdatePrefetcher
+ * @brief Downloads pending updates of running containers in the background
+ *
+ * While the machine is idle and on AC power, each running container whose package
+ * manager supports it periodically fetches its updates without installing them, and
+ * the number of pending updates is recorded in the application config. Upgrading such
+ * a container then only installs what is already in its package cache.
+ */
+class UpdatePrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UpdatePrefetcher(QObject *parent = nullptr);
+
+    /**
+     * @brief Number of updates fetched for the container, -1 when never checked
+     */
+    int pendingUpdates(const QString &container) const;
+    QHash<QString, int> pendingUpdates() const;
+
+    /**
+     * @brief Command installing the fetched updates without downloading metadata again
+     * @return Nothing when there is nothing fetched or the package manager is not supported
+     */
+    std::optional<QString> applyCommand(const QString &container) const;
+
+    /**
+     * @brief Records that the fetched updates of the container were installed
+     */
+    void markApplied(const QString &container);
+
+    /**
+     * @brief Drops everything recorded for the container, e.g. after it was removed
+     */
+    void forget(const QString &container);
+
+Q_SIGNALS:
+    void pendingUpdatesChanged(const QString &container, int count);
+
+private:
+    void checkConditions();
+    void prefetchNext();
+    void setPendingUpdates(const QString &container, int count);
+
+    QTimer m_timer;
+    QStringList m_queue; ///< Running containers due for a prefetch, handled one at a time
+    QHash<QString, QString> m_images; ///< Image of each queued container
+    bool m_busy = false;
+};
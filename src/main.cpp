@@ -4,37 +4,40 @@
     SPDX-FileCopyrightText: 2025 Thomas Duckworth <tduck@filotimoproject.org>
 */
 
+#include "appcatalog.h"
+#include "containericonprovider.h"
+#include "dbusservice.h"
+#include "distroboxcli.h"
 #include "distroboxmanager.h"
+#include "icontheme.h"
+#include "lifecyclepolicy.h"
 #include "version-kontainer.h"
 #include <KAboutData>
+#include <KDBusService>
 #include <KIconTheme>
 #include <KLocalizedContext>
 #include <KLocalizedString>
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QCoreApplication>
 #include <QIcon>
+#include <QLoggingCategory>
 #include <QQmlApplicationEngine>
+#include <QQuickWindow>
 #include <QQuickStyle>
+#include <QTextStream>
 #include <QUrl>
 #include <QtQml>
 
+#include <algorithm>
+#include <cstring>
+
 using namespace Qt::Literals::StringLiterals;
 
-int main(int argc, char *argv[])
+namespace
+{
+KAboutData applicationAboutData()
 {
-    KIconTheme::initTheme();
-
-    QApplication app(argc, argv);
-
-    if (qEnvironmentVariableIsEmpty("QT_QUICK_CONTROLS_STYLE")) {
-        QQuickStyle::setStyle(u"org.kde.desktop"_s);
-    }
-
-    KLocalizedString::setApplicationDomain("kontainer");
-    QApplication::setOrganizationName(u"DenysMb"_s);
-    QApplication::setOrganizationDomain(u"io.github.DenysMb"_s);
-    QApplication::setApplicationName(u"Kontainer"_s);
-    QApplication::setDesktopFileName(u"io.github.DenysMb.Kontainer"_s);
-
     KAboutData aboutData(
         // The program name used internally.
         u"kontainer"_s,
@@ -53,16 +56,163 @@ int main(int argc, char *argv[])
                         u"denysmb@zoho.com"_s,
                         u"https://github.com/DenysMb/Kontainer"_s);
     aboutData.setTranslator(i18nc("NAME OF TRANSLATORS", "Your names"), i18nc("EMAIL OF TRANSLATORS", "Your emails"));
+    // Otherwise setApplicationData() resets them to the KAboutData defaults, kde.org and kontainer
+    aboutData.setOrganizationDomain("DenysMb.github.io");
+    aboutData.setDesktopFileName(u"io.github.DenysMb.Kontainer"_s);
+    return aboutData;
+}
+
+// Decided before any application object exists: the headless mode must not pay for the
+// widgets, the icon theme or the QML engine
+bool isHeadless(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        for (const char *option : {"--json", "--list", "--apps", "--exported", "--prestart"}) {
+            const size_t length = std::strlen(option);
+            if (std::strncmp(argv[i], option, length) == 0 && (argv[i][length] == '\0' || argv[i][length] == '=')) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Starts the containers asked to be started at login, from the autostart entry, all at once
+int prestartContainers(QCoreApplication &app)
+{
+    const QStringList containers = LifecyclePolicy::loginContainers();
+    if (containers.isEmpty()) {
+        return 0;
+    }
+
+    int pending = containers.size();
+    int failures = 0;
+    for (const QString &container : containers) {
+        DistroboxCli::runCommandAsync(LifecyclePolicy::prewarmCommand(container), &app, [&pending, &failures, container](bool success, const QString &) {
+            if (!success) {
+                QTextStream(stderr) << i18n("Could not start %1.", container) << Qt::endl;
+                ++failures;
+            }
+            if (--pending == 0) {
+                QCoreApplication::exit(failures > 0 ? 1 : 0);
+            }
+        });
+    }
+    return app.exec();
+}
+
+// Prints containers or applications as JSON to stdout, for scripts, cron jobs and status bars.
+// Only the command-line helpers run, the DistroboxManager is never constructed.
+int runHeadless(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Same application data as the GUI, so both share the config and the caches
+    KLocalizedString::setApplicationDomain("kontainer");
+    QCoreApplication::setOrganizationName(u"DenysMb"_s);
+    KAboutData::setApplicationData(applicationAboutData());
+
+    // stdout carries the JSON, keep stderr free of the debug chatter too
+    QLoggingCategory::setFilterRules(u"*.debug=false"_s);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(i18n("Manage Distrobox containers"));
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    const QCommandLineOption jsonOption(u"json"_s, i18n("Print JSON to stdout instead of opening the window. Lists the containers unless another option is given."));
+    const QCommandLineOption listOption(u"list"_s, i18n("List the containers and their images."));
+    const QCommandLineOption appsOption(u"apps"_s, i18n("List the applications installed in <container>."), i18n("container"));
+    const QCommandLineOption exportedOption(u"exported"_s, i18n("List the applications <container> exported to the host."), i18n("container"));
+    const QCommandLineOption prestartOption(u"prestart"_s, i18n("Start the containers set to start at login, then exit."));
+    parser.addOptions({jsonOption, listOption, appsOption, exportedOption, prestartOption});
+    parser.process(app);
+
+    if (parser.isSet(prestartOption)) {
+        return prestartContainers(app);
+    }
+
+    const int selected = int(parser.isSet(listOption)) + int(parser.isSet(appsOption)) + int(parser.isSet(exportedOption));
+    if (selected > 1) {
+        QTextStream(stderr) << i18n("Only one of --list, --apps and --exported can be given.") << Qt::endl;
+        return 1;
+    }
+
+    // Non-zero when the containers cannot be listed, so cron jobs and monitoring notice
+    bool success = false;
+    const QList<DistroboxCli::Container> containers = DistroboxCli::containers(success);
+    if (!success) {
+        QTextStream(stderr) << i18n("Could not list the containers.") << Qt::endl;
+        return 1;
+    }
+
+    const QString container = parser.isSet(appsOption) ? parser.value(appsOption) : parser.value(exportedOption);
+    if (!container.isEmpty() && std::none_of(containers.cbegin(), containers.cend(), [&container](const DistroboxCli::Container &entry) {
+            return entry.name == container;
+        })) {
+        QTextStream(stderr) << i18n("There is no container named %1.", container) << Qt::endl;
+        return 1;
+    }
+
+    QString json;
+    if (parser.isSet(appsOption)) {
+        json = AppCatalog::availableAppsJson(AppCatalog::availableApps(container));
+    } else if (parser.isSet(exportedOption)) {
+        json = AppCatalog::exportedAppsJson(AppCatalog::exportedApps(container));
+    } else {
+        json = DistroboxCli::containersJson(containers);
+    }
+
+    QTextStream(stdout) << json.trimmed() << Qt::endl;
+    return 0;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    if (isHeadless(argc, argv)) {
+        return runHeadless(argc, argv);
+    }
+
+    KIconTheme::initTheme();
+
+    QApplication app(argc, argv);
+
+    if (qEnvironmentVariableIsEmpty("QT_QUICK_CONTROLS_STYLE")) {
+        QQuickStyle::setStyle(u"org.kde.desktop"_s);
+    }
+
+    KLocalizedString::setApplicationDomain("kontainer");
+    QApplication::setOrganizationName(u"DenysMb"_s);
+    QApplication::setOrganizationDomain(u"io.github.DenysMb"_s);
+    QApplication::setApplicationName(u"Kontainer"_s);
+    QApplication::setDesktopFileName(u"io.github.DenysMb.Kontainer"_s);
+
+    const KAboutData aboutData = applicationAboutData();
     KAboutData::setApplicationData(aboutData);
 
     QGuiApplication::setWindowIcon(QIcon::fromTheme(u"io.github.DenysMb.Kontainer"_s));
+    // Container icons follow the host theme when the container ships it
+    IconTheme::setPreferredTheme(QIcon::themeName());
+
+    // A second launch activates the running instance and exits here. The service is named after
+    // the reversed organization domain and the application name, which has to match the app id
+    // since that is the only name the Flatpak may own. Config and cache paths keep the
+    // lowercase component name.
+    QCoreApplication::setApplicationName(u"Kontainer"_s);
+    KDBusService service(KDBusService::Unique);
+    QCoreApplication::setApplicationName(aboutData.componentName());
 
     QQmlApplicationEngine engine;
+    engine.addImageProvider(u"containericon"_s, new ContainerIconProvider);
 
     // Create and register the DistroboxManager instance
     DistroboxManager *distroBoxManager = new DistroboxManager(&engine);
     engine.rootContext()->setContextProperty(u"distroBoxManager"_s, distroBoxManager);
 
+    auto *dbusService = new DBusService(distroBoxManager);
+    dbusService->registerOnSessionBus();
+
     engine.rootContext()->setContextObject(new KLocalizedContext(&engine));
     engine.loadFromModule("io.github.DenysMb.Kontainer", "Main");
 
@@ -70,5 +220,13 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    QObject::connect(&service, &KDBusService::activateRequested, &engine, [&engine]() {
+        if (auto *window = qobject_cast<QQuickWindow *>(engine.rootObjects().constFirst())) {
+            window->show();
+            window->raise();
+            window->requestActivate();
+        }
+    });
+
     return app.exec();
 }
@@ -21,8 +21,6 @@ Kirigami.ApplicationWindow {
     property string containerName: ""
     property bool loading: true
     property bool operationInProgress: false
-    property var exportedApps: []
-    property var allApps: []
     property var selectedApps: ({})
     property string lastOperation: ""
     // Separate search text for each tab
@@ -32,58 +30,59 @@ Kirigami.ApplicationWindow {
 
     signal dataReady // emitted when both lists are loaded
 
+    AppListModel {
+        id: exportedAppsModel
+    }
+
+    AppListModel {
+        id: allAppsModel
+    }
+
+    AppFilterModel {
+        id: exportedAppsFilter
+        appModel: exportedAppsModel
+        filterText: exportedSearchText
+    }
+
+    AppFilterModel {
+        id: allAppsFilter
+        appModel: allAppsModel
+        filterText: availableSearchText
+    }
+
     function refreshApplications() {
         loading = true;
 
-        // Let the window paint first
-        Qt.callLater(function () {
-            exportedApps = distroBoxManager.exportedApps(containerName) || [];
-            allApps = distroBoxManager.allApps(containerName) || [];
-            loading = false;
-            dataReady();
-        });
+        distroBoxManager.loadApps(containerName, exportedAppsModel, allAppsModel);
     }
 
     function refreshAppLists() {
         // Only refresh the lists without showing loading screen
-        Qt.callLater(function () {
-            exportedApps = distroBoxManager.exportedApps(containerName) || [];
-            allApps = distroBoxManager.allApps(containerName) || [];
-        });
-    }
-
-    function filterApps(apps, searchText) {
-        if (!searchText)
-            return apps;
-        return apps.filter(function (app) {
-            return app.name && app.name.toLowerCase().includes(searchText.toLowerCase()) || app.basename && app.basename.toLowerCase().includes(searchText.toLowerCase());
-        });
+        distroBoxManager.loadApps(containerName, exportedAppsModel, allAppsModel);
     }
 
-    function isAppExported(basename) {
-        if (!basename || !exportedApps || exportedApps.length === 0)
-            return false;
+    Connections {
+        target: distroBoxManager
 
-        return exportedApps.some(function (app) {
-            return app && app.basename === basename;
-        });
+        function onAppsLoaded(container) {
+            if (container === containerName && loading) {
+                loading = false;
+                dataReady();
+            }
+        }
     }
 
-    function iconSourceForApp(app) {
-        if (!app)
-            return "";
-        if (app.iconSource)
-            return app.iconSource;
-        if (app.icon && (app.icon.startsWith("file:") || app.icon.startsWith("/") || app.icon.startsWith("data:")))
-            return app.icon;
+    function iconSourceForApp(iconSource, icon) {
+        if (iconSource)
+            return iconSource;
+        if (icon && (icon.startsWith("file:") || icon.startsWith("/") || icon.startsWith("data:")))
+            return icon;
         return "";
     }
 
-    function iconNameForApp(app, fallbackIcon) {
-        if (!app)
-            return fallbackIcon;
-        if (app.icon && app.icon.length > 0 && !app.icon.startsWith("/") && app.icon.indexOf("://") === -1)
-            return app.icon;
+    function iconNameForApp(icon, fallbackIcon) {
+        if (icon && icon.length > 0 && !icon.startsWith("/") && icon.indexOf("://") === -1)
+            return icon;
         return fallbackIcon;
     }
 
@@ -140,7 +139,7 @@ Kirigami.ApplicationWindow {
 
                         Controls.ToolButton {
                             Layout.fillWidth: true
-                            text: i18n("Exported Applications (%1)", exportedApps.length)
+                            text: i18n("Exported Applications (%1)", exportedAppsModel.count)
                             checkable: true
                             checked: currentTabIndex === 0
                             onClicked: currentTabIndex = 0
@@ -148,7 +147,7 @@ Kirigami.ApplicationWindow {
 
                         Controls.ToolButton {
                             Layout.fillWidth: true
-                            text: i18n("All Applications (%1)", allApps.length)
+                            text: i18n("All Applications (%1)", allAppsModel.count)
                             checkable: true
                             checked: currentTabIndex === 1
                             onClicked: currentTabIndex = 1
@@ -176,7 +175,7 @@ Kirigami.ApplicationWindow {
                             id: exportedSearchField
                             Layout.fillWidth: true
                             Layout.preferredHeight: visible ? implicitHeight : 0
-                            visible: filterApps(exportedApps, exportedSearchText).length > 0 || exportedSearchText.length > 0
+                            visible: exportedAppsFilter.count > 0 || exportedSearchText.length > 0
                             placeholderText: i18n("Search exported applications...")
                             text: exportedSearchText
                             onTextChanged: exportedSearchText = text
@@ -189,7 +188,7 @@ Kirigami.ApplicationWindow {
                             Layout.topMargin: exportedSearchField.visible ? Kirigami.Units.largeSpacing : 0
 
                             sourceComponent: {
-                                if (filterApps(exportedApps, exportedSearchText).length === 0) {
+                                if (exportedAppsFilter.count === 0) {
                                     return exportedPlaceholderComponent;
                                 } else {
                                     return exportedListViewComponent;
@@ -210,7 +209,7 @@ Kirigami.ApplicationWindow {
                             id: availableSearchField
                             Layout.fillWidth: true
                             Layout.preferredHeight: visible ? implicitHeight : 0
-                            visible: filterApps(allApps, availableSearchText).length > 0 || availableSearchText.length > 0
+                            visible: allAppsFilter.count > 0 || availableSearchText.length > 0
                             placeholderText: i18n("Search available applications...")
                             text: availableSearchText
                             onTextChanged: availableSearchText = text
@@ -223,7 +222,7 @@ Kirigami.ApplicationWindow {
                             Layout.topMargin: availableSearchField.visible ? Kirigami.Units.largeSpacing : 0
 
                             sourceComponent: {
-                                if (filterApps(allApps, availableSearchText).length === 0) {
+                                if (allAppsFilter.count === 0) {
                                     return availablePlaceholderComponent;
                                 } else {
                                     return availableListViewComponent;
@@ -257,30 +256,36 @@ Kirigami.ApplicationWindow {
 
                     ListView {
                         id: exportedListView
-                        model: filterApps(exportedApps, exportedSearchText)
+                        model: exportedAppsFilter
                         spacing: Kirigami.Units.smallSpacing
 
                         delegate: Kirigami.AbstractCard {
+                            required property string basename
+                            required property string name
+                            required property var model
+                            required property string iconSource
+                            required property bool exported
+
                             Layout.fillWidth: true
 
                             contentItem: RowLayout {
                                 spacing: Kirigami.Units.largeSpacing
 
                                 Controls.CheckBox {
-                                    checked: selectedApps[modelData.basename] || false
-                                    onCheckedChanged: selectedApps[modelData.basename] = checked
+                                    checked: selectedApps[basename] || false
+                                    onCheckedChanged: selectedApps[basename] = checked
                                     visible: Object.keys(selectedApps).length > 0 || checked
                                 }
 
                                 Kirigami.Icon {
-                                    readonly property string resolvedIconSource: iconSourceForApp(modelData)
-                                    source: resolvedIconSource.length > 0 ? resolvedIconSource : iconNameForApp(modelData, "application-x-executable")
+                                    readonly property string resolvedIconSource: iconSourceForApp(iconSource, model.icon)
+                                    source: resolvedIconSource.length > 0 ? resolvedIconSource : iconNameForApp(model.icon, "application-x-executable")
                                     width: Kirigami.Units.iconSizes.medium
                                     height: width
                                 }
 
                                 Controls.Label {
-                                    text: modelData.name || modelData.basename || "Unknown Application"
+                                    text: name || basename || "Unknown Application"
                                     Layout.fillWidth: true
                                     elide: Text.ElideRight
                                     font.bold: true
@@ -292,8 +297,8 @@ Kirigami.ApplicationWindow {
                                     enabled: !operationInProgress
                                     onClicked: {
                                         operationInProgress = true;
-                                        lastOperation = modelData.name || modelData.basename;
-                                        var success = distroBoxManager.unexportApp(modelData.basename, containerName);
+                                        lastOperation = name || basename;
+                                        var success = distroBoxManager.unexportApp(basename, containerName);
                                         if (success) {
                                             refreshAppLists();
                                             operationInProgress = false;
@@ -317,44 +322,50 @@ Kirigami.ApplicationWindow {
 
                     ListView {
                         id: availableListView
-                        model: filterApps(allApps, availableSearchText)
+                        model: allAppsFilter
                         spacing: Kirigami.Units.smallSpacing
 
                         delegate: Kirigami.AbstractCard {
+                            required property string basename
+                            required property string name
+                            required property var model
+                            required property string iconSource
+                            required property bool exported
+
                             Layout.fillWidth: true
 
                             contentItem: RowLayout {
                                 spacing: Kirigami.Units.largeSpacing
 
                                 Controls.CheckBox {
-                                    checked: selectedApps[modelData.basename] || false
-                                    onCheckedChanged: selectedApps[modelData.basename] = checked
+                                    checked: selectedApps[basename] || false
+                                    onCheckedChanged: selectedApps[basename] = checked
                                     visible: Object.keys(selectedApps).length > 0 || checked
                                 }
 
                                 Kirigami.Icon {
-                                    readonly property string resolvedIconSource: iconSourceForApp(modelData)
-                                    source: resolvedIconSource.length > 0 ? resolvedIconSource : iconNameForApp(modelData, "package-x-generic")
+                                    readonly property string resolvedIconSource: iconSourceForApp(iconSource, model.icon)
+                                    source: resolvedIconSource.length > 0 ? resolvedIconSource : iconNameForApp(model.icon, "package-x-generic")
                                     width: Kirigami.Units.iconSizes.medium
                                     height: width
                                 }
 
                                 Controls.Label {
-                                    text: modelData.name || modelData.basename || "Unknown Application"
+                                    text: name || basename || "Unknown Application"
                                     Layout.fillWidth: true
                                     elide: Text.ElideRight
                                     font.bold: true
                                 }
 
                                 Controls.Button {
-                                    text: applicationsWindow.isAppExported(modelData.basename) ? i18n("Unexport") : i18n("Export")
-                                    icon.name: applicationsWindow.isAppExported(modelData.basename) ? "list-remove" : "list-add"
+                                    text: exported ? i18n("Unexport") : i18n("Export")
+                                    icon.name: exported ? "list-remove" : "list-add"
                                     enabled: !operationInProgress
                                     onClicked: {
-                                        var wasExported = applicationsWindow.isAppExported(modelData.basename);
+                                        var wasExported = exported;
                                         operationInProgress = true;
-                                        lastOperation = modelData.name || modelData.basename;
-                                        var success = wasExported ? distroBoxManager.unexportApp(modelData.basename, containerName) : distroBoxManager.exportApp(modelData.basename, containerName);
+                                        lastOperation = name || basename;
+                                        var success = wasExported ? distroBoxManager.unexportApp(basename, containerName) : distroBoxManager.exportApp(basename, containerName);
                                         if (success) {
                                             refreshAppLists();
                                             operationInProgress = false;
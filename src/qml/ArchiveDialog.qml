@@ -0,0 +1,209 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls as Controls
+import QtQuick.Dialogs
+
+import org.kde.kirigami as Kirigami
+
+Kirigami.Dialog {
+    id: archiveDialog
+    title: restoring ? i18n("Restore Container") : i18n("Back Up %1", containerName)
+    padding: Kirigami.Units.largeSpacing
+    standardButtons: Kirigami.Dialog.NoButton
+    closePolicy: running ? Controls.Popup.NoAutoClose : Controls.Popup.CloseOnEscape | Controls.Popup.CloseOnPressOutside
+    implicitWidth: Math.min(root.width - Kirigami.Units.largeSpacing * 4, Kirigami.Units.gridUnit * 30)
+
+    signal containerRestored(string containerName)
+
+    property bool restoring: false
+    property string containerName: ""
+    property bool running: false
+    property string stage: ""
+    property string detail: ""
+    property int percent: -1
+    property string errorMessage: ""
+
+    function reset() {
+        running = false;
+        stage = "";
+        detail = "";
+        percent = -1;
+        errorMessage = "";
+    }
+
+    function openForBackup(name) {
+        restoring = false;
+        containerName = name;
+        fileField.text = "";
+        reset();
+        open();
+    }
+
+    function openForRestore() {
+        restoring = true;
+        containerName = "";
+        fileField.text = "";
+        nameField.text = "";
+        reset();
+        open();
+    }
+
+    function start() {
+        errorMessage = "";
+        if (restoring) {
+            running = distroBoxManager.restoreContainer(fileField.text, nameField.text);
+        } else {
+            running = distroBoxManager.backupContainer(containerName, fileField.text);
+        }
+        if (!running) {
+            errorMessage = i18n("Another backup or restore is still running.");
+        }
+    }
+
+    FileDialog {
+        id: archiveFileDialog
+        fileMode: archiveDialog.restoring ? FileDialog.OpenFile : FileDialog.SaveFile
+        defaultSuffix: "tar.zst"
+        nameFilters: [i18n("Container archives (*.tar.zst)")]
+        selectedFile: archiveDialog.restoring ? "" : archiveDialog.containerName + ".tar.zst"
+        onAccepted: {
+            fileField.text = decodeURIComponent(selectedFile.toString().replace(/^file:\/\//, ""));
+            if (archiveDialog.restoring && nameField.text.length === 0) {
+                var fileName = fileField.text.substring(fileField.text.lastIndexOf("/") + 1);
+                nameField.text = fileName.replace(/\.tar\.zst$/, "");
+            }
+        }
+    }
+
+    Connections {
+        target: distroBoxManager
+        function onArchiveStageChanged(stage) {
+            archiveDialog.stage = stage;
+            archiveDialog.detail = "";
+            archiveDialog.percent = -1;
+        }
+        function onArchiveProgress(percent, detail) {
+            archiveDialog.percent = percent;
+            archiveDialog.detail = detail;
+        }
+        function onArchiveFinished(success, message) {
+            if (!archiveDialog.running) {
+                return;
+            }
+            archiveDialog.running = false;
+            if (success) {
+                if (archiveDialog.restoring) {
+                    showPassiveNotification(i18n("Container %1 restored", nameField.text));
+                    archiveDialog.containerRestored(nameField.text);
+                } else {
+                    showPassiveNotification(i18n("Backup of %1 saved", archiveDialog.containerName));
+                }
+                archiveDialog.close();
+            } else {
+                archiveDialog.stage = "";
+                archiveDialog.errorMessage = message;
+            }
+        }
+    }
+
+    customFooterActions: [
+        Kirigami.Action {
+            icon.name: archiveDialog.restoring ? "document-import" : "document-export"
+            text: archiveDialog.restoring ? i18n("Restore") : i18n("Back Up")
+            visible: !archiveDialog.running
+            enabled: fileField.text.trim().length > 0 && (!archiveDialog.restoring || nameField.text.trim().length > 0)
+            onTriggered: archiveDialog.start()
+        },
+        Kirigami.Action {
+            icon.name: "dialog-cancel"
+            text: archiveDialog.running ? i18n("Cancel") : i18n("Close")
+            onTriggered: {
+                if (archiveDialog.running) {
+                    distroBoxManager.cancelArchive();
+                } else {
+                    archiveDialog.close();
+                }
+            }
+        }
+    ]
+
+    ColumnLayout {
+        spacing: Kirigami.Units.largeSpacing
+
+        Kirigami.FormLayout {
+            Layout.fillWidth: true
+            enabled: !archiveDialog.running
+
+            RowLayout {
+                Kirigami.FormData.label: archiveDialog.restoring ? i18n("Archive:") : i18n("Save to:")
+                Layout.fillWidth: true
+
+                Controls.TextField {
+                    id: fileField
+                    Layout.fillWidth: true
+                    placeholderText: i18n("Path to a .tar.zst archive")
+                }
+
+                Controls.Button {
+                    icon.name: "document-open"
+                    text: i18n("Browse…")
+                    onClicked: archiveFileDialog.open()
+                }
+            }
+
+            Controls.TextField {
+                id: nameField
+                Kirigami.FormData.label: i18n("Container name:")
+                Layout.fillWidth: true
+                visible: archiveDialog.restoring
+            }
+        }
+
+        Controls.Label {
+            Layout.fillWidth: true
+            visible: !archiveDialog.running && !archiveDialog.restoring
+            wrapMode: Text.Wrap
+            color: Kirigami.Theme.disabledTextColor
+            text: i18n("The container is paused while its snapshot is taken, then compressed using every processor core.")
+        }
+
+        ColumnLayout {
+            Layout.fillWidth: true
+            visible: archiveDialog.running
+            spacing: Kirigami.Units.smallSpacing
+
+            Controls.Label {
+                Layout.fillWidth: true
+                elide: Text.ElideRight
+                text: archiveDialog.stage
+            }
+
+            Controls.ProgressBar {
+                Layout.fillWidth: true
+                from: 0
+                to: 100
+                indeterminate: archiveDialog.percent < 0
+                value: Math.max(archiveDialog.percent, 0)
+            }
+
+            Controls.Label {
+                Layout.fillWidth: true
+                elide: Text.ElideRight
+                color: Kirigami.Theme.disabledTextColor
+                text: archiveDialog.detail
+            }
+        }
+
+        Kirigami.InlineMessage {
+            Layout.fillWidth: true
+            visible: archiveDialog.errorMessage.length > 0
+            text: archiveDialog.errorMessage
+            type: Kirigami.MessageType.Error
+        }
+    }
+}
@@ -0,0 +1,162 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls as Controls
+
+import org.kde.kirigami as Kirigami
+
+Kirigami.Dialog {
+    id: assembleDialog
+    title: i18n("Assembling containers")
+    padding: Kirigami.Units.largeSpacing
+    standardButtons: Kirigami.Dialog.NoButton
+    implicitWidth: Math.min(root.width - Kirigami.Units.largeSpacing * 4, Kirigami.Units.gridUnit * 30)
+
+    property var sections: []
+    property var sectionStates: ({})
+    property var sectionDetails: ({})
+    property bool running: false
+    property bool succeeded: false
+    property string errorMessage: ""
+
+    readonly property int finishedCount: {
+        var count = 0;
+        for (var i = 0; i < sections.length; ++i) {
+            var state = sectionStates[sections[i]];
+            if (state === "created" || state === "failed") {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    function assemble(file, maxParallel) {
+        sections = [];
+        sectionStates = ({});
+        sectionDetails = ({});
+        errorMessage = "";
+        // Set first, a manifest that cannot be read is reported before the call returns
+        running = true;
+        if (!distroBoxManager.assembleContainer(file, maxParallel)) {
+            running = false;
+            if (errorMessage.length === 0) {
+                errorMessage = i18n("The manifest could not be read. Check that every container has an image.");
+            }
+        }
+        open();
+    }
+
+    function stateText(state, detail) {
+        switch (state) {
+        case "queued":
+            return i18n("Waiting");
+        case "pulling":
+            return i18n("Pulling %1…", detail);
+        case "creating":
+            return i18n("Creating…");
+        case "created":
+            return i18n("Created");
+        case "failed":
+            return i18n("Failed");
+        }
+        return "";
+    }
+
+    Connections {
+        target: distroBoxManager
+        function onContainerAssembleStarted(sections) {
+            assembleDialog.sections = sections;
+        }
+        function onContainerAssembleProgress(section, state, detail) {
+            var states = Object.assign({}, assembleDialog.sectionStates);
+            states[section] = state;
+            assembleDialog.sectionStates = states;
+
+            var details = Object.assign({}, assembleDialog.sectionDetails);
+            details[section] = detail;
+            assembleDialog.sectionDetails = details;
+        }
+        function onContainerAssembleFinished(success, error) {
+            assembleDialog.running = false;
+            assembleDialog.succeeded = success;
+            assembleDialog.errorMessage = error;
+        }
+    }
+
+    customFooterActions: [
+        Kirigami.Action {
+            icon.name: "dialog-close"
+            text: assembleDialog.running ? i18n("Hide") : i18n("Close")
+            onTriggered: assembleDialog.close()
+        }
+    ]
+
+    ColumnLayout {
+        spacing: Kirigami.Units.largeSpacing
+
+        Repeater {
+            model: assembleDialog.sections
+
+            delegate: RowLayout {
+                required property string modelData
+
+                readonly property string sectionState: assembleDialog.sectionStates[modelData] || ""
+                readonly property string sectionDetail: assembleDialog.sectionDetails[modelData] || ""
+
+                Layout.fillWidth: true
+                spacing: Kirigami.Units.largeSpacing
+
+                Controls.Label {
+                    Layout.fillWidth: true
+                    text: modelData
+                    elide: Text.ElideRight
+                    font.bold: true
+                }
+
+                Controls.BusyIndicator {
+                    visible: sectionState === "pulling" || sectionState === "creating"
+                    running: visible
+                    Layout.preferredHeight: Kirigami.Units.iconSizes.small
+                    Layout.preferredWidth: Kirigami.Units.iconSizes.small
+                }
+
+                Controls.Label {
+                    Layout.maximumWidth: Kirigami.Units.gridUnit * 14
+                    text: assembleDialog.stateText(sectionState, sectionDetail)
+                    elide: Text.ElideMiddle
+                    color: sectionState === "failed" ? Kirigami.Theme.negativeTextColor
+                         : sectionState === "created" ? Kirigami.Theme.positiveTextColor
+                         : Kirigami.Theme.disabledTextColor
+
+                    Controls.ToolTip.text: sectionDetail
+                    Controls.ToolTip.visible: sectionState === "failed" && sectionDetail.length > 0 && failedHover.hovered
+
+                    HoverHandler {
+                        id: failedHover
+                    }
+                }
+            }
+        }
+
+        Controls.ProgressBar {
+            Layout.fillWidth: true
+            visible: assembleDialog.running
+            from: 0
+            to: Math.max(1, assembleDialog.sections.length)
+            value: assembleDialog.finishedCount
+        }
+
+        Kirigami.InlineMessage {
+            Layout.fillWidth: true
+            visible: !assembleDialog.running && (assembleDialog.errorMessage.length > 0 || assembleDialog.sections.length > 0)
+            text: assembleDialog.errorMessage.length > 0 ? assembleDialog.errorMessage
+                : assembleDialog.succeeded ? i18n("Every container of the manifest was created.")
+                : i18n("Some containers could not be created. Hover their state for details.")
+            type: assembleDialog.errorMessage.length === 0 && assembleDialog.succeeded ? Kirigami.MessageType.Positive : Kirigami.MessageType.Error
+        }
+    }
+}
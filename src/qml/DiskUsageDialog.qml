@@ -0,0 +1,114 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls as Controls
+
+import org.kde.kirigami as Kirigami
+
+Kirigami.Dialog {
+    id: diskUsageDialog
+    title: i18n("Disk usage of %1", containerName)
+    padding: Kirigami.Units.largeSpacing
+    standardButtons: Kirigami.Dialog.Close
+    implicitWidth: Math.min(root.width - Kirigami.Units.largeSpacing * 4, Kirigami.Units.gridUnit * 28)
+
+    property string containerName: ""
+    property bool scanning: false
+    property var report: null
+
+    function openForContainer(name) {
+        containerName = name;
+        report = null;
+        scanning = distroBoxManager.scanDiskUsage(name);
+        open();
+    }
+
+    Connections {
+        target: distroBoxManager
+        function onDiskUsageReady(name, result) {
+            if (name !== diskUsageDialog.containerName) {
+                return;
+            }
+            try {
+                diskUsageDialog.report = JSON.parse(result);
+            } catch (e) {
+                diskUsageDialog.report = null;
+            }
+            diskUsageDialog.scanning = false;
+        }
+    }
+
+    ColumnLayout {
+        spacing: Kirigami.Units.largeSpacing
+
+        RowLayout {
+            Layout.alignment: Qt.AlignHCenter
+            visible: diskUsageDialog.scanning
+            spacing: Kirigami.Units.largeSpacing
+
+            Controls.BusyIndicator {
+                running: diskUsageDialog.scanning
+            }
+
+            Controls.Label {
+                text: i18n("Scanning container files…")
+            }
+        }
+
+        Kirigami.InlineMessage {
+            Layout.fillWidth: true
+            visible: !diskUsageDialog.scanning && (!diskUsageDialog.report || !diskUsageDialog.report.valid)
+            type: Kirigami.MessageType.Error
+            text: diskUsageDialog.report && diskUsageDialog.report.error ? diskUsageDialog.report.error : i18n("Failed to compute disk usage.")
+        }
+
+        Kirigami.FormLayout {
+            Layout.fillWidth: true
+            visible: !diskUsageDialog.scanning && diskUsageDialog.report !== null && diskUsageDialog.report.valid
+
+            Controls.Label {
+                Kirigami.FormData.label: i18n("Container changes:")
+                text: diskUsageDialog.report ? diskUsageDialog.report.writableSize : ""
+            }
+
+            Controls.Label {
+                Kirigami.FormData.label: i18n("Base image (shared):")
+                text: diskUsageDialog.report ? diskUsageDialog.report.imageSize : ""
+            }
+        }
+
+        Kirigami.Heading {
+            level: 4
+            text: i18n("Largest directories")
+            visible: topDirectoriesRepeater.count > 0
+        }
+
+        Repeater {
+            id: topDirectoriesRepeater
+            model: !diskUsageDialog.scanning && diskUsageDialog.report ? diskUsageDialog.report.topDirectories : []
+
+            delegate: RowLayout {
+                required property var modelData
+
+                Layout.fillWidth: true
+                spacing: Kirigami.Units.largeSpacing
+
+                Controls.Label {
+                    Layout.fillWidth: true
+                    text: modelData.path
+                    elide: Text.ElideMiddle
+                    font.family: "monospace"
+                }
+
+                Controls.Label {
+                    text: modelData.size
+                    opacity: 0.7
+                }
+            }
+        }
+    }
+}
@@ -69,7 +69,9 @@ Kirigami.Dialog {
             return;
         }
 
-        var launched = distroBoxManager.cloneContainer(selectedContainer, cloneName);
+        var launched = fastCloneCheckbox.checked
+                ? distroBoxManager.snapshotCloneContainer(selectedContainer, cloneName, pauseCheckbox.checked)
+                : distroBoxManager.cloneContainer(selectedContainer, cloneName);
         if (!launched) {
             errorMessage = i18n("Failed to launch clone command. Check your setup and try again.");
             return;
@@ -112,6 +114,20 @@ Kirigami.Dialog {
                     nameManuallyEdited = true;
                 }
             }
+
+            Controls.CheckBox {
+                id: fastCloneCheckbox
+                Kirigami.FormData.label: i18n("Options")
+                text: i18n("Keep the source container running")
+                checked: true
+            }
+
+            Controls.CheckBox {
+                id: pauseCheckbox
+                text: i18n("Pause it while the snapshot is taken")
+                enabled: fastCloneCheckbox.checked
+                checked: false
+            }
         }
 
         Kirigami.InlineMessage {
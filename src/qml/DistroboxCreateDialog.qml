@@ -20,6 +20,7 @@ Kirigami.Dialog {
 
     property bool isCreating: false
     property var errorDialog
+    property var assembleDialog
     required property var mainPage
     property bool selectingImage: false
     property var availableImages: []
@@ -28,6 +29,9 @@ Kirigami.Dialog {
     property string selectedImageDisplay: ""
     property string imageSearchQuery: ""
     property string pendingContainerName: ""
+    readonly property string packageCacheFamily: distroBoxManager.packageCacheFamily(selectedImageFull || selectedImageDisplay)
+    readonly property var limitPresets: JSON.parse(distroBoxManager.resourceLimitPresets())
+    readonly property var limitControllers: JSON.parse(distroBoxManager.resourceLimitControllers())
 
     FileDialog {
         id: iniFileDialog
@@ -35,7 +39,7 @@ Kirigami.Dialog {
         fileMode: FileDialog.OpenFile
         nameFilters: [i18n("INI files (*.ini)")]
         onAccepted: {
-            distroBoxManager.assembleContainer(selectedFile);
+            createDialog.assembleDialog.assemble(selectedFile, assembleParallelismSpinBox.value);
         }
     }
 
@@ -90,6 +94,8 @@ Kirigami.Dialog {
         argsField.text = "";
         imageSearchQuery = "";
         initCheckbox.checked = false;
+        packageCacheCheckbox.checked = false;
+        limitsPresetCombo.currentIndex = 0;
 
         if (availableImages && availableImages.length > 0) {
             selectedImageFull = availableImages[0].full;
@@ -165,7 +171,11 @@ Kirigami.Dialog {
         var imageName = selectedImageFull || selectedImageDisplay;
         var safeName = nameField.text.trim().replace(/\s+/g, "-"); // sanitize whitespace
 
-        if (safeName && imageName) {
+        var argsError = distroBoxManager.createArgumentsError(getFullArgs());
+        if (argsError.length > 0) {
+            errorDialog.text = argsError;
+            errorDialog.open();
+        } else if (safeName && imageName) {
             console.log("Creating container:", safeName, imageName, getFullArgs());
             selectingImage = false;
             isCreating = true;
@@ -185,7 +195,9 @@ Kirigami.Dialog {
             var imageName = selectedImageFull || selectedImageDisplay;
             var safeName = nameField.text.trim().replace(/\s+/g, "-");
 
-            var success = distroBoxManager.createContainer(safeName, imageName, getFullArgs());
+            var sharePackageCache = packageCacheCheckbox.checked && createDialog.packageCacheFamily.length > 0;
+            var limitsPreset = limitsPresetCombo.currentIndex >= 0 ? createDialog.limitPresets[limitsPresetCombo.currentIndex].name : "";
+            var success = distroBoxManager.createContainer(safeName, imageName, getFullArgs(), sharePackageCache, limitsPreset);
 
             if (success) {
                 createDialog.pendingContainerName = safeName;
@@ -279,12 +291,21 @@ Kirigami.Dialog {
         createDialog.selectingImage = false;
     }
 
-    Component.onCompleted: {
+    function loadAvailableImages() {
         var images = JSON.parse(distroBoxManager.listAvailableImages());
         availableImages = images;
         updateFilteredImages(imageSearchField ? imageSearchField.text : "");
     }
 
+    Connections {
+        target: distroBoxManager
+        function onTemplatesChanged() {
+            createDialog.loadAvailableImages();
+        }
+    }
+
+    Component.onCompleted: loadAvailableImages()
+
     ColumnLayout {
         spacing: Kirigami.Units.largeSpacing
 
@@ -358,13 +379,65 @@ Kirigami.Dialog {
                     checked: false
                     enabled: !createDialog.isCreating
                 }
+
+                Controls.CheckBox {
+                    id: packageCacheCheckbox
+                    text: createDialog.packageCacheFamily.length > 0
+                          ? i18n("Share the %1 download cache with other containers", createDialog.packageCacheFamily)
+                          : i18n("Share the package download cache with other containers")
+                    checked: false
+                    enabled: !createDialog.isCreating && createDialog.packageCacheFamily.length > 0
+
+                    Controls.ToolTip.visible: hovered
+                    Controls.ToolTip.delay: Kirigami.Units.toolTipDelay
+                    Controls.ToolTip.text: createDialog.packageCacheFamily.length > 0
+                                           ? i18n("Packages downloaded by one container are reused by the others instead of being downloaded again.")
+                                           : i18n("The package manager of this image is not known or has no shareable cache.")
+                }
+
+                Controls.ComboBox {
+                    id: limitsPresetCombo
+                    Kirigami.FormData.label: i18n("Resource Limits")
+                    Layout.fillWidth: true
+                    model: createDialog.limitPresets
+                    textRole: "label"
+                    enabled: !createDialog.isCreating
+
+                    Controls.ToolTip.visible: hovered && currentIndex > 0
+                    Controls.ToolTip.delay: Kirigami.Units.toolTipDelay
+                    Controls.ToolTip.text: currentIndex >= 0 ? createDialog.limitPresets[currentIndex].summary : ""
+                }
+            }
+
+            Kirigami.InlineMessage {
+                Layout.fillWidth: true
+                visible: limitsPresetCombo.currentIndex > 0 && createDialog.limitControllers.note.length > 0
+                type: Kirigami.MessageType.Warning
+                text: createDialog.limitControllers.note
             }
 
             Kirigami.InlineMessage {
                 Layout.fillWidth: true
                 visible: true
                 type: Kirigami.MessageType.Information
-                text: i18n("Use Assemble to pick a distrobox.ini manifest. Kontainer will run \"distrobox assemble create --file <manifest>\" to build every container listed there.")
+                text: i18n("Use Assemble to pick a distrobox.ini manifest. Kontainer creates the containers listed there side by side, pulling each image once.")
+            }
+
+            RowLayout {
+                Layout.fillWidth: true
+                spacing: Kirigami.Units.smallSpacing
+
+                Controls.Label {
+                    Layout.fillWidth: true
+                    text: i18n("Containers assembled at once:")
+                }
+
+                Controls.SpinBox {
+                    id: assembleParallelismSpinBox
+                    from: 1
+                    to: 16
+                    value: distroBoxManager.assembleParallelism()
+                }
             }
 
             Kirigami.Separator {
@@ -469,11 +542,23 @@ Kirigami.Dialog {
                     contentItem: ColumnLayout {
                         spacing: Kirigami.Units.smallSpacing / 2
 
-                        Controls.Label {
+                        RowLayout {
                             Layout.fillWidth: true
-                            text: modelData.display
-                            wrapMode: Text.Wrap
-                            font.bold: true
+                            spacing: Kirigami.Units.smallSpacing
+
+                            Controls.Label {
+                                Layout.fillWidth: true
+                                text: modelData.display
+                                wrapMode: Text.Wrap
+                                font.bold: true
+                            }
+
+                            Kirigami.Icon {
+                                visible: modelData.local
+                                source: "emblem-checked"
+                                implicitWidth: Kirigami.Units.iconSizes.small
+                                implicitHeight: Kirigami.Units.iconSizes.small
+                            }
                         }
 
                         Controls.Label {
@@ -483,6 +568,18 @@ Kirigami.Dialog {
                             color: Kirigami.Theme.disabledTextColor
                             visible: modelData.full !== modelData.display
                         }
+
+                        Controls.Label {
+                            Layout.fillWidth: true
+                            visible: modelData.local
+                            text: modelData.local
+                                  ? i18nc("@info image already pulled, size and creation date", "Downloaded, creates right away · %1 · %2",
+                                          modelData.size, Qt.formatDate(new Date(modelData.created), Qt.locale(), Locale.ShortFormat))
+                                  : ""
+                            wrapMode: Text.Wrap
+                            color: Kirigami.Theme.positiveTextColor
+                            font: Kirigami.Theme.smallFont
+                        }
                     }
                 }
             }
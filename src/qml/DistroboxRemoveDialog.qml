@@ -18,6 +18,7 @@ Kirigami.Dialog {
 
     property string containerName: ""
     required property var mainPage
+    property var reclaimDialog
     
     onAccepted: {
         if (containerName) {
@@ -32,6 +33,10 @@ Kirigami.Dialog {
                         mainPage.containersList = []
                     }
                 }
+                // The removed container's image may now be unused
+                if (reclaimDialog) {
+                    reclaimDialog.offer()
+                }
             } else {
                 errorDialog.text = i18n("Failed to remove container")
                 errorDialog.open()
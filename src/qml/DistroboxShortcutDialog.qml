@@ -24,7 +24,8 @@ Kirigami.Dialog {
     
     onAccepted: {
         if (allCheckbox.checked) {
-            distroBoxManager.generateEntry()
+            // The dialog already knows every container, no need to list them again
+            distroBoxManager.generateEntries(containersList.map(container => container.name))
         } else if (selectedContainer) {
             distroBoxManager.generateEntry(selectedContainer)
         }
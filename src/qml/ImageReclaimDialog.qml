@@ -0,0 +1,194 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls as Controls
+
+import org.kde.kirigami as Kirigami
+
+Kirigami.Dialog {
+    id: reclaimDialog
+    title: i18n("Reclaim disk space")
+    padding: Kirigami.Units.largeSpacing
+    standardButtons: Kirigami.Dialog.NoButton
+    implicitWidth: Math.min(root.width - Kirigami.Units.largeSpacing * 4, Kirigami.Units.gridUnit * 30)
+
+    property var plan: null
+    property var selectedImages: ({})
+    property bool reclaiming: false
+    property bool loading: false
+    property bool openWhenReclaimable: false
+    property string errorMessage: ""
+
+    readonly property var selectedIds: {
+        var ids = [];
+        if (!plan || !plan.images) {
+            return ids;
+        }
+        for (var i = 0; i < plan.images.length; ++i) {
+            if (selectedImages[plan.images[i].id]) {
+                ids.push(plan.images[i].id);
+            }
+        }
+        return ids;
+    }
+
+    // Nothing is selected up front, the user picks what goes
+    function loadPlan() {
+        selectedImages = {};
+        errorMessage = "";
+        loading = distroBoxManager.previewImageReclaim();
+    }
+
+    // Opens the preview unconditionally, e.g. from the menu
+    function openPreview() {
+        openWhenReclaimable = false;
+        plan = null;
+        loadPlan();
+        open();
+    }
+
+    // Opens the preview only when there is something to reclaim, after removing a container
+    function offer() {
+        if (opened) {
+            return;
+        }
+        openWhenReclaimable = true;
+        loadPlan();
+    }
+
+    Connections {
+        target: distroBoxManager
+        function onImageReclaimPreviewReady(result) {
+            reclaimDialog.loading = false;
+            try {
+                reclaimDialog.plan = JSON.parse(result);
+            } catch (e) {
+                reclaimDialog.plan = null;
+            }
+            var reclaimable = reclaimDialog.plan && reclaimDialog.plan.valid && reclaimDialog.plan.images.length > 0
+                    && reclaimDialog.plan.reclaimableBytes > 0;
+            if (reclaimDialog.openWhenReclaimable) {
+                reclaimDialog.openWhenReclaimable = false;
+                if (reclaimable) {
+                    reclaimDialog.open();
+                }
+                return;
+            }
+            reclaimDialog.errorMessage = reclaimDialog.plan && reclaimDialog.plan.valid ? "" : i18n("Could not list local images.");
+        }
+
+        function onImageReclaimFinished(success) {
+            reclaimDialog.reclaiming = false;
+            if (success) {
+                reclaimDialog.close();
+            } else {
+                reclaimDialog.loadPlan();
+                reclaimDialog.errorMessage = i18n("Some images could not be removed.");
+            }
+        }
+    }
+
+    customFooterActions: [
+        Kirigami.Action {
+            icon.name: "edit-delete"
+            text: reclaimDialog.reclaiming ? i18n("Removing…") : i18n("Remove Selected")
+            enabled: !reclaimDialog.reclaiming && !reclaimDialog.loading && reclaimDialog.selectedIds.length > 0
+            onTriggered: {
+                reclaimDialog.errorMessage = "";
+                reclaimDialog.reclaiming = distroBoxManager.reclaimImages(reclaimDialog.selectedIds);
+            }
+        },
+        Kirigami.Action {
+            icon.name: "dialog-cancel"
+            text: i18n("Close")
+            enabled: !reclaimDialog.reclaiming
+            onTriggered: reclaimDialog.close()
+        }
+    ]
+
+    ColumnLayout {
+        spacing: Kirigami.Units.largeSpacing
+
+        Controls.Label {
+            Layout.fillWidth: true
+            wrapMode: Text.Wrap
+            visible: !reclaimDialog.loading && reclaimDialog.plan !== null && reclaimDialog.plan.valid
+            text: reclaimDialog.plan && reclaimDialog.plan.images.length > 0
+                  ? i18n("These images were pulled or created for containers that no longer use them. Removing all of them frees about %1.", reclaimDialog.plan.reclaimableSize)
+                  : i18n("Every image of your containers is still in use. Nothing to reclaim.")
+        }
+
+        RowLayout {
+            Layout.alignment: Qt.AlignHCenter
+            visible: reclaimDialog.loading
+            spacing: Kirigami.Units.largeSpacing
+
+            Controls.BusyIndicator {
+                running: reclaimDialog.loading
+            }
+
+            Controls.Label {
+                text: i18n("Looking for unused images…")
+            }
+        }
+
+        Repeater {
+            model: !reclaimDialog.loading && reclaimDialog.plan && reclaimDialog.plan.images ? reclaimDialog.plan.images : []
+
+            delegate: Controls.CheckDelegate {
+                required property var modelData
+
+                Layout.fillWidth: true
+                enabled: !reclaimDialog.reclaiming
+                checked: reclaimDialog.selectedImages[modelData.id] || false
+                onToggled: {
+                    var selection = Object.assign({}, reclaimDialog.selectedImages);
+                    selection[modelData.id] = checked;
+                    reclaimDialog.selectedImages = selection;
+                }
+
+                contentItem: ColumnLayout {
+                    spacing: Kirigami.Units.smallSpacing / 2
+
+                    Controls.Label {
+                        Layout.fillWidth: true
+                        text: modelData.tags.length > 0 ? modelData.tags.join(", ") : i18n("Untagged image %1", modelData.shortId)
+                        elide: Text.ElideMiddle
+                        font.bold: true
+                    }
+
+                    Controls.Label {
+                        Layout.fillWidth: true
+                        text: i18n("Frees %1 of %2", modelData.freedSize, modelData.size)
+                        color: Kirigami.Theme.disabledTextColor
+                    }
+                }
+            }
+        }
+
+        RowLayout {
+            Layout.alignment: Qt.AlignHCenter
+            visible: reclaimDialog.reclaiming
+            spacing: Kirigami.Units.largeSpacing
+
+            Controls.BusyIndicator {
+                running: reclaimDialog.reclaiming
+            }
+
+            Controls.Label {
+                text: i18n("Removing images…")
+            }
+        }
+
+        Kirigami.InlineMessage {
+            Layout.fillWidth: true
+            visible: reclaimDialog.errorMessage.length > 0
+            text: reclaimDialog.errorMessage
+            type: Kirigami.MessageType.Error
+        }
+    }
+}
@@ -0,0 +1,72 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls as Controls
+
+import org.kde.kirigami as Kirigami
+
+Kirigami.Dialog {
+    id: policyDialog
+    title: i18n("Start and stop policy of %1", containerName)
+    padding: Kirigami.Units.largeSpacing
+    standardButtons: Kirigami.Dialog.Ok | Kirigami.Dialog.Cancel
+    implicitWidth: Math.min(root.width - Kirigami.Units.largeSpacing * 4, Kirigami.Units.gridUnit * 26)
+
+    property string containerName: ""
+
+    function openForContainer(name) {
+        containerName = name;
+
+        var policy = {};
+        try {
+            policy = JSON.parse(distroBoxManager.lifecyclePolicy(name));
+        } catch (e) {
+            policy = {};
+        }
+
+        startAtLoginCheckbox.checked = policy.startAtLogin || false;
+        startOnHoverCheckbox.checked = policy.startOnHover || false;
+        idleStopCheckbox.checked = (policy.idleStopMinutes || 0) > 0;
+        idleMinutesSpinBox.value = policy.idleStopMinutes > 0 ? policy.idleStopMinutes : 30;
+        open();
+    }
+
+    onAccepted: {
+        distroBoxManager.setLifecyclePolicy(containerName,
+                                            startAtLoginCheckbox.checked,
+                                            startOnHoverCheckbox.checked,
+                                            idleStopCheckbox.checked ? idleMinutesSpinBox.value : 0);
+    }
+
+    Kirigami.FormLayout {
+        Controls.CheckBox {
+            id: startAtLoginCheckbox
+            Kirigami.FormData.label: i18n("Start ahead of use:")
+            text: i18n("At login")
+        }
+
+        Controls.CheckBox {
+            id: startOnHoverCheckbox
+            text: i18n("When hovering the container")
+        }
+
+        Controls.CheckBox {
+            id: idleStopCheckbox
+            Kirigami.FormData.label: i18n("Stop when idle:")
+            text: i18n("No open terminals and low CPU usage")
+        }
+
+        Controls.SpinBox {
+            id: idleMinutesSpinBox
+            Kirigami.FormData.label: i18n("Idle for (minutes):")
+            enabled: idleStopCheckbox.checked
+            from: 1
+            to: 1440
+            value: 30
+        }
+    }
+}
@@ -47,6 +47,8 @@ Kirigami.ApplicationWindow {
         function onContainerCloneFinished(clonedName, success) {
             if (success) {
                 refresh();
+            } else {
+                showPassiveNotification(i18n("Failed to clone %1", clonedName));
             }
         }
     }
@@ -58,6 +60,22 @@ Kirigami.ApplicationWindow {
             }
         }
     }
+    Connections {
+        target: distroBoxManager
+        // Patch the listed container instead of listing them all again
+        function onPendingUpdatesChanged(container, count) {
+            var containers = containersPage.containersList.slice();
+            for (var i = 0; i < containers.length; ++i) {
+                if (containers[i].name === container) {
+                    containers[i] = Object.assign({}, containers[i], {
+                        pendingUpdates: count
+                    });
+                    containersPage.containersList = containers;
+                    return;
+                }
+            }
+        }
+    }
 
 
     globalDrawer: MainGlobalDrawer {
@@ -66,6 +84,12 @@ Kirigami.ApplicationWindow {
         onCreateRequested: createDialog.open()
         onShortcutRequested: shortcutDialog.open()
         onCloneRequested: cloneDialog.openWithContainer(containerName)
+        onReclaimRequested: reclaimDialog.openPreview()
+        onRegistryMirrorRequested: registryMirrorDialog.openDialog()
+        onTemplatesRequested: templateDialog.openForContainer("")
+        onRestoreRequested: archiveDialog.openForRestore()
+        onPackageSearchRequested: packageSearchDialog.openSearch()
+        onPackageInstallRequested: packageBatchInstallDialog.openDialog()
         onShowContainerIconsToggled: root.fallbackToDistroColors = fallbackToDistroColors
         onAboutRequested: {
             if (root.pageStack.layers.currentItem !== aboutPage) {
@@ -80,10 +104,12 @@ Kirigami.ApplicationWindow {
     DistroboxRemoveDialog {
         id: removeDialog
         mainPage: containersPage
+        reclaimDialog: reclaimDialog
     }
     DistroboxCreateDialog {
         id: createDialog
         errorDialog: errorDialog
+        assembleDialog: assembleProgressDialog
         mainPage: containersPage
     }
     DistroboxShortcutDialog {
@@ -97,6 +123,37 @@ Kirigami.ApplicationWindow {
     FilePickerDialog {
         id: packageFileDialog
     }
+    AssembleProgressDialog {
+        id: assembleProgressDialog
+    }
+    DiskUsageDialog {
+        id: diskUsageDialog
+    }
+    ImageReclaimDialog {
+        id: reclaimDialog
+    }
+    LifecyclePolicyDialog {
+        id: lifecyclePolicyDialog
+    }
+    PackageSearchDialog {
+        id: packageSearchDialog
+    }
+    PackageBatchInstallDialog {
+        id: packageBatchInstallDialog
+    }
+    RegistryMirrorDialog {
+        id: registryMirrorDialog
+    }
+    ResourceLimitsDialog {
+        id: resourceLimitsDialog
+    }
+    TemplateDialog {
+        id: templateDialog
+    }
+    ArchiveDialog {
+        id: archiveDialog
+        onContainerRestored: refresh()
+    }
 
     pageStack.initialPage: MainContainersPage {
         id: containersPage
@@ -131,6 +188,21 @@ Kirigami.ApplicationWindow {
         onCloneContainerRequested: function(containerName) {
             cloneDialog.openWithContainer(containerName);
         }
+        onSaveTemplateRequested: function(containerName) {
+            templateDialog.openForContainer(containerName);
+        }
+        onBackupRequested: function(containerName) {
+            archiveDialog.openForBackup(containerName);
+        }
+        onDiskUsageRequested: function(containerName) {
+            diskUsageDialog.openForContainer(containerName);
+        }
+        onLifecyclePolicyRequested: function(containerName) {
+            lifecyclePolicyDialog.openForContainer(containerName);
+        }
+        onResourceLimitsRequested: function(containerName) {
+            resourceLimitsDialog.openForContainer(containerName);
+        }
         onRemoveContainerRequested: function(containerName) {
             removeDialog.containerName = containerName;
             removeDialog.open();
@@ -0,0 +1,196 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls as Controls
+
+import org.kde.kirigami as Kirigami
+
+Kirigami.Dialog {
+    id: batchInstallDialog
+    title: i18n("Install packages")
+    padding: Kirigami.Units.largeSpacing
+    standardButtons: Kirigami.Dialog.NoButton
+    implicitWidth: Math.min(root.width - Kirigami.Units.largeSpacing * 4, Kirigami.Units.gridUnit * 30)
+
+    property var containers: []
+    property var selectedContainers: ({})
+    property var containerStates: ({})
+    property var containerOutputs: ({})
+    property bool installing: false
+    property int completed: 0
+    property int total: 0
+    property string resultMessage: ""
+    property bool resultSuccess: true
+
+    readonly property var selectedNames: {
+        var names = [];
+        for (var i = 0; i < containers.length; ++i) {
+            if (selectedContainers[containers[i].name]) {
+                names.push(containers[i].name);
+            }
+        }
+        return names;
+    }
+
+    function openDialog() {
+        if (!installing) {
+            try {
+                containers = JSON.parse(distroBoxManager.listContainers());
+            } catch (e) {
+                containers = [];
+            }
+            selectedContainers = ({});
+            containerStates = ({});
+            containerOutputs = ({});
+            resultMessage = "";
+        }
+        open();
+        packagesField.forceActiveFocus();
+    }
+
+    function stateText(state) {
+        switch (state) {
+        case "queued":
+            return i18n("Waiting");
+        case "installing":
+            return i18n("Installing…");
+        case "installed":
+            return i18n("Installed");
+        case "failed":
+            return i18n("Failed");
+        case "unsupported":
+            return i18n("Unsupported distribution");
+        }
+        return "";
+    }
+
+    Connections {
+        target: distroBoxManager
+        function onPackageInstallProgress(container, state, completed, total) {
+            var states = Object.assign({}, batchInstallDialog.containerStates);
+            states[container] = state;
+            batchInstallDialog.containerStates = states;
+            batchInstallDialog.completed = completed;
+            batchInstallDialog.total = total;
+        }
+        function onPackageInstallFinished(success, results) {
+            batchInstallDialog.installing = false;
+            batchInstallDialog.resultSuccess = success;
+
+            var outputs = {};
+            try {
+                var entries = JSON.parse(results);
+                for (var i = 0; i < entries.length; ++i) {
+                    outputs[entries[i].container] = entries[i].output;
+                }
+            } catch (e) {
+            }
+            batchInstallDialog.containerOutputs = outputs;
+            batchInstallDialog.resultMessage = success ? i18n("The packages were installed in every selected container.")
+                                                       : i18n("The packages could not be installed in some containers.");
+        }
+    }
+
+    customFooterActions: [
+        Kirigami.Action {
+            icon.name: "install"
+            text: batchInstallDialog.installing ? i18n("Installing…") : i18n("Install")
+            enabled: !batchInstallDialog.installing && batchInstallDialog.selectedNames.length > 0 && packagesField.text.trim().length > 0
+            onTriggered: {
+                var states = {};
+                for (var i = 0; i < batchInstallDialog.selectedNames.length; ++i) {
+                    states[batchInstallDialog.selectedNames[i]] = "queued";
+                }
+                batchInstallDialog.containerStates = states;
+                batchInstallDialog.containerOutputs = ({});
+                batchInstallDialog.resultMessage = "";
+                batchInstallDialog.completed = 0;
+                batchInstallDialog.total = batchInstallDialog.selectedNames.length;
+                batchInstallDialog.installing = distroBoxManager.installPackages(batchInstallDialog.selectedNames, packagesField.text);
+            }
+        },
+        Kirigami.Action {
+            icon.name: "dialog-cancel"
+            text: i18n("Close")
+            onTriggered: batchInstallDialog.close()
+        }
+    ]
+
+    ColumnLayout {
+        spacing: Kirigami.Units.largeSpacing
+
+        Controls.TextField {
+            id: packagesField
+            Layout.fillWidth: true
+            enabled: !batchInstallDialog.installing
+            placeholderText: i18n("Package names, e.g. gcc make git")
+        }
+
+        Repeater {
+            model: batchInstallDialog.containers
+
+            delegate: Controls.CheckDelegate {
+                required property var modelData
+
+                readonly property string installState: batchInstallDialog.containerStates[modelData.name] || ""
+                readonly property string output: batchInstallDialog.containerOutputs[modelData.name] || ""
+
+                Layout.fillWidth: true
+                enabled: !batchInstallDialog.installing
+                checked: batchInstallDialog.selectedContainers[modelData.name] || false
+                onToggled: {
+                    var selection = Object.assign({}, batchInstallDialog.selectedContainers);
+                    selection[modelData.name] = checked;
+                    batchInstallDialog.selectedContainers = selection;
+                }
+
+                Controls.ToolTip.text: output
+                Controls.ToolTip.visible: hovered && output.length > 0
+
+                contentItem: RowLayout {
+                    spacing: Kirigami.Units.largeSpacing
+
+                    Controls.Label {
+                        Layout.fillWidth: true
+                        text: modelData.name
+                        elide: Text.ElideRight
+                        font.bold: true
+                    }
+
+                    Controls.BusyIndicator {
+                        visible: installState === "installing"
+                        running: visible
+                        Layout.preferredHeight: Kirigami.Units.iconSizes.small
+                        Layout.preferredWidth: Kirigami.Units.iconSizes.small
+                    }
+
+                    Controls.Label {
+                        text: batchInstallDialog.stateText(installState)
+                        color: installState === "failed" || installState === "unsupported" ? Kirigami.Theme.negativeTextColor
+                             : installState === "installed" ? Kirigami.Theme.positiveTextColor
+                             : Kirigami.Theme.disabledTextColor
+                    }
+                }
+            }
+        }
+
+        Controls.ProgressBar {
+            Layout.fillWidth: true
+            visible: batchInstallDialog.installing
+            from: 0
+            to: Math.max(1, batchInstallDialog.total)
+            value: batchInstallDialog.completed
+        }
+
+        Kirigami.InlineMessage {
+            Layout.fillWidth: true
+            visible: batchInstallDialog.resultMessage.length > 0
+            text: batchInstallDialog.resultMessage
+            type: batchInstallDialog.resultSuccess ? Kirigami.MessageType.Positive : Kirigami.MessageType.Error
+        }
+    }
+}
@@ -0,0 +1,110 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls as Controls
+
+import org.kde.kirigami as Kirigami
+
+Kirigami.Dialog {
+    id: packageSearchDialog
+    title: i18n("Find installed package")
+    padding: Kirigami.Units.largeSpacing
+    standardButtons: Kirigami.Dialog.Close
+    implicitWidth: Math.min(root.width - Kirigami.Units.largeSpacing * 4, Kirigami.Units.gridUnit * 30)
+
+    property bool refreshing: false
+    property var results: []
+
+    function openSearch() {
+        // Searches the cached index right away, changed databases are merged in when the refresh ends
+        refreshing = distroBoxManager.refreshPackageInventory();
+        updateResults();
+        open();
+        searchField.forceActiveFocus();
+    }
+
+    function updateResults() {
+        results = distroBoxManager.searchPackages(searchField.text, 200);
+    }
+
+    Connections {
+        target: distroBoxManager
+        function onPackageInventoryRefreshed() {
+            packageSearchDialog.refreshing = false;
+            packageSearchDialog.updateResults();
+        }
+    }
+
+    ColumnLayout {
+        spacing: Kirigami.Units.smallSpacing
+
+        Kirigami.SearchField {
+            id: searchField
+            Layout.fillWidth: true
+            placeholderText: i18n("Package name…")
+            onTextChanged: packageSearchDialog.updateResults()
+        }
+
+        RowLayout {
+            visible: packageSearchDialog.refreshing
+            spacing: Kirigami.Units.smallSpacing
+
+            Controls.BusyIndicator {
+                running: packageSearchDialog.refreshing
+                Layout.preferredHeight: Kirigami.Units.iconSizes.small
+                Layout.preferredWidth: Kirigami.Units.iconSizes.small
+            }
+
+            Controls.Label {
+                text: i18n("Updating package lists…")
+                opacity: 0.7
+            }
+        }
+
+        ListView {
+            id: resultsView
+            Layout.fillWidth: true
+            Layout.preferredHeight: Kirigami.Units.gridUnit * 14
+            clip: true
+            model: packageSearchDialog.results
+
+            delegate: Controls.ItemDelegate {
+                required property var modelData
+
+                width: ListView.view.width
+
+                contentItem: RowLayout {
+                    spacing: Kirigami.Units.largeSpacing
+
+                    Controls.Label {
+                        Layout.fillWidth: true
+                        text: modelData.name
+                        elide: Text.ElideRight
+                        font.bold: true
+                    }
+
+                    Controls.Label {
+                        text: modelData.version
+                        elide: Text.ElideRight
+                        opacity: 0.7
+                    }
+
+                    Controls.Label {
+                        text: modelData.container
+                    }
+                }
+            }
+
+            Kirigami.PlaceholderMessage {
+                anchors.centerIn: parent
+                width: parent.width - Kirigami.Units.largeSpacing * 4
+                visible: resultsView.count === 0 && searchField.text.length > 0
+                text: i18n("No container has a package matching '%1'", searchField.text)
+            }
+        }
+    }
+}
@@ -0,0 +1,271 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls as Controls
+
+import org.kde.kirigami as Kirigami
+
+Kirigami.Dialog {
+    id: mirrorDialog
+    title: i18n("Registry mirror")
+    padding: Kirigami.Units.largeSpacing
+    standardButtons: Kirigami.Dialog.NoButton
+    implicitWidth: Math.min(root.width - Kirigami.Units.largeSpacing * 4, Kirigami.Units.gridUnit * 30)
+
+    property var status: null
+    property bool busy: false
+    property string errorMessage: ""
+
+    function loadStatus() {
+        try {
+            status = JSON.parse(distroBoxManager.registryMirrorStatus());
+        } catch (e) {
+            status = null;
+        }
+    }
+
+    function openDialog() {
+        errorMessage = "";
+        loadStatus();
+        if (status) {
+            localRadio.checked = status.mode === "local";
+            siteRadio.checked = status.mode === "site";
+            offRadio.checked = !localRadio.checked && !siteRadio.checked;
+            siteMirrorField.text = status.siteMirror;
+            mirroredRegistryField.text = status.mirroredRegistry;
+            insecureCheckbox.checked = status.insecure;
+        }
+        open();
+    }
+
+    function apply() {
+        errorMessage = "";
+        var mode = localRadio.checked ? "local" : (siteRadio.checked ? "site" : "off");
+        // Set first, the result may be reported before the call returns
+        busy = true;
+        if (!distroBoxManager.setRegistryMirror(mode, siteMirrorField.text, mirroredRegistryField.text, insecureCheckbox.checked)) {
+            busy = false;
+            errorMessage = i18n("Enter the address of the site mirror.");
+        }
+    }
+
+    Controls.ButtonGroup {
+        id: modeGroup
+    }
+
+    Connections {
+        target: distroBoxManager
+        function onRegistryMirrorFinished(success, message) {
+            mirrorDialog.busy = false;
+            mirrorDialog.errorMessage = message;
+            mirrorDialog.loadStatus();
+        }
+    }
+
+    customFooterActions: [
+        Kirigami.Action {
+            icon.name: "dialog-ok-apply"
+            text: i18n("Apply")
+            enabled: !mirrorDialog.busy
+            onTriggered: mirrorDialog.apply()
+        },
+        Kirigami.Action {
+            icon.name: "dialog-close"
+            text: i18n("Close")
+            onTriggered: mirrorDialog.close()
+        }
+    ]
+
+    ColumnLayout {
+        spacing: Kirigami.Units.largeSpacing
+
+        Kirigami.FormLayout {
+            Layout.fillWidth: true
+            enabled: !mirrorDialog.busy
+
+            Controls.RadioButton {
+                id: offRadio
+                Controls.ButtonGroup.group: modeGroup
+                Kirigami.FormData.label: i18n("Pull images:")
+                text: i18n("Directly from their registries")
+            }
+
+            Controls.RadioButton {
+                id: localRadio
+                Controls.ButtonGroup.group: modeGroup
+                text: i18n("Through a local caching registry")
+            }
+
+            Controls.Label {
+                Layout.fillWidth: true
+                visible: localRadio.checked
+                wrapMode: Text.Wrap
+                color: Kirigami.Theme.disabledTextColor
+                text: mirrorDialog.status && mirrorDialog.status.localMirrorRunning
+                      ? i18n("Docker Hub images are cached by the registry running at %1.", mirrorDialog.status.localMirror)
+                      : i18n("A registry container caching Docker Hub images is started at %1.", mirrorDialog.status ? mirrorDialog.status.localMirror : "")
+            }
+
+            Controls.RadioButton {
+                id: siteRadio
+                Controls.ButtonGroup.group: modeGroup
+                text: i18n("Through a site mirror")
+            }
+
+            Controls.TextField {
+                id: siteMirrorField
+                Kirigami.FormData.label: i18n("Mirror address:")
+                Layout.fillWidth: true
+                visible: siteRadio.checked
+                placeholderText: i18n("registry.example.lan:5000")
+            }
+
+            Controls.TextField {
+                id: mirroredRegistryField
+                Kirigami.FormData.label: i18n("Mirrors registry:")
+                Layout.fillWidth: true
+                visible: siteRadio.checked
+                placeholderText: "docker.io"
+            }
+
+            Controls.CheckBox {
+                id: insecureCheckbox
+                visible: siteRadio.checked
+                text: i18n("Skip TLS verification")
+            }
+        }
+
+        Kirigami.Separator {
+            Layout.fillWidth: true
+        }
+
+        Controls.Label {
+            Layout.fillWidth: true
+            wrapMode: Text.Wrap
+            text: !mirrorDialog.status || mirrorDialog.status.pulls === 0
+                  ? i18n("No image pulls logged yet.")
+                  : mirrorDialog.status.networkPulls === 0
+                  ? i18n("Every recent image was already local, none had to be downloaded.")
+                  : i18np("%2% of the last downloaded image served by the mirror.",
+                          "%2% of the last %1 downloaded images served by the mirror.",
+                          mirrorDialog.status.networkPulls, mirrorDialog.status.hitRate)
+        }
+
+        Controls.Label {
+            Layout.fillWidth: true
+            visible: mirrorDialog.status !== null && mirrorDialog.status.pulls > 0
+            wrapMode: Text.Wrap
+            color: Kirigami.Theme.disabledTextColor
+            text: mirrorDialog.status
+                  ? i18n("Already local: %1, from the mirror's cache: %2, fetched by the mirror: %3, from upstream: %4, failed: %5",
+                         mirrorDialog.status.localHits, mirrorDialog.status.mirrorHits, mirrorDialog.status.mirrorMisses,
+                         mirrorDialog.status.upstreamPulls, mirrorDialog.status.failures)
+                  : ""
+        }
+
+        Kirigami.Separator {
+            Layout.fillWidth: true
+        }
+
+        Kirigami.Heading {
+            level: 4
+            text: i18n("Pinned images")
+        }
+
+        Controls.Label {
+            Layout.fillWidth: true
+            wrapMode: Text.Wrap
+            color: Kirigami.Theme.disabledTextColor
+            text: i18n("Pinned images are kept local so containers are created from them right away, and are never offered for reclaiming.")
+        }
+
+        Repeater {
+            model: mirrorDialog.status ? mirrorDialog.status.pinned : []
+
+            delegate: RowLayout {
+                required property var modelData
+
+                Layout.fillWidth: true
+
+                Kirigami.Icon {
+                    source: modelData.present ? "emblem-checked" : "emblem-important"
+                    implicitWidth: Kirigami.Units.iconSizes.small
+                    implicitHeight: Kirigami.Units.iconSizes.small
+                }
+
+                Controls.Label {
+                    Layout.fillWidth: true
+                    text: modelData.present ? modelData.image : i18n("%1 (not pulled yet)", modelData.image)
+                    elide: Text.ElideMiddle
+                }
+
+                Controls.ToolButton {
+                    icon.name: "list-remove"
+                    enabled: !mirrorDialog.busy
+                    onClicked: {
+                        distroBoxManager.unpinImage(modelData.image);
+                        mirrorDialog.loadStatus();
+                    }
+                    Controls.ToolTip.text: i18n("Unpin")
+                    Controls.ToolTip.visible: hovered
+                }
+            }
+        }
+
+        RowLayout {
+            Layout.fillWidth: true
+            enabled: !mirrorDialog.busy
+
+            Controls.TextField {
+                id: pinField
+                Layout.fillWidth: true
+                placeholderText: i18n("Image to pin, e.g. fedora:latest")
+                onAccepted: pinButton.clicked()
+            }
+
+            Controls.Button {
+                id: pinButton
+                icon.name: "window-pin"
+                text: i18n("Pin")
+                enabled: pinField.text.trim().length > 0
+                onClicked: {
+                    mirrorDialog.busy = distroBoxManager.pinImage(pinField.text);
+                    pinField.text = "";
+                    mirrorDialog.loadStatus();
+                }
+            }
+
+            Controls.Button {
+                icon.name: "download"
+                text: i18n("Pull Missing")
+                enabled: mirrorDialog.status !== null && mirrorDialog.status.pinned.length > 0
+                onClicked: mirrorDialog.busy = distroBoxManager.refreshPinnedImages()
+            }
+        }
+
+        RowLayout {
+            Layout.alignment: Qt.AlignHCenter
+            visible: mirrorDialog.busy
+            spacing: Kirigami.Units.largeSpacing
+
+            Controls.BusyIndicator {
+                running: mirrorDialog.busy
+            }
+
+            Controls.Label {
+                text: i18n("Working…")
+            }
+        }
+
+        Kirigami.InlineMessage {
+            Layout.fillWidth: true
+            visible: mirrorDialog.errorMessage.length > 0
+            text: mirrorDialog.errorMessage
+            type: Kirigami.MessageType.Error
+        }
+    }
+}
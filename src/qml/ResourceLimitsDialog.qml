@@ -0,0 +1,189 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls as Controls
+
+import org.kde.kirigami as Kirigami
+
+Kirigami.Dialog {
+    id: limitsDialog
+    title: i18n("Resource limits of %1", containerName)
+    padding: Kirigami.Units.largeSpacing
+    standardButtons: Kirigami.Dialog.NoButton
+    implicitWidth: Math.min(root.width - Kirigami.Units.largeSpacing * 4, Kirigami.Units.gridUnit * 26)
+
+    property string containerName: ""
+    property var presets: []
+    property var controllers: ({ cpu: true, memory: true, io: true, note: "" })
+    property bool applying: false
+    property string errorMessage: ""
+
+    function showLimits(limits) {
+        cpusSpinBox.value = Math.round((limits.cpus || 0) * 10);
+        cpuSharesSpinBox.value = limits.cpuShares || 0;
+        memorySpinBox.value = limits.memoryMiB || 0;
+        ioWeightSpinBox.value = limits.ioWeight || 0;
+    }
+
+    function openForContainer(name) {
+        containerName = name;
+        applying = false;
+        errorMessage = "";
+        try {
+            presets = JSON.parse(distroBoxManager.resourceLimitPresets());
+        } catch (e) {
+            presets = [];
+        }
+        presetCombo.currentIndex = -1;
+        try {
+            controllers = JSON.parse(distroBoxManager.resourceLimitControllers());
+        } catch (e) {
+            controllers = { cpu: true, memory: true, io: true, note: "" };
+        }
+
+        var current = distroBoxManager.resourceLimits(name);
+        if (current.length > 0) {
+            showLimits(JSON.parse(current));
+        } else {
+            showLimits({});
+            errorMessage = i18n("Could not read the current limits of %1.", name);
+        }
+        open();
+    }
+
+    Connections {
+        target: distroBoxManager
+        function onResourceLimitsUpdated(name, success) {
+            if (name !== limitsDialog.containerName || !limitsDialog.applying) {
+                return;
+            }
+            limitsDialog.applying = false;
+            if (success) {
+                showPassiveNotification(i18n("Resource limits of %1 updated", name));
+                limitsDialog.close();
+            } else {
+                limitsDialog.errorMessage = i18n("The container manager refused the limits.");
+            }
+        }
+    }
+
+    customFooterActions: [
+        Kirigami.Action {
+            icon.name: "dialog-ok-apply"
+            text: limitsDialog.applying ? i18n("Applying…") : i18n("Apply")
+            enabled: !limitsDialog.applying
+            onTriggered: {
+                limitsDialog.errorMessage = "";
+                limitsDialog.applying = distroBoxManager.updateResourceLimits(limitsDialog.containerName,
+                                                                              cpusSpinBox.value / 10,
+                                                                              cpuSharesSpinBox.value,
+                                                                              memorySpinBox.value,
+                                                                              ioWeightSpinBox.value);
+            }
+        },
+        Kirigami.Action {
+            icon.name: "dialog-cancel"
+            text: i18n("Close")
+            onTriggered: limitsDialog.close()
+        }
+    ]
+
+    ColumnLayout {
+        spacing: Kirigami.Units.largeSpacing
+
+        Kirigami.FormLayout {
+            Layout.fillWidth: true
+            enabled: !limitsDialog.applying
+
+            Controls.ComboBox {
+                id: presetCombo
+                Kirigami.FormData.label: i18n("Preset:")
+                Layout.fillWidth: true
+                model: limitsDialog.presets
+                textRole: "label"
+                displayText: currentIndex >= 0 ? currentText : i18n("Custom")
+                onActivated: function (index) {
+                    limitsDialog.showLimits(limitsDialog.presets[index]);
+                }
+            }
+
+            Controls.SpinBox {
+                id: cpusSpinBox
+                Kirigami.FormData.label: i18n("CPU cores:")
+                enabled: limitsDialog.controllers.cpu
+                from: 0
+                to: 1024
+                stepSize: 5
+                editable: true
+                textFromValue: function (value, locale) {
+                    return value === 0 ? i18n("Unlimited") : Number(value / 10).toLocaleString(locale, 'f', 1);
+                }
+                valueFromText: function (text, locale) {
+                    return Math.round(Number.fromLocaleString(locale, text) * 10);
+                }
+                onValueModified: presetCombo.currentIndex = -1
+            }
+
+            Controls.SpinBox {
+                id: memorySpinBox
+                Kirigami.FormData.label: i18n("Memory (MiB):")
+                enabled: limitsDialog.controllers.memory
+                from: 0
+                to: 4194304
+                stepSize: 256
+                editable: true
+                textFromValue: function (value, locale) {
+                    return value === 0 ? i18n("Unlimited") : Number(value).toLocaleString(locale, 'f', 0);
+                }
+                onValueModified: presetCombo.currentIndex = -1
+            }
+
+            Controls.SpinBox {
+                id: cpuSharesSpinBox
+                Kirigami.FormData.label: i18n("CPU weight:")
+                enabled: limitsDialog.controllers.cpu
+                from: 0
+                to: 262144
+                stepSize: 128
+                editable: true
+                onValueModified: presetCombo.currentIndex = -1
+            }
+
+            Controls.SpinBox {
+                id: ioWeightSpinBox
+                Kirigami.FormData.label: i18n("IO weight:")
+                enabled: limitsDialog.controllers.io
+                from: 0
+                to: 1000
+                stepSize: 50
+                editable: true
+                onValueModified: presetCombo.currentIndex = -1
+            }
+        }
+
+        Controls.Label {
+            Layout.fillWidth: true
+            wrapMode: Text.Wrap
+            color: Kirigami.Theme.disabledTextColor
+            text: i18n("Changes apply immediately, also while the container runs. The weights are relative to other processes, 1024 CPU weight is the default.")
+        }
+
+        Kirigami.InlineMessage {
+            Layout.fillWidth: true
+            visible: limitsDialog.controllers.note.length > 0
+            text: limitsDialog.controllers.note
+            type: Kirigami.MessageType.Warning
+        }
+
+        Kirigami.InlineMessage {
+            Layout.fillWidth: true
+            visible: limitsDialog.errorMessage.length > 0
+            text: limitsDialog.errorMessage
+            type: Kirigami.MessageType.Error
+        }
+    }
+}
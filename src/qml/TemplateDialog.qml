@@ -0,0 +1,218 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls as Controls
+
+import org.kde.kirigami as Kirigami
+
+Kirigami.Dialog {
+    id: templateDialog
+    title: containerName.length > 0 ? i18n("Save %1 as template", containerName) : i18n("Templates")
+    padding: Kirigami.Units.largeSpacing
+    standardButtons: Kirigami.Dialog.NoButton
+    implicitWidth: Math.min(root.width - Kirigami.Units.largeSpacing * 4, Kirigami.Units.gridUnit * 30)
+
+    // Empty when only managing the existing templates
+    property string containerName: ""
+    property var templates: []
+    property var selectedTemplates: ({})
+    property bool saving: false
+    property bool loading: false
+    property string errorMessage: ""
+
+    readonly property var selectedNames: {
+        var names = [];
+        for (var i = 0; i < templates.length; ++i) {
+            if (selectedTemplates[templates[i].name]) {
+                names.push(templates[i].name);
+            }
+        }
+        return names;
+    }
+
+    function loadTemplates() {
+        selectedTemplates = {};
+        loading = distroBoxManager.listTemplates();
+    }
+
+    function openForContainer(name) {
+        containerName = name;
+        nameField.text = name ? name.toLowerCase() + "-template" : "";
+        squashCheckbox.checked = false;
+        errorMessage = "";
+        loadTemplates();
+        open();
+    }
+
+    Connections {
+        target: distroBoxManager
+        function onTemplatesListed(templates) {
+            templateDialog.loading = false;
+            try {
+                templateDialog.templates = JSON.parse(templates);
+            } catch (e) {
+                templateDialog.templates = [];
+            }
+            templateDialog.selectedTemplates = {};
+        }
+        function onTemplateSaveFinished(name, success) {
+            templateDialog.saving = false;
+            if (success) {
+                templateDialog.loadTemplates();
+                showPassiveNotification(i18n("Template %1 saved", name));
+            } else {
+                templateDialog.errorMessage = i18n("Could not save the template.");
+            }
+        }
+    }
+
+    customFooterActions: [
+        Kirigami.Action {
+            icon.name: "document-save"
+            text: templateDialog.saving ? i18n("Saving…") : i18n("Save Template")
+            visible: templateDialog.containerName.length > 0
+            enabled: !templateDialog.saving && nameField.text.trim().length > 0
+            onTriggered: {
+                templateDialog.errorMessage = "";
+                templateDialog.saving = distroBoxManager.saveAsTemplate(templateDialog.containerName, nameField.text, squashCheckbox.checked);
+                if (!templateDialog.saving) {
+                    templateDialog.errorMessage = i18n("Could not save the template.");
+                }
+            }
+        },
+        Kirigami.Action {
+            icon.name: "edit-delete"
+            text: i18n("Remove Selected")
+            enabled: !templateDialog.saving && templateDialog.selectedNames.length > 0
+            onTriggered: {
+                if (!distroBoxManager.removeTemplates(templateDialog.selectedNames)) {
+                    templateDialog.errorMessage = i18n("Some templates are still used by a container and were kept.");
+                }
+                templateDialog.loadTemplates();
+            }
+        },
+        Kirigami.Action {
+            icon.name: "dialog-cancel"
+            text: i18n("Close")
+            onTriggered: templateDialog.close()
+        }
+    ]
+
+    ColumnLayout {
+        spacing: Kirigami.Units.largeSpacing
+
+        Kirigami.FormLayout {
+            Layout.fillWidth: true
+            visible: templateDialog.containerName.length > 0
+            enabled: !templateDialog.saving
+
+            Controls.TextField {
+                id: nameField
+                Kirigami.FormData.label: i18n("Template name:")
+                Layout.fillWidth: true
+            }
+
+            Controls.CheckBox {
+                id: squashCheckbox
+                text: i18n("Squash into a single layer")
+            }
+        }
+
+        Controls.Label {
+            Layout.fillWidth: true
+            visible: templateDialog.containerName.length > 0
+            wrapMode: Text.Wrap
+            color: Kirigami.Theme.disabledTextColor
+            text: i18n("The container is paused while it is saved. New containers can then be created from the template in seconds.")
+        }
+
+        RowLayout {
+            Layout.alignment: Qt.AlignHCenter
+            visible: templateDialog.saving
+            spacing: Kirigami.Units.largeSpacing
+
+            Controls.BusyIndicator {
+                running: templateDialog.saving
+            }
+
+            Controls.Label {
+                text: i18n("Saving template…")
+            }
+        }
+
+        RowLayout {
+            Layout.alignment: Qt.AlignHCenter
+            visible: templateDialog.loading && templateDialog.templates.length === 0
+            spacing: Kirigami.Units.largeSpacing
+
+            Controls.BusyIndicator {
+                running: parent.visible
+            }
+
+            Controls.Label {
+                text: i18n("Loading templates…")
+            }
+        }
+
+        Kirigami.Heading {
+            level: 4
+            visible: templateDialog.templates.length > 0
+            text: i18n("Saved templates")
+        }
+
+        Repeater {
+            model: templateDialog.templates
+
+            delegate: Controls.CheckDelegate {
+                required property var modelData
+
+                Layout.fillWidth: true
+                enabled: !templateDialog.saving
+                checked: templateDialog.selectedTemplates[modelData.name] || false
+                onToggled: {
+                    var selection = Object.assign({}, templateDialog.selectedTemplates);
+                    selection[modelData.name] = checked;
+                    templateDialog.selectedTemplates = selection;
+                }
+
+                contentItem: ColumnLayout {
+                    spacing: Kirigami.Units.smallSpacing / 2
+
+                    Controls.Label {
+                        Layout.fillWidth: true
+                        text: modelData.name
+                        elide: Text.ElideRight
+                        font.bold: true
+                    }
+
+                    Controls.Label {
+                        Layout.fillWidth: true
+                        elide: Text.ElideRight
+                        color: Kirigami.Theme.disabledTextColor
+                        text: modelData.sourceContainer.length > 0
+                              ? i18n("From %1 on %2, %3", modelData.sourceContainer, modelData.createdText, modelData.size || i18n("unknown size"))
+                              : i18n("Saved on %1, %2", modelData.createdText, modelData.size || i18n("unknown size"))
+                    }
+                }
+            }
+        }
+
+        Controls.Label {
+            Layout.fillWidth: true
+            visible: !templateDialog.loading && templateDialog.templates.length === 0 && templateDialog.containerName.length === 0
+            wrapMode: Text.Wrap
+            text: i18n("No templates yet. Use Save as Template on a container to create one.")
+        }
+
+        Kirigami.InlineMessage {
+            Layout.fillWidth: true
+            visible: templateDialog.errorMessage.length > 0
+            text: templateDialog.errorMessage
+            type: Kirigami.MessageType.Error
+        }
+    }
+}
@@ -18,6 +18,11 @@ Kirigami.ActionToolBar {
     signal openTerminalRequested(string containerName)
     signal upgradeContainerRequested(string containerName)
     signal cloneContainerRequested(string containerName)
+    signal saveTemplateRequested(string containerName)
+    signal backupRequested(string containerName)
+    signal diskUsageRequested(string containerName)
+    signal lifecyclePolicyRequested(string containerName)
+    signal resourceLimitsRequested(string containerName)
     signal removeContainerRequested(string containerName)
 
     Layout.fillWidth: true
@@ -56,6 +61,31 @@ Kirigami.ActionToolBar {
                 text: i18n("Clone Container")
                 onTriggered: toolbar.cloneContainerRequested(toolbar.containerName)
             }
+            Kirigami.Action {
+                icon.name: "document-save-as-template"
+                text: i18n("Save as Template…")
+                onTriggered: toolbar.saveTemplateRequested(toolbar.containerName)
+            }
+            Kirigami.Action {
+                icon.name: "document-export"
+                text: i18n("Back Up…")
+                onTriggered: toolbar.backupRequested(toolbar.containerName)
+            }
+            Kirigami.Action {
+                icon.name: "chronometer"
+                text: i18n("Start and Stop Policy")
+                onTriggered: toolbar.lifecyclePolicyRequested(toolbar.containerName)
+            }
+            Kirigami.Action {
+                icon.name: "speedometer"
+                text: i18n("Resource Limits…")
+                onTriggered: toolbar.resourceLimitsRequested(toolbar.containerName)
+            }
+            Kirigami.Action {
+                icon.name: "drive-harddisk"
+                text: i18n("Disk Usage")
+                onTriggered: toolbar.diskUsageRequested(toolbar.containerName)
+            }
             Kirigami.Action {
                 icon.name: "delete"
                 text: i18n("Remove Container")
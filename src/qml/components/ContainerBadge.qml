@@ -24,7 +24,7 @@ Item {
         id: fallbackColorStrip
         visible: badge.fallbackToDistroColors
         anchors.fill: parent
-        color: distroBoxManager.getDistroColor(badge.containerImage)
+        color: distroBoxManager.getDistroColor(badge.containerImage, badge.containerName)
         radius: 4
     }
 
@@ -37,7 +37,7 @@ Item {
         implicitHeight: height
         anchors.verticalCenter: parent.verticalCenter
         color: {
-            const baseColor = distroBoxManager.getDistroColor(badge.containerImage);
+            const baseColor = distroBoxManager.getDistroColor(badge.containerImage, badge.containerName);
             if (typeof baseColor === "string" && baseColor.startsWith("#")) {
                 const hex = baseColor.slice(1);
                 const alphaHex = Math.round(0.15 * 255).toString(16).padStart(2, "0");
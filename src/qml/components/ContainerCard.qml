@@ -18,8 +18,21 @@ Kirigami.AbstractCard {
     signal openTerminalRequested(string containerName)
     signal upgradeContainerRequested(string containerName)
     signal cloneContainerRequested(string containerName)
+    signal saveTemplateRequested(string containerName)
+    signal backupRequested(string containerName)
+    signal diskUsageRequested(string containerName)
+    signal lifecyclePolicyRequested(string containerName)
+    signal resourceLimitsRequested(string containerName)
     signal removeContainerRequested(string containerName)
 
+    HoverHandler {
+        onHoveredChanged: {
+            if (hovered && card.container.name) {
+                distroBoxManager.prewarmContainer(card.container.name);
+            }
+        }
+    }
+
     contentItem: RowLayout {
         spacing: Kirigami.Units.smallSpacing
 
@@ -53,6 +66,15 @@ Kirigami.AbstractCard {
                     font.pointSize: Kirigami.Theme.smallFont.pointSize
                     opacity: 0.7
                 }
+
+                Controls.Label {
+                    visible: (card.container.pendingUpdates || 0) > 0
+                    text: i18np("%1 update downloaded", "%1 updates downloaded", card.container.pendingUpdates || 0)
+                    elide: Text.ElideRight
+                    Layout.fillWidth: true
+                    font.pointSize: Kirigami.Theme.smallFont.pointSize
+                    color: Kirigami.Theme.positiveTextColor
+                }
             }
 
             ContainerActionsToolbar {
@@ -73,6 +95,21 @@ Kirigami.AbstractCard {
                 onCloneContainerRequested: function(containerName) {
                     card.cloneContainerRequested(containerName)
                 }
+                onSaveTemplateRequested: function(containerName) {
+                    card.saveTemplateRequested(containerName)
+                }
+                onBackupRequested: function(containerName) {
+                    card.backupRequested(containerName)
+                }
+                onDiskUsageRequested: function(containerName) {
+                    card.diskUsageRequested(containerName)
+                }
+                onLifecyclePolicyRequested: function(containerName) {
+                    card.lifecyclePolicyRequested(containerName)
+                }
+                onResourceLimitsRequested: function(containerName) {
+                    card.resourceLimitsRequested(containerName)
+                }
                 onRemoveContainerRequested: function(containerName) {
                     card.removeContainerRequested(containerName)
                 }
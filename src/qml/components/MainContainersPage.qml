@@ -4,6 +4,7 @@
 
 import QtQuick
 import QtQuick.Layouts
+import QtQuick.Controls as Controls
 import org.kde.kirigami as Kirigami
 
 Kirigami.ScrollablePage {
@@ -12,6 +13,9 @@ Kirigami.ScrollablePage {
     property var containersList: []
     property bool appRefreshing: false
     property bool fallbackToDistroColors: false
+    property var stalledOperations: []
+    // Snapshot clones in progress by clone name, with their percent and current stage
+    property var cloneProgress: ({})
 
     signal createRequested
     signal upgradeAllRequested
@@ -22,6 +26,11 @@ Kirigami.ScrollablePage {
     signal openTerminalRequested(string containerName)
     signal upgradeContainerRequested(string containerName)
     signal cloneContainerRequested(string containerName)
+    signal saveTemplateRequested(string containerName)
+    signal backupRequested(string containerName)
+    signal diskUsageRequested(string containerName)
+    signal lifecyclePolicyRequested(string containerName)
+    signal resourceLimitsRequested(string containerName)
     signal removeContainerRequested(string containerName)
 
     spacing: Kirigami.Units.smallSpacing
@@ -51,10 +60,87 @@ Kirigami.ScrollablePage {
         }
     ]
 
+    Connections {
+        target: distroBoxManager
+        function onStalledOperationsChanged(operations) {
+            try {
+                page.stalledOperations = JSON.parse(operations);
+            } catch (e) {
+                page.stalledOperations = [];
+            }
+        }
+        function onContainerCloneProgress(clonedName, percent, stage) {
+            var progress = Object.assign({}, page.cloneProgress);
+            progress[clonedName] = {
+                percent: percent,
+                stage: stage
+            };
+            page.cloneProgress = progress;
+        }
+        function onContainerCloneFinished(clonedName, success) {
+            var progress = Object.assign({}, page.cloneProgress);
+            delete progress[clonedName];
+            page.cloneProgress = progress;
+        }
+    }
+
     ColumnLayout {
         anchors.fill: parent
         spacing: Kirigami.Units.largeSpacing
 
+        Kirigami.InlineMessage {
+            id: stalledMessage
+            readonly property var operation: page.stalledOperations.length > 0 ? page.stalledOperations[0] : null
+
+            Layout.fillWidth: true
+            visible: operation !== null
+            type: Kirigami.MessageType.Warning
+            text: {
+                if (!operation) {
+                    return "";
+                }
+                var message = operation.quiet
+                    ? i18np("“%2” is still running after %1 minute.", "“%2” is still running after %1 minutes.", operation.runningMinutes, operation.command)
+                    : i18n("“%1” has not responded for %2 seconds.", operation.command, operation.silentSeconds);
+                if (page.stalledOperations.length > 1) {
+                    message += " " + i18np("%1 more command is waiting too.", "%1 more commands are waiting too.", page.stalledOperations.length - 1);
+                }
+                return message;
+            }
+            actions: [
+                Kirigami.Action {
+                    text: i18n("Cancel")
+                    icon.name: "process-stop"
+                    onTriggered: distroBoxManager.cancelOperation(stalledMessage.operation.id)
+                }
+            ]
+        }
+
+        Repeater {
+            model: Object.keys(page.cloneProgress)
+
+            delegate: ColumnLayout {
+                required property string modelData
+                readonly property var progress: page.cloneProgress[modelData]
+
+                Layout.fillWidth: true
+                spacing: Kirigami.Units.smallSpacing
+
+                Controls.Label {
+                    Layout.fillWidth: true
+                    text: progress ? i18n("Cloning %1: %2", modelData, progress.stage) : ""
+                    elide: Text.ElideRight
+                }
+
+                Controls.ProgressBar {
+                    Layout.fillWidth: true
+                    from: 0
+                    to: 100
+                    value: progress ? progress.percent : 0
+                }
+            }
+        }
+
         Kirigami.CardsListView {
             id: containersListView
             Layout.fillWidth: true
@@ -79,6 +165,21 @@ Kirigami.ScrollablePage {
                 onCloneContainerRequested: function (containerName) {
                     page.cloneContainerRequested(containerName);
                 }
+                onSaveTemplateRequested: function (containerName) {
+                    page.saveTemplateRequested(containerName);
+                }
+                onBackupRequested: function (containerName) {
+                    page.backupRequested(containerName);
+                }
+                onDiskUsageRequested: function (containerName) {
+                    page.diskUsageRequested(containerName);
+                }
+                onLifecyclePolicyRequested: function (containerName) {
+                    page.lifecyclePolicyRequested(containerName);
+                }
+                onResourceLimitsRequested: function (containerName) {
+                    page.resourceLimitsRequested(containerName);
+                }
                 onRemoveContainerRequested: function (containerName) {
                     page.removeContainerRequested(containerName);
                 }
@@ -14,6 +14,12 @@ Kirigami.GlobalDrawer {
     signal createRequested()
     signal shortcutRequested()
     signal cloneRequested(string containerName)
+    signal reclaimRequested()
+    signal registryMirrorRequested()
+    signal templatesRequested()
+    signal restoreRequested()
+    signal packageSearchRequested()
+    signal packageInstallRequested()
     signal showContainerIconsToggled(bool fallbackToDistroColors)
     signal aboutRequested()
 
@@ -47,6 +53,38 @@ Kirigami.GlobalDrawer {
             enabled: drawer.hasContainers
             onTriggered: drawer.cloneRequested("")
         },
+        Kirigami.Action {
+            text: i18n("Install Packages…")
+            icon.name: "install"
+            enabled: drawer.hasContainers
+            onTriggered: drawer.packageInstallRequested()
+        },
+        Kirigami.Action {
+            text: i18n("Find Installed Package…")
+            icon.name: "search"
+            enabled: drawer.hasContainers
+            onTriggered: drawer.packageSearchRequested()
+        },
+        Kirigami.Action {
+            text: i18n("Manage Templates…")
+            icon.name: "document-save-as-template"
+            onTriggered: drawer.templatesRequested()
+        },
+        Kirigami.Action {
+            text: i18n("Restore Container…")
+            icon.name: "document-import"
+            onTriggered: drawer.restoreRequested()
+        },
+        Kirigami.Action {
+            text: i18n("Reclaim Disk Space…")
+            icon.name: "edit-clear-all"
+            onTriggered: drawer.reclaimRequested()
+        },
+        Kirigami.Action {
+            text: i18n("Registry Mirror…")
+            icon.name: "network-server-database"
+            onTriggered: drawer.registryMirrorRequested()
+        },
         Kirigami.Action {
             separator: true
         },
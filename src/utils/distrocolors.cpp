@@ -11,11 +11,11 @@
 
 using namespace Qt::Literals::StringLiterals;
 
-namespace DistroColors
+namespace
 {
-QString colorForImage(const QString &image)
+QString knownColor(const QString &name)
 {
-    const QString imageLower = image.toLower();
+    const QString imageLower = name.toLower();
 
     struct DistroColor {
         QRegularExpression regex;
@@ -52,6 +52,11 @@ QString colorForImage(const QString &image)
         }
     }
 
+    return {};
+}
+
+QString randomColor()
+{
     auto *rng = QRandomGenerator::global();
     const int r = rng->bounded(100, 201);
     const int g = rng->bounded(100, 201);
@@ -59,3 +64,26 @@ QString colorForImage(const QString &image)
     return u"#%1%2%3"_s.arg(r, 2, 16, QLatin1Char('0')).arg(g, 2, 16, QLatin1Char('0')).arg(b, 2, 16, QLatin1Char('0'));
 }
 }
+
+namespace DistroColors
+{
+QString colorForImage(const QString &image)
+{
+    const QString color = knownColor(image);
+    return color.isEmpty() ? randomColor() : color;
+}
+
+QString colorForDistribution(const QStringList &osIds, const QString &image)
+{
+    for (const QString &osId : osIds) {
+        if (osId.isEmpty()) {
+            continue;
+        }
+        const QString color = knownColor(osId);
+        if (!color.isEmpty()) {
+            return color;
+        }
+    }
+    return colorForImage(image);
+}
+}
@@ -6,8 +6,11 @@
 #pragma once
 
 #include <QString>
+#include <QStringList>
 
 namespace DistroColors
 {
 QString colorForImage(const QString &image);
+// Tries the os-release IDs of the distribution first, then the image name
+QString colorForDistribution(const QStringList &osIds, const QString &image);
 }